@@ -286,7 +286,8 @@ end
 -- This function will create projects for all the paths in a table, and set the group name to the given value
 -- @param groupName The name to group the projects under in the workspace
 -- @param folders   The table of folders that contain the projects to add
-function AddProjects(groupName, folders)
+-- @param extraIncludes Optional table of extra include directories for every project in the group
+function AddProjects(groupName, folders, extraIncludes)
 
 	premake.info("Building Group: " .. groupName)
 	group(groupName)
@@ -362,6 +363,9 @@ function AddProjects(groupName, folders)
 			ProjIncludes[1] = srcdir
 			-- Defines what directories we want to include
 			includedirs(ProjIncludes)
+			if extraIncludes then
+				includedirs(extraIncludes)
+			end
 
 			-- Link to the dependencies and modules
 			links(ProjLinks)
@@ -398,8 +402,15 @@ end
 -- Add the User Projects and Sample Projects
 AddProjects("Projects", projects)
 
+-- Samples (ex: the benchmarks) build parts of the projects straight from their source, so they can include project
+-- headers the same way the projects do
+local projectSources = {}
+for k, proj in pairs(projects) do
+	table.insert(projectSources, path.join(path.getrelative(rootDir, proj), "src"))
+end
+
 for k, proj in pairs(sampleGroups) do
 	local name = path.getbasename(proj);
     local samples = os.matchdirs(proj .. "/*")
-    AddProjects("Samples - " .. name, samples)
+    AddProjects("Samples - " .. name, samples, projectSources)
 end
\ No newline at end of file
@@ -14,6 +14,8 @@
 #pragma once
 
 #include <GLM/glm.hpp>
+#include <vector>
+#include <cstdint>
 #include "FontRenderer.h"
 
 namespace TTK
@@ -51,10 +53,10 @@ namespace TTK
 	public:
 		~Context();
 
-		void SetProjection(const glm::mat4& value) { m_Projection = value; m_ViewProjection = m_Projection * m_ViewMatrix; }
+		void SetProjection(const glm::mat4& value) { m_Projection = value; m_ViewProjection = m_Projection * m_ViewMatrix; m_FrameDirty = true; }
 		const glm::mat4& GetProjection() const { return m_Projection; }
 
-		void SetView(const glm::mat4& value) { m_ViewMatrix = value; m_ViewProjection = m_Projection * m_ViewMatrix; }
+		void SetView(const glm::mat4& value) { m_ViewMatrix = value; m_ViewProjection = m_Projection * m_ViewMatrix; m_FrameDirty = true; }
 		const glm::mat4& GetView() const { return m_ViewMatrix; }
 
 		const glm::mat4& GetViewProjection() const { return m_ViewProjection; }
@@ -77,6 +79,13 @@ namespace TTK
 		
 		void Flush();
 
+		// The view, projection and view projection matrices are shared with our shaders through a std140 uniform block
+		// bound at FrameBinding, laid out the same as the start of the game's Frame block:
+		//     layout(std140, binding = 0) uniform Frame { mat4 View; mat4 Projection; mat4 ViewProjection; };
+		static const GLuint FrameBinding = 0;
+		// Uploads the frame block if the camera has changed, and binds it
+		void BindFrameBlock();
+
 	private:
 		Context();
 		glm::mat4				  m_Projection;
@@ -85,14 +94,16 @@ namespace TTK
 		TTK::TrueTypeTextureFont* m_DefaultFont;
 		Impl::MeshHelper*         m_MeshHelper;
 
+		GLuint m_FrameUbo;
+		bool   m_FrameDirty;
+
 		GLuint m_ShaderHandle;
 		GLuint m_PointShaderHandle;
+		// Each primitive type has its own VAO and shader, but they all stream from the same buffer
 		struct GLBuff {
-			GLuint VBO, VAO;
-			size_t Count;
+			GLuint VAO;
 			size_t ElemSize;
 			GLenum Mode;
-			void*  Data;
 			GLuint Shader;
 		};
 		GLBuff m_Tris, m_Lines, m_Points;
@@ -100,16 +111,25 @@ namespace TTK
 		int m_WindowWidth, m_WindowHeight;
 		int m_viewportX, m_viewportY;
 
-		GLBuff __InitBuff(GLenum mode, GLuint shader, void* dataSource, size_t elemSize, size_t maxElems);
-		void __Flush(GLBuff& buff);
+		GLBuff __InitBuff(GLenum mode, GLuint shader, size_t elemSize);
+		void __Draw(const GLBuff& buff, const void* data, size_t count, size_t& offset);
+		void __ReserveStream(size_t bytes);
+		void __ReleaseStream();
 		GLuint __CompileShader(const char* vsSource, const char* fsSource);
 
-		static const size_t MaxPointVerts = 512;
-		static const size_t MaxLineVerts = 512 * 2;
-		static const size_t MaxTriVerts = 512 * 3;
+		// Primitives are collected here until the next Flush, there's no limit on how many can be added
+		std::vector<PointVert>  m_PointVerts;
+		std::vector<SimpleVert> m_LineVerts;
+		std::vector<SimpleVert> m_TriVerts;
 
-		PointVert  m_PointVerts[MaxPointVerts];
-		SimpleVert m_LineVerts[MaxLineVerts];
-		SimpleVert m_TriVerts[MaxTriVerts];
+		// The vertex buffer we stream primitives through. It's persistently mapped and split into sections, each Flush
+		// writes into the next section, and fences make sure we never overwrite a section the GPU is still drawing from.
+		// It grows whenever a flush needs more room than a section has
+		static const int StreamSections = 3;
+		GLuint   m_StreamVBO;
+		uint8_t* m_StreamData;
+		size_t   m_StreamSectionSize;
+		int      m_StreamSection;
+		GLsync   m_StreamFences[StreamSections];
 	};
 }
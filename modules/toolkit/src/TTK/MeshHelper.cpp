@@ -29,8 +29,8 @@ TTK::Impl::MeshHelper::~MeshHelper() {
 
 void TTK::Impl::MeshHelper::RenderTeapot(const glm::mat4& transform, const glm::vec4& color) const {
 	glUseProgram(m_Shader);
-	glm::mat4 t = Context::Instance().GetViewProjection() * transform;
-	glProgramUniformMatrix4fv(m_Shader, 0, 1, FALSE, &t[0][0]);
+	Context::Instance().BindFrameBlock();
+	glProgramUniformMatrix4fv(m_Shader, 0, 1, FALSE, &transform[0][0]);
 	glProgramUniform4fv(m_Shader, 1, 1, &color[0]);
 	glBindVertexArray(m_Teapot.VAO);
 	glDrawArrays(GL_TRIANGLES, 0, sizeof(TeapotData) / (sizeof(float) * 6));
@@ -38,8 +38,8 @@ void TTK::Impl::MeshHelper::RenderTeapot(const glm::mat4& transform, const glm::
 
 void TTK::Impl::MeshHelper::RenderSphere(const glm::mat4& transform, const glm::vec4& color) const {
 	glUseProgram(m_Shader);
-	glm::mat4 t = Context::Instance().GetViewProjection() * transform;
-	glProgramUniformMatrix4fv(m_Shader, 0, 1, FALSE, &t[0][0]);
+	Context::Instance().BindFrameBlock();
+	glProgramUniformMatrix4fv(m_Shader, 0, 1, FALSE, &transform[0][0]);
 	glProgramUniform4fv(m_Shader, 1, 1, &color[0]);
 	glBindVertexArray(m_Sphere.VAO);
 	glDrawArrays(GL_TRIANGLES, 0, sizeof(SphereData) / (sizeof(float) * 6));
@@ -48,8 +48,8 @@ void TTK::Impl::MeshHelper::RenderSphere(const glm::mat4& transform, const glm::
 void TTK::Impl::MeshHelper::RenderCube(const glm::mat4& transform, const glm::vec4& color) const
 {
 	glUseProgram(m_Shader);
-	glm::mat4 t = Context::Instance().GetViewProjection() * transform;
-	glProgramUniformMatrix4fv(m_Shader, 0, 1, FALSE, &t[0][0]);
+	Context::Instance().BindFrameBlock();
+	glProgramUniformMatrix4fv(m_Shader, 0, 1, FALSE, &transform[0][0]);
 	glProgramUniform4fv(m_Shader, 1, 1, &color[0]);
 	glBindVertexArray(m_Cube.VAO);
 	glDrawArrays(GL_TRIANGLES, 0, sizeof(CubeData) / (sizeof(float) * 6));
@@ -77,9 +77,14 @@ TTK::Impl::MeshHelper::MeshHelper()
 	
 	const char* vsSource = R"LIT(#version 430
             layout (location = 0) in vec3 vertexPosition;
-            layout (location = 0) uniform mat4 xTransform;	
+            layout (location = 0) uniform mat4 xModel;
+            layout (std140, binding = 0) uniform Frame {
+                mat4 View;
+                mat4 Projection;
+                mat4 ViewProjection;
+            };
             void main() {
-                gl_Position = xTransform * vec4(vertexPosition, 1);
+                gl_Position = ViewProjection * xModel * vec4(vertexPosition, 1);
             })LIT";
 
 	const char* fsSource = R"LIT(#version 430   
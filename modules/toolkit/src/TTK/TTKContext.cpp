@@ -13,6 +13,7 @@
 #include "TTK/TTKContext.h"
 #include <GLM/gtc/matrix_transform.hpp>
 #include <string>
+#include <cstring>
 #include "Logging.h"
 #include "TTK/MeshHelper.h"
 
@@ -21,13 +22,12 @@ TTK::Context* TTK::Context::m_Instance = nullptr;
 TTK::Context::~Context() {
 	delete m_MeshHelper;
 	delete m_DefaultFont;
-	glDeleteBuffers(1, &m_Tris.VBO);
-	glDeleteBuffers(1, &m_Lines.VBO);
-	glDeleteBuffers(1, &m_Points.VBO);
+	__ReleaseStream();
 	glDeleteVertexArrays(1, &m_Tris.VAO);
 	glDeleteVertexArrays(1, &m_Lines.VAO);
 	glDeleteVertexArrays(1, &m_Points.VAO);
 	glDeleteProgram(m_ShaderHandle);
+	glDeleteBuffers(1, &m_FrameUbo);
 }
 
 glm::mat4 TTK::Context::GetOrthoProjection() const {
@@ -69,27 +69,14 @@ void TTK::Context::DrawCube(const glm::mat4& mat, const glm::vec4& color) const
 }
 
 void TTK::Context::AddLine(const glm::vec3& a, const glm::vec3& b, const glm::vec4& color) {
-	m_LineVerts[m_Lines.Count + 0].Position = a;
-	m_LineVerts[m_Lines.Count + 0].Color = color;
-	m_LineVerts[m_Lines.Count + 1].Position = b;
-	m_LineVerts[m_Lines.Count + 1].Color = color;
-	m_Lines.Count += 2;
-	if (m_Lines.Count == MaxLineVerts) {
-		__Flush(m_Lines);
-	}
+	m_LineVerts.push_back({ a, color });
+	m_LineVerts.push_back({ b, color });
 }
 
 void TTK::Context::AddTri(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec4& color) {
-	m_TriVerts[m_Tris.Count + 0].Position = a;
-	m_TriVerts[m_Tris.Count + 0].Color = color;
-	m_TriVerts[m_Tris.Count + 1].Position = b;
-	m_TriVerts[m_Tris.Count + 1].Color = color;
-	m_TriVerts[m_Tris.Count + 2].Position = c;
-	m_TriVerts[m_Tris.Count + 2].Color = color;
-	m_Tris.Count += 3;
-	if (m_Tris.Count == MaxTriVerts) {
-		__Flush(m_Tris);
-	}
+	m_TriVerts.push_back({ a, color });
+	m_TriVerts.push_back({ b, color });
+	m_TriVerts.push_back({ c, color });
 }
 
 void TTK::Context::AddQuad(const glm::vec3& min, const glm::vec3& max, const glm::vec4& color) {
@@ -101,35 +88,76 @@ void TTK::Context::AddQuad(const glm::vec3& min, const glm::vec3& max, const glm
 
 void TTK::Context::AddPoint(const glm::vec3& pos, float size, const glm::vec4& color)
 {
-	m_PointVerts[m_Points.Count].Position = pos;
-	m_PointVerts[m_Points.Count].Color = color;
-	m_PointVerts[m_Points.Count].Size = size;
-	m_Points.Count += 1;
-	if (m_Points.Count == MaxPointVerts) {
-		__Flush(m_Points);
+	m_PointVerts.push_back({ pos, color, size });
+}
+
+void TTK::Context::BindFrameBlock() {
+	if (m_FrameDirty) {
+		const glm::mat4 frame[3] = { m_ViewMatrix, m_Projection, m_ViewProjection };
+		glNamedBufferSubData(m_FrameUbo, 0, sizeof(frame), frame);
+		m_FrameDirty = false;
 	}
+	glBindBufferBase(GL_UNIFORM_BUFFER, FrameBinding, m_FrameUbo);
 }
 
 void TTK::Context::Flush() {
-	__Flush(m_Tris);
-	__Flush(m_Lines);
-	__Flush(m_Points);
+	const size_t triBytes = m_TriVerts.size() * sizeof(SimpleVert);
+	const size_t lineBytes = m_LineVerts.size() * sizeof(SimpleVert);
+	const size_t pointBytes = m_PointVerts.size() * sizeof(PointVert);
+	if (triBytes + lineBytes + pointBytes == 0) {
+		return;
+	}
+
+	// Move on to the next section, waiting for the GPU if it's still drawing from it
+	__ReserveStream(triBytes + lineBytes + pointBytes);
+	m_StreamSection = (m_StreamSection + 1) % StreamSections;
+	GLsync& fence = m_StreamFences[m_StreamSection];
+	if (fence != nullptr) {
+		GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+		while (result == GL_TIMEOUT_EXPIRED) {
+			result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		}
+		glDeleteSync(fence);
+	}
+
+	// Everything goes out in one draw per primitive type
+	BindFrameBlock();
+	size_t offset = m_StreamSection * m_StreamSectionSize;
+	__Draw(m_Tris, m_TriVerts.data(), m_TriVerts.size(), offset);
+	__Draw(m_Lines, m_LineVerts.data(), m_LineVerts.size(), offset);
+	__Draw(m_Points, m_PointVerts.data(), m_PointVerts.size(), offset);
+	glBindVertexArray(0);
+
+	fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	m_TriVerts.clear();
+	m_LineVerts.clear();
+	m_PointVerts.clear();
 }
 
 TTK::Context::Context() {
 	m_Projection = glm::ortho(0.0f, 800.0f, 0.0f, 600.0f);
 	m_ViewMatrix = glm::mat4(1.0f);
+	m_ViewProjection = m_Projection * m_ViewMatrix;
+
+	glCreateBuffers(1, &m_FrameUbo);
+	glNamedBufferStorage(m_FrameUbo, sizeof(glm::mat4) * 3, nullptr, GL_DYNAMIC_STORAGE_BIT);
+	m_FrameDirty = true;
 	m_DefaultFont = new TrueTypeTextureFont("C:\\\\Windows\\Fonts\\consola.ttf", 32);
 	
 	const char* vsSource = R"LIT(#version 430
-            layout (location = 0) uniform mat4 xTransform;
+            layout (std140, binding = 0) uniform Frame {
+                mat4 View;
+                mat4 Projection;
+                mat4 ViewProjection;
+            };
 	
             layout (location = 0) in vec3 vertexPosition;
             layout (location = 1) in vec4 vertexColor;
 	
             layout (location = 0) out vec4 fragmentColor;
             void main() {
-                gl_Position = xTransform * vec4(vertexPosition, 1);
+                gl_Position = ViewProjection * vec4(vertexPosition, 1);
                 fragmentColor = vertexColor;
             })LIT";
 
@@ -143,7 +171,11 @@ TTK::Context::Context() {
 	m_ShaderHandle = __CompileShader(vsSource, fsSource);
 
 	const char* vsSourcePoint = R"LIT(#version 430
-            layout (location = 0) uniform mat4 xTransform;
+            layout (std140, binding = 0) uniform Frame {
+                mat4 View;
+                mat4 Projection;
+                mat4 ViewProjection;
+            };
 	
             layout (location = 0) in vec3 vertexPosition;
             layout (location = 1) in vec4 vertexColor;
@@ -151,7 +183,7 @@ TTK::Context::Context() {
 	
             layout (location = 0) out vec4 fragmentColor;
             void main() {
-                gl_Position = xTransform * vec4(vertexPosition, 1);
+                gl_Position = ViewProjection * vec4(vertexPosition, 1);
 				gl_PointSize = vertexPointSize;
                 fragmentColor = vertexColor;
             })LIT";
@@ -159,27 +191,31 @@ TTK::Context::Context() {
 	m_PointShaderHandle = __CompileShader(vsSourcePoint, fsSource);
 
 
-	m_Tris = __InitBuff(GL_TRIANGLES, m_ShaderHandle, m_TriVerts, sizeof(SimpleVert), MaxTriVerts);
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(0, 3, GL_FLOAT, false, sizeof(SimpleVert), (void*)offsetof(SimpleVert, Position));
-	glVertexAttribPointer(1, 4, GL_FLOAT, false, sizeof(SimpleVert), (void*)offsetof(SimpleVert, Color));
-
-	m_Lines = __InitBuff(GL_LINES, m_ShaderHandle, m_LineVerts, sizeof(SimpleVert), MaxLineVerts);
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(0, 3, GL_FLOAT, false, sizeof(SimpleVert), (void*)offsetof(SimpleVert, Position));
-	glVertexAttribPointer(1, 4, GL_FLOAT, false, sizeof(SimpleVert), (void*)offsetof(SimpleVert, Color));
-
-	m_Points = __InitBuff(GL_POINTS, m_PointShaderHandle, m_PointVerts, sizeof(PointVert), MaxLineVerts);
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(0, 3, GL_FLOAT, false, sizeof(PointVert), (void*)offsetof(PointVert, Position));
-	glVertexAttribPointer(1, 4, GL_FLOAT, false, sizeof(PointVert), (void*)offsetof(PointVert, Color));
-	glVertexAttribPointer(2, 1, GL_FLOAT, false, sizeof(PointVert), (void*)offsetof(PointVert, Size));
-
-	glBindVertexArray(0);
+	// The vertex formats are set up once, which buffer and offset they read from is set when we draw
+	m_Tris = __InitBuff(GL_TRIANGLES, m_ShaderHandle, sizeof(SimpleVert));
+	glVertexArrayAttribFormat(m_Tris.VAO, 0, 3, GL_FLOAT, false, offsetof(SimpleVert, Position));
+	glVertexArrayAttribFormat(m_Tris.VAO, 1, 4, GL_FLOAT, false, offsetof(SimpleVert, Color));
+
+	m_Lines = __InitBuff(GL_LINES, m_ShaderHandle, sizeof(SimpleVert));
+	glVertexArrayAttribFormat(m_Lines.VAO, 0, 3, GL_FLOAT, false, offsetof(SimpleVert, Position));
+	glVertexArrayAttribFormat(m_Lines.VAO, 1, 4, GL_FLOAT, false, offsetof(SimpleVert, Color));
+
+	m_Points = __InitBuff(GL_POINTS, m_PointShaderHandle, sizeof(PointVert));
+	glVertexArrayAttribFormat(m_Points.VAO, 0, 3, GL_FLOAT, false, offsetof(PointVert, Position));
+	glVertexArrayAttribFormat(m_Points.VAO, 1, 4, GL_FLOAT, false, offsetof(PointVert, Color));
+	glVertexArrayAttribFormat(m_Points.VAO, 2, 1, GL_FLOAT, false, offsetof(PointVert, Size));
+	glEnableVertexArrayAttrib(m_Points.VAO, 2);
+	glVertexArrayAttribBinding(m_Points.VAO, 2, 0);
+
+	// Start with room for a decent amount of debug drawing, this will grow if we need more
+	m_StreamVBO = 0;
+	m_StreamData = nullptr;
+	m_StreamSectionSize = 0;
+	m_StreamSection = 0;
+	for (int ix = 0; ix < StreamSections; ix++) {
+		m_StreamFences[ix] = nullptr;
+	}
+	__ReserveStream(256 * 1024);
 
 	// Make sure that the mesh helper has a context
 	m_MeshHelper = new Impl::MeshHelper();
@@ -188,32 +224,69 @@ TTK::Context::Context() {
 	glEnable(GL_PROGRAM_POINT_SIZE);
 }
 
-TTK::Context::GLBuff TTK::Context::__InitBuff(GLenum mode, GLuint shader, void* dataSource, size_t elemSize, size_t maxElems)
+TTK::Context::GLBuff TTK::Context::__InitBuff(GLenum mode, GLuint shader, size_t elemSize)
 {
 	GLBuff result;
 	result.Mode = mode;
-	result.Count = 0;
-	result.Data = dataSource;
 	result.ElemSize = elemSize;
 	result.Shader = shader;
 
+	// Every vertex type has a position and color, the caller sets up their formats and any extra attributes
 	glCreateVertexArrays(1, &result.VAO);
-	glBindVertexArray(result.VAO);
-	glCreateBuffers(1, &result.VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, result.VBO);
-	glNamedBufferData(result.VBO, elemSize * maxElems, nullptr, GL_STREAM_DRAW);
+	glEnableVertexArrayAttrib(result.VAO, 0);
+	glEnableVertexArrayAttrib(result.VAO, 1);
+	glVertexArrayAttribBinding(result.VAO, 0, 0);
+	glVertexArrayAttribBinding(result.VAO, 1, 0);
 
 	return result;
 }
 
-void TTK::Context::__Flush(GLBuff& buff) {
-	if (buff.Count > 0) {
+void TTK::Context::__Draw(const GLBuff& buff, const void* data, size_t count, size_t& offset) {
+	if (count > 0) {
+		size_t bytes = count * buff.ElemSize;
+		memcpy(m_StreamData + offset, data, bytes);
+		glVertexArrayVertexBuffer(buff.VAO, 0, m_StreamVBO, static_cast<GLintptr>(offset), static_cast<GLsizei>(buff.ElemSize));
+
 		glUseProgram(buff.Shader);
-		glUniformMatrix4fv(0, 1, false, &m_ViewProjection[0][0]);
-		glNamedBufferSubData(buff.VBO, 0, buff.Count * buff.ElemSize, buff.Data);
 		glBindVertexArray(buff.VAO);
-		glDrawArrays(buff.Mode, 0, static_cast<GLsizei>(buff.Count));
-		buff.Count = 0;
+		glDrawArrays(buff.Mode, 0, static_cast<GLsizei>(count));
+		offset += bytes;
+	}
+}
+
+void TTK::Context::__ReserveStream(size_t bytes) {
+	if (bytes <= m_StreamSectionSize) {
+		return;
+	}
+
+	size_t sectionSize = m_StreamSectionSize > 0 ? m_StreamSectionSize : bytes;
+	while (sectionSize < bytes) {
+		sectionSize *= 2;
+	}
+
+	// The old buffer can go right away, OpenGL keeps it alive until the draws that use it are done
+	__ReleaseStream();
+
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	m_StreamSectionSize = sectionSize;
+	glCreateBuffers(1, &m_StreamVBO);
+	glNamedBufferStorage(m_StreamVBO, m_StreamSectionSize * StreamSections, nullptr, flags);
+	m_StreamData = static_cast<uint8_t*>(glMapNamedBufferRange(m_StreamVBO, 0, m_StreamSectionSize * StreamSections, flags));
+}
+
+void TTK::Context::__ReleaseStream() {
+	for (int ix = 0; ix < StreamSections; ix++) {
+		if (m_StreamFences[ix] != nullptr) {
+			glDeleteSync(m_StreamFences[ix]);
+			m_StreamFences[ix] = nullptr;
+		}
+	}
+
+	if (m_StreamVBO != 0) {
+		glUnmapNamedBuffer(m_StreamVBO);
+		glDeleteBuffers(1, &m_StreamVBO);
+		m_StreamVBO = 0;
+		m_StreamData = nullptr;
 	}
 }
 
@@ -8,14 +8,26 @@ layout(location = 3) in vec2 inUV;
 
 layout(binding = 0) uniform sampler2D textureSampler;
 
-uniform vec3 lightPos;
-uniform vec3 cameraPos;
+//per-frame data, shared by every shader (see UniformBlocks.h)
+layout(std140, binding = 0) uniform Frame {
+	mat4  View;
+	mat4  Projection;
+	mat4  ViewProjection;
+	vec4  CameraPos;
+	vec4  Time;
+	vec4  LightPos[4];
+	vec4  LightColor[4];
+	ivec4 LightCount;
+};
 
 out vec4 frag_color;
 
 
 void main() { 
 
+	vec3 lightPos = LightPos[0].xyz;
+	vec3 cameraPos = CameraPos.xyz;
+
 	//Ambient
 	vec3 lightColor = vec3(1.0, 1.0, 1.0);
 	float ambientStrength = 0.0;
@@ -8,14 +8,24 @@ layout(location = 1) out vec3 outColor;
 layout(location = 2) out vec3 outNormal;
 layout(location = 3) out vec2 outUV;
 
-uniform mat4 MVP; 
+//per-frame data, shared by every shader (see UniformBlocks.h)
+layout(std140, binding = 0) uniform Frame {
+	mat4  View;
+	mat4  Projection;
+	mat4  ViewProjection;
+	vec4  CameraPos;
+	vec4  Time;
+	vec4  LightPos[4];
+	vec4  LightColor[4];
+	ivec4 LightCount;
+};
 
 uniform mat4 Model;
 
 
 void main() {
 	// vertex position in clip space
-	gl_Position = MVP * vec4(inPosition, 1.0);
+	gl_Position = ViewProjection * Model * vec4(inPosition, 1.0);
 
 	//vertex pos and normal in world space ---> frag shader
 	outPos = (Model * vec4(inPosition, 1.0)).xyz;
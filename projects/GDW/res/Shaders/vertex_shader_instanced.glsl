@@ -0,0 +1,39 @@
+#version 420
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec3 inNormal;
+layout(location = 3) in vec2 inUV;
+//per-instance model matrix, takes up locations 4 to 7
+layout(location = 4) in mat4 inModel;
+layout(location = 0) out vec3 outPos;
+layout(location = 1) out vec3 outColor;
+layout(location = 2) out vec3 outNormal;
+layout(location = 3) out vec2 outUV;
+
+//per-frame data, shared by every shader (see UniformBlocks.h)
+layout(std140, binding = 0) uniform Frame {
+	mat4  View;
+	mat4  Projection;
+	mat4  ViewProjection;
+	vec4  CameraPos;
+	vec4  Time;
+	vec4  LightPos[4];
+	vec4  LightColor[4];
+	ivec4 LightCount;
+};
+
+
+void main() {
+	// vertex position in world space
+	vec4 worldPos = inModel * vec4(inPosition, 1.0);
+
+	// vertex position in clip space
+	gl_Position = ViewProjection * worldPos;
+
+	//vertex pos and normal in world space ---> frag shader
+	outPos = worldPos.xyz;
+	outNormal = (inModel * vec4(inNormal, 1.0)).xyz;
+
+	outColor = inColor;
+	outUV = inUV;
+}
@@ -0,0 +1,19 @@
+#include "Bounds.h"
+
+Bounds Bounds::Transformed(const glm::mat4& transform) const
+{
+	if (!IsValid()) {
+		return *this;
+	}
+
+	// The new box is centered on the transformed center, and each of its extents is how far the old extents can reach
+	// along that axis once rotated (Arvo's method)
+	glm::mat3 basis = glm::mat3(transform);
+	glm::mat3 absBasis = glm::mat3(glm::abs(basis[0]), glm::abs(basis[1]), glm::abs(basis[2]));
+	glm::vec3 center = glm::vec3(transform * glm::vec4(Center, 1.0f));
+	glm::vec3 extents = absBasis * GetExtents();
+
+	float scale = glm::sqrt(glm::max(glm::dot(basis[0], basis[0]), glm::max(glm::dot(basis[1], basis[1]), glm::dot(basis[2], basis[2]))));
+
+	return Bounds(center - extents, center + extents, Radius * scale);
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include <GLM/glm.hpp>
+
+/// <summary>
+/// The bounding volumes of a mesh or object, an axis aligned box and a sphere around the same center. The sphere is
+/// quicker to test but looser, so culling checks it first and only falls back to the box when it is unsure
+/// </summary>
+struct Bounds
+{
+	glm::vec3 Min;
+	glm::vec3 Max;
+	glm::vec3 Center;
+	// A negative radius means the bounds are unknown, and the object should never be culled
+	float     Radius;
+
+	Bounds() : Min(glm::vec3(0.0f)), Max(glm::vec3(0.0f)), Center(glm::vec3(0.0f)), Radius(-1.0f) { }
+	Bounds(const glm::vec3& min, const glm::vec3& max, float radius) :
+		Min(min), Max(max), Center((min + max) * 0.5f), Radius(radius) { }
+
+	/// <summary>
+	/// Returns true if these bounds have been calculated
+	/// </summary>
+	bool IsValid() const { return Radius >= 0.0f; }
+	/// <summary>
+	/// Gets half the size of the box along each axis
+	/// </summary>
+	glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+
+	/// <summary>
+	/// Moves these bounds into the space given by a matrix (ex: object space to world space). The box is grown to fit
+	/// the rotated box, and the sphere is grown by the largest scale in the matrix
+	/// </summary>
+	Bounds Transformed(const glm::mat4& transform) const;
+
+	/// <summary>
+	/// Calculates the bounds of a list of vertices, the sphere is centered on the box and just large enough to hold
+	/// every vertex
+	/// </summary>
+	/// <typeparam name="VertType">The type of vertex, must have a Position field</typeparam>
+	template <typename VertType>
+	static Bounds FromVertices(const VertType* vertices, size_t count) {
+		if (count == 0) {
+			return Bounds();
+		}
+
+		glm::vec3 min = vertices[0].Position;
+		glm::vec3 max = vertices[0].Position;
+		for (size_t ix = 1; ix < count; ix++) {
+			min = glm::min(min, vertices[ix].Position);
+			max = glm::max(max, vertices[ix].Position);
+		}
+
+		glm::vec3 center = (min + max) * 0.5f;
+		float radius2 = 0.0f;
+		for (size_t ix = 0; ix < count; ix++) {
+			glm::vec3 offset = vertices[ix].Position - center;
+			radius2 = glm::max(radius2, glm::dot(offset, offset));
+		}
+		return Bounds(min, max, glm::sqrt(radius2));
+	}
+	template <typename VertType>
+	static Bounds FromVertices(const std::vector<VertType>& vertices) {
+		return FromVertices(vertices.data(), vertices.size());
+	}
+};
@@ -0,0 +1,141 @@
+#include "CollisionTracker.h"
+
+#include <algorithm>
+
+// The smallest size of the hash tables, must be a power of two
+static const size_t MIN_TABLE_SIZE = 64;
+
+// Mixes the bits of a pair key so that nearby entities don't end up in nearby slots
+static inline size_t HashKey(uint64_t key)
+{
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	key *= 0xc4ceb9fe1a85ec53ULL;
+	key ^= key >> 33;
+	return static_cast<size_t>(key);
+}
+
+// Gets the entity that a body belongs to, which is stored in its user pointer
+static inline entt::entity GetEntity(const btCollisionObject* body)
+{
+	return static_cast<entt::entity>(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(body->getUserPointer())));
+}
+
+CollisionTracker::CollisionTracker() :
+	_contacts(std::vector<SMI_Collision>()),
+	_previous(std::vector<SMI_Collision>()),
+	_ended(std::vector<SMI_Collision>()),
+	_table(std::vector<int32_t>(MIN_TABLE_SIZE, -1)),
+	_previousTable(std::vector<int32_t>(MIN_TABLE_SIZE, -1))
+{ }
+
+void CollisionTracker::Update(btDispatcher* dispatcher)
+{
+	BeginStep();
+
+	int manifolds = dispatcher->getNumManifolds();
+	for (int ix = 0; ix < manifolds; ix++) {
+		const btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(ix);
+
+		// Bullet keeps manifolds around for pairs whose boxes overlap, we only care about the ones that are actually
+		// touching, and one point is enough to tell
+		int contacts = manifold->getNumContacts();
+		for (int jx = 0; jx < contacts; jx++) {
+			if (manifold->getContactPoint(jx).getDistance() < 0.0f) {
+				const btCollisionObject* body0 = manifold->getBody0();
+				const btCollisionObject* body1 = manifold->getBody1();
+				AddPair(GetEntity(body0), GetEntity(body1), body0->getUserIndex(), body1->getUserIndex());
+				break;
+			}
+		}
+	}
+
+	EndStep();
+}
+
+void CollisionTracker::BeginStep()
+{
+	std::swap(_contacts, _previous);
+	std::swap(_table, _previousTable);
+	_contacts.clear();
+
+	// The table is kept at least twice as big as the number of pairs it holds, so start from what we needed last time
+	size_t size = _table.size();
+	while (size > MIN_TABLE_SIZE && size / 4 > _previous.size()) {
+		size /= 2;
+	}
+	while (size < _previous.size() * 2) {
+		size *= 2;
+	}
+	_table.assign(size, -1);
+}
+
+void CollisionTracker::AddPair(entt::entity b1, entt::entity b2, int layer1, int layer2)
+{
+	uint64_t key = SMI_Collision::PairKey(b1, b2);
+	if (_Find(_table, _contacts, key) != -1) {
+		return;
+	}
+
+	SMI_ContactEvent event = _Find(_previousTable, _previous, key) != -1 ? SMI_ContactEvent::STAY : SMI_ContactEvent::BEGIN;
+	_contacts.push_back(SMI_Collision(b1, b2, event, layer1, layer2));
+	if (_contacts.size() * 2 > _table.size()) {
+		_Grow();
+	} else {
+		_Insert(_table, _contacts, static_cast<int32_t>(_contacts.size() - 1));
+	}
+}
+
+void CollisionTracker::EndStep()
+{
+	_ended.clear();
+	for (const SMI_Collision& pair : _previous) {
+		if (_Find(_table, _contacts, pair.getKey()) == -1) {
+			_ended.push_back(SMI_Collision(pair.getB1(), pair.getB2(), SMI_ContactEvent::END, pair.getLayer1(), pair.getLayer2()));
+		}
+	}
+}
+
+bool CollisionTracker::IsTouching(entt::entity b1, entt::entity b2) const
+{
+	return _Find(_table, _contacts, SMI_Collision::PairKey(b1, b2)) != -1;
+}
+
+void CollisionTracker::Clear()
+{
+	_contacts.clear();
+	_previous.clear();
+	_ended.clear();
+	std::fill(_table.begin(), _table.end(), -1);
+	std::fill(_previousTable.begin(), _previousTable.end(), -1);
+}
+
+int32_t CollisionTracker::_Find(const std::vector<int32_t>& table, const std::vector<SMI_Collision>& pairs, uint64_t key)
+{
+	size_t mask = table.size() - 1;
+	for (size_t slot = HashKey(key) & mask; table[slot] != -1; slot = (slot + 1) & mask) {
+		if (pairs[table[slot]].getKey() == key) {
+			return table[slot];
+		}
+	}
+	return -1;
+}
+
+void CollisionTracker::_Insert(std::vector<int32_t>& table, const std::vector<SMI_Collision>& pairs, int32_t index)
+{
+	size_t mask = table.size() - 1;
+	size_t slot = HashKey(pairs[index].getKey()) & mask;
+	while (table[slot] != -1) {
+		slot = (slot + 1) & mask;
+	}
+	table[slot] = index;
+}
+
+void CollisionTracker::_Grow()
+{
+	_table.assign(_table.size() * 2, -1);
+	for (size_t ix = 0; ix < _contacts.size(); ix++) {
+		_Insert(_table, _contacts, static_cast<int32_t>(ix));
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "Physics.h"
+
+/// <summary>
+/// Works out which pairs of bodies are touching after each physics step, and turns that into begin, stay and end
+/// events. Each manifold is looked at once, pairs are found again through a hash of the two entities, and all the
+/// buffers are kept between steps, so once it has grown to fit the scene a step does not allocate at all
+/// </summary>
+class CollisionTracker
+{
+public:
+	CollisionTracker();
+	~CollisionTracker() = default;
+
+	/// <summary>
+	/// Collects the touching pairs from every manifold in the dispatcher, should be called once after each physics step.
+	/// The bodies' user pointers are expected to hold their entity, and their user indices their collision layer
+	/// </summary>
+	void Update(btDispatcher* dispatcher);
+
+	/// <summary>
+	/// Starts a new step, the contacts from the last step become the ones we compare against
+	/// </summary>
+	void BeginStep();
+	/// <summary>
+	/// Records that two entities are touching in this step, adding the same pair again does nothing
+	/// </summary>
+	void AddPair(entt::entity b1, entt::entity b2, int layer1 = 0, int layer2 = 0);
+	/// <summary>
+	/// Finishes the step, finding any pairs that were touching in the last step but aren't anymore
+	/// </summary>
+	void EndStep();
+
+	/// <summary>
+	/// Gets every pair that is touching, with BEGIN if this is the first step they've touched and STAY otherwise
+	/// </summary>
+	const std::vector<SMI_Collision>& GetContacts() const { return _contacts; }
+	/// <summary>
+	/// Gets every pair that stopped touching in the last step, these are all END events. The entities may no longer
+	/// exist if they were deleted
+	/// </summary>
+	const std::vector<SMI_Collision>& GetEnded() const { return _ended; }
+	/// <summary>
+	/// Checks whether two entities are touching, in either order
+	/// </summary>
+	bool IsTouching(entt::entity b1, entt::entity b2) const;
+
+	/// <summary>
+	/// Removes all contacts without sending END events for them
+	/// </summary>
+	void Clear();
+
+protected:
+	// Touching pairs for this step and the one before it, and the pairs that ended in this step
+	std::vector<SMI_Collision> _contacts;
+	std::vector<SMI_Collision> _previous;
+	std::vector<SMI_Collision> _ended;
+	// Open addressed hash tables mapping pair keys to indices in _contacts and _previous, -1 marks an empty slot. The
+	// sizes are always powers of two
+	std::vector<int32_t> _table;
+	std::vector<int32_t> _previousTable;
+
+	// Finds the index of a pair in pairs, or -1 if it isn't there
+	static int32_t _Find(const std::vector<int32_t>& table, const std::vector<SMI_Collision>& pairs, uint64_t key);
+	// Adds an index to a table, the key must not already be in it
+	static void _Insert(std::vector<int32_t>& table, const std::vector<SMI_Collision>& pairs, int32_t index);
+	// Doubles the size of _table and puts everything back in
+	void _Grow();
+};
@@ -0,0 +1,315 @@
+#include "DynamicBVH.h"
+
+#include <algorithm>
+#include <cfloat>
+
+// Gets the surface area of a box, the chance of a random ray hitting it is proportional to this
+static inline float SurfaceArea(const glm::vec3& min, const glm::vec3& max)
+{
+	glm::vec3 size = max - min;
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+DynamicBVH::DynamicBVH(float margin, float rebuildThreshold) :
+	_nodes(std::vector<Node>()),
+	_root(NULL_NODE),
+	_freeList(NULL_NODE),
+	_proxyCount(0),
+	_margin(margin),
+	_rebuildThreshold(rebuildThreshold),
+	_builtCost(0.0f),
+	_changed(false),
+	_rebuildCount(0),
+	_stack(std::vector<int32_t>()),
+	_leaves(std::vector<int32_t>())
+{ }
+
+int32_t DynamicBVH::Insert(const glm::vec3& min, const glm::vec3& max, uint32_t userData)
+{
+	int32_t leaf = _AllocateNode();
+	Node& node = _nodes[leaf];
+	node.Min = min - glm::vec3(_margin);
+	node.Max = max + glm::vec3(_margin);
+	node.UserData = userData;
+	node.Height = 0;
+
+	_InsertLeaf(leaf);
+	_proxyCount++;
+	_changed = true;
+	return leaf;
+}
+
+void DynamicBVH::Remove(int32_t proxy)
+{
+	_RemoveLeaf(proxy);
+	_FreeNode(proxy);
+	_proxyCount--;
+	_changed = true;
+}
+
+bool DynamicBVH::Move(int32_t proxy, const glm::vec3& min, const glm::vec3& max)
+{
+	Node& node = _nodes[proxy];
+	if (glm::all(glm::lessThanEqual(node.Min, min)) && glm::all(glm::lessThanEqual(max, node.Max))) {
+		return false;
+	}
+
+	// Refit rather than reinserting, Optimize will rebuild the tree if this makes it too loose
+	node.Min = min - glm::vec3(_margin);
+	node.Max = max + glm::vec3(_margin);
+	_Refit(node.Parent);
+	_changed = true;
+	return true;
+}
+
+bool DynamicBVH::Optimize()
+{
+	if (!_changed) {
+		return false;
+	}
+	_changed = false;
+
+	if (_proxyCount > 2 && GetCost() > _builtCost * _rebuildThreshold) {
+		Rebuild();
+		return true;
+	}
+	return false;
+}
+
+void DynamicBVH::Rebuild()
+{
+	// Keep the leaves where they are so proxy IDs stay valid, and throw away all the branches
+	_leaves.clear();
+	for (int32_t ix = 0; ix < static_cast<int32_t>(_nodes.size()); ix++) {
+		Node& node = _nodes[ix];
+		if (node.Height < 0) {
+			continue;
+		}
+		if (node.IsLeaf()) {
+			_leaves.push_back(ix);
+		} else {
+			_FreeNode(ix);
+		}
+	}
+
+	_root = _leaves.empty() ? NULL_NODE : _Build(0, _leaves.size());
+	if (_root != NULL_NODE) {
+		_nodes[_root].Parent = NULL_NODE;
+	}
+
+	_builtCost = GetCost();
+	_rebuildCount++;
+	_changed = false;
+}
+
+void DynamicBVH::Clear()
+{
+	_nodes.clear();
+	_root = NULL_NODE;
+	_freeList = NULL_NODE;
+	_proxyCount = 0;
+	_builtCost = 0.0f;
+	_changed = false;
+}
+
+float DynamicBVH::GetCost() const
+{
+	if (_root == NULL_NODE) {
+		return 0.0f;
+	}
+
+	float area = 0.0f;
+	for (const Node& node : _nodes) {
+		if (node.Height > 0) {
+			area += SurfaceArea(node.Min, node.Max);
+		}
+	}
+
+	float rootArea = SurfaceArea(_nodes[_root].Min, _nodes[_root].Max);
+	return rootArea > 0.0f ? area / rootArea : 0.0f;
+}
+
+bool DynamicBVH::RayAABB(const glm::vec3& origin, const glm::vec3& invDir, const glm::vec3& min, const glm::vec3& max, float maxDistance, float& distance)
+{
+	glm::vec3 t0 = (min - origin) * invDir;
+	glm::vec3 t1 = (max - origin) * invDir;
+	glm::vec3 tNear = glm::min(t0, t1);
+	glm::vec3 tFar = glm::max(t0, t1);
+
+	float entry = glm::max(glm::max(tNear.x, tNear.y), glm::max(tNear.z, 0.0f));
+	float exit = glm::min(glm::min(tFar.x, tFar.y), glm::min(tFar.z, maxDistance));
+	distance = entry;
+	return entry <= exit;
+}
+
+int32_t DynamicBVH::_AllocateNode()
+{
+	int32_t index;
+	if (_freeList != NULL_NODE) {
+		index = _freeList;
+		_freeList = _nodes[index].Parent;
+	} else {
+		index = static_cast<int32_t>(_nodes.size());
+		_nodes.emplace_back();
+	}
+
+	Node& node = _nodes[index];
+	node.Parent = NULL_NODE;
+	node.Left = NULL_NODE;
+	node.Right = NULL_NODE;
+	node.Height = 0;
+	node.UserData = 0;
+	return index;
+}
+
+void DynamicBVH::_FreeNode(int32_t index)
+{
+	// A negative height marks the node as free
+	_nodes[index].Parent = _freeList;
+	_nodes[index].Height = -1;
+	_freeList = index;
+}
+
+void DynamicBVH::_InsertLeaf(int32_t leaf)
+{
+	if (_root == NULL_NODE) {
+		_root = leaf;
+		_nodes[leaf].Parent = NULL_NODE;
+		return;
+	}
+
+	// Walk down the tree looking for the best sibling, by the surface area the new branch would add (Box2D's heuristic)
+	glm::vec3 leafMin = _nodes[leaf].Min;
+	glm::vec3 leafMax = _nodes[leaf].Max;
+	int32_t index = _root;
+	while (!_nodes[index].IsLeaf()) {
+		const Node& node = _nodes[index];
+		float area = SurfaceArea(node.Min, node.Max);
+		float combinedArea = SurfaceArea(glm::min(node.Min, leafMin), glm::max(node.Max, leafMax));
+
+		// The cost of making a new parent for this node and the leaf
+		float cost = 2.0f * combinedArea;
+		// The cost of pushing the leaf further down, which grows this node's box
+		float inheritance = 2.0f * (combinedArea - area);
+
+		auto descendCost = [&](int32_t child) {
+			const Node& childNode = _nodes[child];
+			float childCombined = SurfaceArea(glm::min(childNode.Min, leafMin), glm::max(childNode.Max, leafMax));
+			return (childNode.IsLeaf() ? childCombined : childCombined - SurfaceArea(childNode.Min, childNode.Max)) + inheritance;
+		};
+		float leftCost = descendCost(node.Left);
+		float rightCost = descendCost(node.Right);
+
+		if (cost < leftCost && cost < rightCost) {
+			break;
+		}
+		index = leftCost < rightCost ? node.Left : node.Right;
+	}
+
+	// Make a new parent for the sibling and the leaf
+	int32_t sibling = index;
+	int32_t oldParent = _nodes[sibling].Parent;
+	int32_t newParent = _AllocateNode();
+	_nodes[newParent].Parent = oldParent;
+	_nodes[newParent].Left = sibling;
+	_nodes[newParent].Right = leaf;
+	_nodes[sibling].Parent = newParent;
+	_nodes[leaf].Parent = newParent;
+
+	if (oldParent == NULL_NODE) {
+		_root = newParent;
+	} else if (_nodes[oldParent].Left == sibling) {
+		_nodes[oldParent].Left = newParent;
+	} else {
+		_nodes[oldParent].Right = newParent;
+	}
+
+	_Refit(newParent);
+}
+
+void DynamicBVH::_RemoveLeaf(int32_t leaf)
+{
+	if (leaf == _root) {
+		_root = NULL_NODE;
+		return;
+	}
+
+	// The leaf's sibling takes the place of their parent
+	int32_t parent = _nodes[leaf].Parent;
+	int32_t grandParent = _nodes[parent].Parent;
+	int32_t sibling = _nodes[parent].Left == leaf ? _nodes[parent].Right : _nodes[parent].Left;
+
+	if (grandParent == NULL_NODE) {
+		_root = sibling;
+		_nodes[sibling].Parent = NULL_NODE;
+	} else {
+		if (_nodes[grandParent].Left == parent) {
+			_nodes[grandParent].Left = sibling;
+		} else {
+			_nodes[grandParent].Right = sibling;
+		}
+		_nodes[sibling].Parent = grandParent;
+		_Refit(grandParent);
+	}
+
+	_FreeNode(parent);
+}
+
+void DynamicBVH::_Refit(int32_t index)
+{
+	while (index != NULL_NODE) {
+		Node& node = _nodes[index];
+		const Node& left = _nodes[node.Left];
+		const Node& right = _nodes[node.Right];
+		glm::vec3 min = glm::min(left.Min, right.Min);
+		glm::vec3 max = glm::max(left.Max, right.Max);
+		int32_t height = 1 + glm::max(left.Height, right.Height);
+
+		// If nothing changed here, nothing above us will change either
+		if (min == node.Min && max == node.Max && height == node.Height) {
+			break;
+		}
+		node.Min = min;
+		node.Max = max;
+		node.Height = height;
+		index = node.Parent;
+	}
+}
+
+int32_t DynamicBVH::_Build(size_t first, size_t last)
+{
+	if (last - first == 1) {
+		return _leaves[first];
+	}
+
+	// Split the leaves in half along the axis where their centers are most spread out
+	glm::vec3 centerMin = glm::vec3(FLT_MAX);
+	glm::vec3 centerMax = glm::vec3(-FLT_MAX);
+	for (size_t ix = first; ix < last; ix++) {
+		const Node& leaf = _nodes[_leaves[ix]];
+		glm::vec3 center = leaf.Min + leaf.Max;
+		centerMin = glm::min(centerMin, center);
+		centerMax = glm::max(centerMax, center);
+	}
+	glm::vec3 spread = centerMax - centerMin;
+	int axis = spread.x > spread.y ? (spread.x > spread.z ? 0 : 2) : (spread.y > spread.z ? 1 : 2);
+
+	size_t middle = first + (last - first) / 2;
+	std::nth_element(_leaves.begin() + first, _leaves.begin() + middle, _leaves.begin() + last, [&](int32_t a, int32_t b) {
+		return _nodes[a].Min[axis] + _nodes[a].Max[axis] < _nodes[b].Min[axis] + _nodes[b].Max[axis];
+	});
+
+	int32_t left = _Build(first, middle);
+	int32_t right = _Build(middle, last);
+
+	int32_t index = _AllocateNode();
+	Node& node = _nodes[index];
+	node.Left = left;
+	node.Right = right;
+	node.Min = glm::min(_nodes[left].Min, _nodes[right].Min);
+	node.Max = glm::max(_nodes[left].Max, _nodes[right].Max);
+	node.Height = 1 + glm::max(_nodes[left].Height, _nodes[right].Height);
+	_nodes[left].Parent = index;
+	_nodes[right].Parent = index;
+	return index;
+}
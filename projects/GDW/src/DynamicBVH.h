@@ -0,0 +1,230 @@
+#pragma once
+#include <GLM/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include "Frustum.h"
+
+/// <summary>
+/// A bounding volume hierarchy over boxes that can be added, moved and removed at any time, used to find what is near a
+/// point, inside a region or along a ray without checking every object.
+///
+/// Every object gets a leaf with a slightly fattened copy of its box, so small movements don't touch the tree at all.
+/// When an object leaves its fat box, the leaf is grown and its ancestors are refit in place, which is cheap but makes
+/// the tree slowly worse. Optimize compares the tree against how good it was when last built, and rebuilds it from
+/// scratch once it has degraded too far.
+///
+/// Query callbacks must not query the same tree, the traversal stack is shared
+/// </summary>
+class DynamicBVH
+{
+public:
+	static const int32_t NULL_NODE = -1;
+
+	/// <summary>
+	/// Creates a new empty tree
+	/// </summary>
+	/// <param name="margin">How much to grow each object's box by, in world units, bigger values mean fewer updates when objects move but more false positives in queries</param>
+	/// <param name="rebuildThreshold">How much worse the tree can get (compared to when it was last built) before Optimize rebuilds it</param>
+	DynamicBVH(float margin = 0.5f, float rebuildThreshold = 1.5f);
+	~DynamicBVH() = default;
+
+	/// <summary>
+	/// Adds an object to the tree
+	/// </summary>
+	/// <param name="min">The minimum corner of the object's box</param>
+	/// <param name="max">The maximum corner of the object's box</param>
+	/// <param name="userData">A value that is handed back by queries, ex: an entity</param>
+	/// <returns>The ID of the object's proxy, used to move or remove it later</returns>
+	int32_t Insert(const glm::vec3& min, const glm::vec3& max, uint32_t userData);
+	/// <summary>
+	/// Removes an object from the tree
+	/// </summary>
+	void Remove(int32_t proxy);
+	/// <summary>
+	/// Updates the box of an object. Nothing happens if the new box is still inside the proxy's fat box, otherwise the
+	/// proxy is grown and its ancestors are refit
+	/// </summary>
+	/// <returns>True if the tree was changed</returns>
+	bool Move(int32_t proxy, const glm::vec3& min, const glm::vec3& max);
+	/// <summary>
+	/// Rebuilds the tree if it has degraded past the rebuild threshold, should be called once all the moves for a frame
+	/// have been done
+	/// </summary>
+	/// <returns>True if the tree was rebuilt</returns>
+	bool Optimize();
+	/// <summary>
+	/// Rebuilds all the branches of the tree from scratch, proxy IDs stay the same
+	/// </summary>
+	void Rebuild();
+	/// <summary>
+	/// Removes every object from the tree
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// Gets the user data that was given when a proxy was inserted
+	/// </summary>
+	uint32_t GetUserData(int32_t proxy) const { return _nodes[proxy].UserData; }
+	/// <summary>
+	/// Gets the number of objects in the tree
+	/// </summary>
+	size_t GetProxyCount() const { return _proxyCount; }
+	/// <summary>
+	/// Gets the number of levels in the tree
+	/// </summary>
+	int32_t GetHeight() const { return _root == NULL_NODE ? 0 : _nodes[_root].Height + 1; }
+	/// <summary>
+	/// Gets the surface area of all the branches relative to the root, lower is better. This is what is used to decide
+	/// when the tree needs to be rebuilt
+	/// </summary>
+	float GetCost() const;
+	/// <summary>
+	/// Gets the number of times the tree has been rebuilt
+	/// </summary>
+	uint32_t GetRebuildCount() const { return _rebuildCount; }
+
+	/// <summary>
+	/// Calls callback(userData) for every object whose fat box overlaps the given box
+	/// </summary>
+	template <typename Func>
+	void QueryAABB(const glm::vec3& min, const glm::vec3& max, Func callback) const {
+		_Query([&](const Node& node) {
+			return glm::all(glm::lessThanEqual(node.Min, max)) && glm::all(glm::lessThanEqual(min, node.Max));
+		}, callback);
+	}
+	/// <summary>
+	/// Calls callback(userData) for every object whose fat box touches the given sphere
+	/// </summary>
+	template <typename Func>
+	void QuerySphere(const glm::vec3& center, float radius, Func callback) const {
+		_Query([&](const Node& node) {
+			glm::vec3 offset = glm::clamp(center, node.Min, node.Max) - center;
+			return glm::dot(offset, offset) <= radius * radius;
+		}, callback);
+	}
+	/// <summary>
+	/// Calls callback(userData) for every object whose fat box might be inside the frustum
+	/// </summary>
+	template <typename Func>
+	void QueryFrustum(const Frustum& frustum, Func callback) const {
+		_Query([&](const Node& node) {
+			return frustum.TestAABB((node.Min + node.Max) * 0.5f, (node.Max - node.Min) * 0.5f);
+		}, callback);
+	}
+	/// <summary>
+	/// Walks the objects whose fat boxes are hit by a ray, roughly nearest first. For each one, callback(userData, maxDistance)
+	/// is called, and should return the distance to the object if it was hit and is closer than maxDistance, or
+	/// maxDistance otherwise. The ray is clipped to the returned distance, so anything further away is skipped
+	/// </summary>
+	/// <param name="origin">The start of the ray</param>
+	/// <param name="direction">The direction of the ray, distances are measured in multiples of its length</param>
+	/// <param name="maxDistance">How far along the ray to look</param>
+	template <typename Func>
+	void Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Func callback) const {
+		if (_root == NULL_NODE) {
+			return;
+		}
+
+		glm::vec3 invDir = 1.0f / direction;
+		_stack.clear();
+		_stack.push_back(_root);
+		while (!_stack.empty()) {
+			int32_t index = _stack.back();
+			_stack.pop_back();
+
+			const Node& node = _nodes[index];
+			float entry = 0.0f;
+			if (!RayAABB(origin, invDir, node.Min, node.Max, maxDistance, entry)) {
+				continue;
+			}
+
+			if (node.IsLeaf()) {
+				maxDistance = glm::min(maxDistance, callback(node.UserData, maxDistance));
+			} else {
+				// Push the further child first, so the nearer one is visited first and can clip the ray sooner
+				const Node& left = _nodes[node.Left];
+				const Node& right = _nodes[node.Right];
+				float leftDist = glm::dot((left.Min + left.Max) * 0.5f - origin, direction);
+				float rightDist = glm::dot((right.Min + right.Max) * 0.5f - origin, direction);
+				_stack.push_back(leftDist < rightDist ? node.Right : node.Left);
+				_stack.push_back(leftDist < rightDist ? node.Left : node.Right);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Tests a ray against a box using the slab method
+	/// </summary>
+	/// <param name="origin">The start of the ray</param>
+	/// <param name="invDir">One over the ray's direction</param>
+	/// <param name="min">The minimum corner of the box</param>
+	/// <param name="max">The maximum corner of the box</param>
+	/// <param name="maxDistance">How far along the ray to look</param>
+	/// <param name="distance">Set to the distance along the ray where it enters the box (0 if it starts inside)</param>
+	/// <returns>True if the ray hits the box before maxDistance</returns>
+	static bool RayAABB(const glm::vec3& origin, const glm::vec3& invDir, const glm::vec3& min, const glm::vec3& max, float maxDistance, float& distance);
+
+protected:
+	struct Node
+	{
+		glm::vec3 Min;
+		glm::vec3 Max;
+		// For nodes in the free list, this is the next free node instead
+		int32_t   Parent;
+		int32_t   Left;
+		int32_t   Right;
+		// Leaves are height 0
+		int32_t   Height;
+		uint32_t  UserData;
+
+		bool IsLeaf() const { return Left == NULL_NODE; }
+	};
+
+	std::vector<Node> _nodes;
+	int32_t  _root;
+	int32_t  _freeList;
+	size_t   _proxyCount;
+	float    _margin;
+	float    _rebuildThreshold;
+	// The cost of the tree when it was last built, and whether anything has changed since Optimize last looked
+	float    _builtCost;
+	bool     _changed;
+	uint32_t _rebuildCount;
+	// Scratch space for walking the tree, so queries don't need to allocate
+	mutable std::vector<int32_t> _stack;
+	std::vector<int32_t> _leaves;
+
+	int32_t _AllocateNode();
+	void _FreeNode(int32_t index);
+	void _InsertLeaf(int32_t leaf);
+	void _RemoveLeaf(int32_t leaf);
+	// Recalculates the boxes and heights of every node from index up to the root
+	void _Refit(int32_t index);
+	// Builds a branch over _leaves[first, last), returning its root
+	int32_t _Build(size_t first, size_t last);
+
+	// Walks every node that overlaps returns true for, and calls visit on the leaves
+	template <typename Overlaps, typename Visit>
+	void _Query(Overlaps overlaps, Visit visit) const {
+		if (_root == NULL_NODE) {
+			return;
+		}
+
+		_stack.clear();
+		_stack.push_back(_root);
+		while (!_stack.empty()) {
+			const Node& node = _nodes[_stack.back()];
+			_stack.pop_back();
+			if (!overlaps(node)) {
+				continue;
+			}
+
+			if (node.IsLeaf()) {
+				visit(node.UserData);
+			} else {
+				_stack.push_back(node.Left);
+				_stack.push_back(node.Right);
+			}
+		}
+	}
+};
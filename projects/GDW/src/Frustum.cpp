@@ -0,0 +1,66 @@
+#include "Frustum.h"
+
+Frustum::Frustum()
+{
+	// With no planes set, nothing is ever culled
+	for (int ix = 0; ix < 6; ix++) {
+		_planes[ix] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+}
+
+Frustum::Frustum(const glm::mat4& viewProjection)
+{
+	Extract(viewProjection);
+}
+
+void Frustum::Extract(const glm::mat4& viewProjection)
+{
+	// Each plane is a sum or difference of the matrix's rows (Gribb and Hartmann). GLM is column major, so we need to
+	// pull the rows out first
+	glm::mat4 rows = glm::transpose(viewProjection);
+	_planes[0] = rows[3] + rows[0];
+	_planes[1] = rows[3] - rows[0];
+	_planes[2] = rows[3] + rows[1];
+	_planes[3] = rows[3] - rows[1];
+	_planes[4] = rows[3] + rows[2];
+	_planes[5] = rows[3] - rows[2];
+
+	// Normalize so that distances to the planes come out in world units
+	for (int ix = 0; ix < 6; ix++) {
+		float length = glm::length(glm::vec3(_planes[ix]));
+		if (length > 0.0f) {
+			_planes[ix] /= length;
+		}
+	}
+}
+
+bool Frustum::TestSphere(const glm::vec3& center, float radius) const
+{
+	for (int ix = 0; ix < 6; ix++) {
+		if (glm::dot(glm::vec3(_planes[ix]), center) + _planes[ix].w < -radius) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Frustum::TestAABB(const glm::vec3& center, const glm::vec3& extents) const
+{
+	for (int ix = 0; ix < 6; ix++) {
+		glm::vec3 normal = glm::vec3(_planes[ix]);
+		// How far the box reaches towards the inside of the plane from its center
+		float reach = glm::dot(glm::abs(normal), extents);
+		if (glm::dot(normal, center) + _planes[ix].w < -reach) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Frustum::TestBounds(const Bounds& bounds) const
+{
+	if (!bounds.IsValid()) {
+		return true;
+	}
+	return TestSphere(bounds.Center, bounds.Radius) && TestAABB(bounds.Center, bounds.GetExtents());
+}
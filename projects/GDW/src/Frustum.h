@@ -0,0 +1,46 @@
+#pragma once
+#include <GLM/glm.hpp>
+#include "Bounds.h"
+
+/// <summary>
+/// The six planes around everything a camera can see, pulled out of a view-projection matrix. Used to skip drawing
+/// objects that are entirely off screen
+/// </summary>
+class Frustum
+{
+public:
+	Frustum();
+	/// <summary>
+	/// Creates the frustum for a view-projection matrix, see Extract
+	/// </summary>
+	explicit Frustum(const glm::mat4& viewProjection);
+
+	/// <summary>
+	/// Recalculates the planes from a view-projection matrix (ex: Camera::GetViewProjection). Works for both
+	/// perspective and orthographic projections
+	/// </summary>
+	void Extract(const glm::mat4& viewProjection);
+
+	/// <summary>
+	/// Returns true if any part of the sphere could be inside the frustum
+	/// </summary>
+	bool TestSphere(const glm::vec3& center, float radius) const;
+	/// <summary>
+	/// Returns true if any part of the box could be inside the frustum
+	/// </summary>
+	bool TestAABB(const glm::vec3& center, const glm::vec3& extents) const;
+	/// <summary>
+	/// Tests world space bounds against the frustum, checking the sphere first and then the box. Invalid bounds are
+	/// always treated as visible
+	/// </summary>
+	bool TestBounds(const Bounds& bounds) const;
+
+	/// <summary>
+	/// Gets one of the planes, xyz is the normal pointing into the frustum and w is the distance
+	/// </summary>
+	const glm::vec4& GetPlane(int index) const { return _planes[index]; }
+
+protected:
+	// Left, right, bottom, top, near, far
+	glm::vec4 _planes[6];
+};
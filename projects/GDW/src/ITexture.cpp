@@ -2,10 +2,12 @@
 
 ITexture::Limits ITexture::__limits = ITexture::Limits();
 bool ITexture::__isStaticInit = false;
+uint64_t ITexture::__bindCounter = 0;
 
 ITexture::ITexture(TextureType type) :
 	_type(type),
-	_handle(0)
+	_handle(0),
+	_lastBind(0)
 {
 	__StaticInit();
 	_Recreate();
@@ -27,6 +29,7 @@ ITexture::~ITexture() {
 }
 
 void ITexture::Bind(int slot) {
+	_lastBind = ++__bindCounter;
 	if (_handle != 0) {
 		// Instead of glActiveTexture + glBindTexture, we can one line it now :D
 		glBindTextureUnit(slot, _handle); 
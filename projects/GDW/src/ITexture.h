@@ -46,6 +46,24 @@ public:
 	/// <param name="slot">The slot to unbind, 0 &lt;= slot &lt; MAX_TEXTURE_UNITS</param>
 	static void Unbind(int slot);
 
+	/// <summary>
+	/// Makes sure this texture's data is on the GPU, reloading it if it was unloaded. Binding never loads anything, so
+	/// this should be called for everything that's about to be drawn before any draw calls are made
+	/// </summary>
+	/// <returns>True if the texture had to be reloaded</returns>
+	virtual bool MakeResident() { return false; }
+
+	/// <summary>
+	/// Gets a stamp for when this texture was last bound, higher values were bound more recently. Textures that have
+	/// never been bound return 0
+	/// </summary>
+	uint64_t GetLastBind() const { return _lastBind; }
+	/// <summary>
+	/// Gets the stamp that was handed to the most recently bound texture, compare against GetLastBind to see if a texture
+	/// has been bound since a given point
+	/// </summary>
+	static uint64_t GetBindCounter() { return __bindCounter; }
+
 	/// <summary>
 	/// Clears the first level of this texture to a solid color, note this only works for color texture types!
 	/// </summary>
@@ -67,11 +85,13 @@ protected:
 
 	GLuint _handle;    // The OpenGL handle for this textureW
 	TextureType _type; // The type for this texture, mainly used for debugging
+	uint64_t _lastBind; // The value of __bindCounter the last time this texture was bound
 
 // STATIC SECTION
 private:
 	static Limits __limits;
 	static bool __isStaticInit;
+	static uint64_t __bindCounter;
 
 	static void __StaticInit();
 
@@ -1,18 +1,90 @@
 #include "Material.h"
+#include "UniformBlocks.h"
+
+#include <cstring>
 
 SMI_Material::SMI_Material()
 {
+	m_BindingsDirty = true;
+	m_BlockSize = 0;
+	m_HasBlock = false;
+	m_BlockOffset = 0;
+	m_BlockStamp = 0;
+	m_ModelUniform = nullptr;
 }
 
 void SMI_Material::BindAllUniform()
 {
-	std::unordered_map<std::string, Uniform::Sptr>::iterator it = m_UniformMap.begin();
+	if (m_BindingsDirty)
+	{
+		ResolveBindings();
+	}
 
-	while (it != m_UniformMap.end())
+	for (const UniformBinding& binding : m_Bindings)
 	{
-		it->second->SetUniform(m_Shader);
-		it->second->SetUniformMatrix(m_Shader);
-		it++;
+		binding.Value->Upload(m_Shader.get(), binding.Location);
+	}
+
+	if (m_BlockSize > 0)
+	{
+		BindBlock();
+	}
+}
+
+void SMI_Material::BindBlock()
+{
+	//materials are only written once a frame, after that we can just bind the copy that's already in the buffer
+	uint64_t stamp = UniformBlocks::GetStamp();
+	if (m_BlockStamp != stamp)
+	{
+		uint8_t* dest = UniformBlocks::Allocate(m_BlockSize, m_BlockOffset);
+		std::memset(dest, 0, m_BlockSize);
+		for (const UniformBinding& binding : m_BlockBindings)
+		{
+			binding.Value->Write(dest + binding.Location);
+		}
+		//allocating might have grown the ring buffer, which changes the stamp
+		m_BlockStamp = UniformBlocks::GetStamp();
+	}
+
+	UniformBlocks::BindRange(UniformBlocks::MATERIAL_BINDING, m_BlockOffset, m_BlockSize);
+}
+
+void SMI_Material::ResolveBindings()
+{
+	m_Bindings.clear();
+	m_BlockBindings.clear();
+	m_BlockSize = 0;
+	m_BlockStamp = 0;
+	m_BindingsDirty = false;
+	if (m_Shader == nullptr)
+	{
+		return;
+	}
+
+	int blockSize = m_Shader->GetUniformBlockSize("Material");
+	if (blockSize > 0)
+	{
+		m_BlockSize = static_cast<size_t>(blockSize);
+	}
+
+	//look up every uniform's location once, uniforms the shader doesn't use are left out
+	for (const auto& uniform : m_UniformMap)
+	{
+		int location = m_Shader->GetUniformLocation(uniform.first);
+		int offset = m_Shader->GetUniformBlockOffset("Material", uniform.first);
+		if (location != -1)
+		{
+			m_Bindings.push_back({ location, uniform.second.get() });
+		}
+		else if (offset != -1)
+		{
+			m_BlockBindings.push_back({ offset, uniform.second.get() });
+		}
+		else
+		{
+			LOG_WARN("Ignoring uniform \"{}\"", uniform.first);
+		}
 	}
 }
 
@@ -38,10 +110,24 @@ void SMI_Material::UnbindAllTextures()
 	}
 }
 
+void SMI_Material::setShader(const Shader::Sptr& _shader)
+{
+	m_Shader = _shader;
+	m_HasBlock = m_Shader != nullptr && m_Shader->GetUniformBlockSize("Material") > 0;
+	m_BindingsDirty = true;
+}
+
 void SMI_Material::setUniform(const Uniform::Sptr& _uniform)
 {
 	std::string Name = _uniform->getName();
 	m_UniformMap[Name] = _uniform;
+	m_BindingsDirty = true;
+
+	//keep the matrix the scene sets for every object on hand, so it doesn't have to look it up by name
+	if (Name == "Model")
+	{
+		m_ModelUniform = dynamic_cast<UniformMatrixObject<glm::mat4>*>(_uniform.get());
+	}
 }
 
 void SMI_Material::setTexture(const ITexture::Sptr& _texture, const int& slot)
@@ -69,6 +155,70 @@ ITexture::Sptr SMI_Material::getTexture(const int& TextureSlot)
 	return nullptr;
 }
 
+void SMI_Material::setModelMatrix(const glm::mat4& model)
+{
+	//check if nullptr and create uniform if needed
+	if (m_ModelUniform == nullptr)
+	{
+		UniformMatrixObject<glm::mat4>::Sptr ModelMatrix = UniformMatrixObject<glm::mat4>::Create();
+		ModelMatrix->setName("Model");
+		setUniform(ModelMatrix);
+	}
+
+	m_ModelUniform->setData(model);
+}
+
+bool SMI_Material::canInstance() const
+{
+	//the Material block is laid out for this shader, not its instanced variant
+	if (m_HasBlock)
+	{
+		return false;
+	}
+
+	for (const auto& uniform : m_UniformMap)
+	{
+		if (uniform.first != "Model")
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool SMI_Material::hasSameTextures(const SMI_Material& other) const
+{
+	if (m_TextureMap.size() != other.m_TextureMap.size())
+	{
+		return false;
+	}
+
+	for (const auto& texture : m_TextureMap)
+	{
+		auto it = other.m_TextureMap.find(texture.first);
+		if (it == other.m_TextureMap.end() || it->second != texture.second)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int SMI_Material::makeTexturesResident()
+{
+	int count = 0;
+	for (const auto& texture : m_TextureMap)
+	{
+		if (texture.second != nullptr && texture.second->MakeResident())
+		{
+			count++;
+		}
+	}
+	return count;
+}
+
 SMI_Material::~SMI_Material()
 {
 }
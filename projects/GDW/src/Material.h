@@ -1,6 +1,7 @@
 #pragma once
 #include <memory>
 #include <unordered_map>
+#include <vector>
 #include "Uniform.h"
 #include "ITexture.h"
 
@@ -26,7 +27,7 @@ public:
 	void UnbindAllTextures();
 
 	//setters
-	void setShader(const Shader::Sptr& _shader) { m_Shader = _shader; }
+	void setShader(const Shader::Sptr& _shader);
 
 	//creates uniform objects elsewhere, pass into SetUniform, then add to material
 	void setUniform(const Uniform::Sptr& _uniform);
@@ -37,15 +38,53 @@ public:
 	Shader::Sptr getShader() const { return m_Shader; }
 	Uniform::Sptr getUniform(const std::string& UniformName);
 	ITexture::Sptr getTexture(const int& TextureSlot);
+	const std::unordered_map<int, ITexture::Sptr>& getTextures() const { return m_TextureMap; }
+
+	//sets the Model matrix uniform, creating it the first time. The view projection comes from the Frame block
+	void setModelMatrix(const glm::mat4& model);
+
+	//true if the material has no uniforms besides the Model matrix the scene sets per object, and no Material block,
+	//so objects using it can be drawn together with instancing
+	bool canInstance() const;
+	//true if both materials bind the same textures to the same slots
+	bool hasSameTextures(const SMI_Material& other) const;
+	//reloads any of the material's textures that the texture budget unloaded, returns how many had to be reloaded
+	int makeTexturesResident();
 
 	//destructor
 	~SMI_Material();
 
 private:
+	//looks up the shader location of every uniform, done once whenever the shader or uniforms change
+	void ResolveBindings();
+	//writes our Material block into the ring buffer once per frame, and binds it
+	void BindBlock();
+
 	Shader::Sptr m_Shader;
 	//holds an unordered map of our uniforms
 	std::unordered_map<std::string, Uniform::Sptr> m_UniformMap;
 	//holds an unordered map of all textures
 	std::unordered_map<int, ITexture::Sptr> m_TextureMap;
 
+	//a uniform and where it goes in the shader, so binding them is just a walk over an array
+	struct UniformBinding
+	{
+		int Location;
+		Uniform* Value;
+	};
+	std::vector<UniformBinding> m_Bindings;
+	bool m_BindingsDirty;
+
+	//uniforms that live in the shader's Material block, Location is their offset into the block
+	std::vector<UniformBinding> m_BlockBindings;
+	//the size of the Material block, or 0 if the shader doesn't have one
+	size_t m_BlockSize;
+	bool m_HasBlock;
+	//where the block was last written in the ring buffer, and the stamp of the frame it was written in
+	size_t m_BlockOffset;
+	uint64_t m_BlockStamp;
+
+	//the Model matrix, owned by m_UniformMap
+	UniformMatrixObject<glm::mat4>* m_ModelUniform;
+
 };
\ No newline at end of file
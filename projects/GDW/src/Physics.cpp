@@ -1,17 +1,29 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include "GLM/gtx/quaternion.hpp"
 #include "Physics.h"
+#include "Utils/ShapeCache.h"
+#include "LinearMath/btTransformUtil.h"
+
+#include <cmath>
+
+//kinematic bodies only move when we move them, so they can sleep as soon as they've stopped. They can't have a
+//threshold of zero, Bullet only counts a body as resting if it's moving slower than the threshold
+static SMI_SleepSettings DefaultSleepSettings[] = {
+    { true, 0.8f, 1.0f },   //STATIC
+    { true, 0.01f, 0.01f }, //KINEMATIC
+    { true, 0.8f, 1.0f }    //DYNAMIC
+};
 
 SMI_Physics::SMI_Physics()
 {
     //set up bullet collision shape
-    objShape = new btBoxShape(btVector3(0.5, 0.5, 0.5));
+    objShape = ShapeCache::GetBox(glm::vec3(0.5f));
     //set up bullet transform
     objPos.setIdentity();
     objPos.setOrigin(btVector3(0.f, 0.f, 0.f));
     objPos.setRotation(btQuaternion());
     //setup up bullet motion state
-    objMotionState = new btDefaultMotionState(objPos);
+    objMotionState = new SMI_MotionState(objPos);
 
     //setup mass, static v dynmaic status, and local internia
     btVector3 localIntertia(0, 0, 0);
@@ -23,60 +35,66 @@ SMI_Physics::SMI_Physics()
     btRigidBody::btRigidBodyConstructionInfo rbInfo(objMass, objMotionState, objShape, localIntertia);
     objRigidBody = new btRigidBody(rbInfo);
 
-    objRigidBody->setActivationState(DISABLE_DEACTIVATION);
+    setSleepSettings(getDefaultSleepSettings(BodyType));
 
     hasGravity = true;
+    world = nullptr;
 
     inWorld = false;
 
     Entity = static_cast<entt::entity>(-1);
 
     objRigidBody->setUserPointer(reinterpret_cast<void*>(static_cast<uint32_t>(Entity)));
+    objRigidBody->setUserIndex(CollisionLayer);
 }
 
 SMI_Physics::SMI_Physics(glm::vec3 position, glm::vec3 rotation, glm::vec3 scale, entt::entity _Entity, SMI_PhysicsBodyType _BodyType, float _objMass)
+    : SMI_Physics(position, rotation, ShapeCache::GetBox(scale / 2.f), _Entity, _BodyType, _objMass)
+{
+}
+
+SMI_Physics::SMI_Physics(glm::vec3 position, glm::vec3 rotation, btCollisionShape* _Shape, entt::entity _Entity, SMI_PhysicsBodyType _BodyType, float _objMass)
 { 
     //set up bullet collision shape
-    objShape = new btBoxShape(btVector3(scale.x /2, scale.y / 2, scale.z / 2));
+    objShape = _Shape;
     //set up bullet transform
     objPos.setIdentity();
     objPos.setOrigin(btVector3(position.x, position.y, position.z));
     glm::quat rot = glm::quat(glm::radians(rotation));
     objPos.setRotation(btQuaternion(rot.x, rot.y, rot.z, rot.w));
     //setup up bullet motion state
-    objMotionState = new btDefaultMotionState(objPos);
+    objMotionState = new SMI_MotionState(objPos);
 
     //setup mass, static v dynmaic status, and local internia
     btVector3 localIntertia(0, 0, 0);
-    objMass = _objMass;
-
     BodyType = _BodyType;
-    if (BodyType == SMI_PhysicsBodyType::STATIC || BodyType == SMI_PhysicsBodyType::KINEMATIC)
-    {
-        _objMass = 0;
-    }
+    //Bullet only treats a body as immovable if it has no mass, static and kinematic bodies keep no inertia either
+    objMass = (BodyType == SMI_PhysicsBodyType::STATIC || BodyType == SMI_PhysicsBodyType::KINEMATIC) ? 0.f : _objMass;
 
     //create the rigidbody
     btRigidBody::btRigidBodyConstructionInfo rbInfo(objMass, objMotionState, objShape, localIntertia);
     objRigidBody = new btRigidBody(rbInfo);
 
-    //if it's kinematic, set the kinematic flag
+    //if it's kinematic, set the kinematic flag. Bullet marks every body without mass as static, which would make the
+    //collision filter and the body counts treat it like one
     if (BodyType == SMI_PhysicsBodyType::KINEMATIC) {
-        objRigidBody->setCollisionFlags(objRigidBody->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
+        objRigidBody->setCollisionFlags((objRigidBody->getCollisionFlags() & ~btCollisionObject::CF_STATIC_OBJECT) | btCollisionObject::CF_KINEMATIC_OBJECT);
     }
     else if (BodyType == SMI_PhysicsBodyType::STATIC) {
         objRigidBody->setCollisionFlags(objRigidBody->getCollisionFlags() | btCollisionObject::CF_STATIC_OBJECT);
     }
 
-    objRigidBody->setActivationState(DISABLE_DEACTIVATION);
+    setSleepSettings(getDefaultSleepSettings(BodyType));
 
     hasGravity = true;
+    world = nullptr;
 
     inWorld = false;
 
     Entity = _Entity;
 
     objRigidBody->setUserPointer(reinterpret_cast<void*>(static_cast<uint32_t>(Entity)));
+    objRigidBody->setUserIndex(CollisionLayer);
 }
 
 SMI_Physics::~SMI_Physics()
@@ -87,40 +105,188 @@ void SMI_Physics::Update(float deltaTime)
 {
 }
 
-void SMI_Physics::SetPosition(glm::vec3 pos)
+void SMI_Physics::setSleepSettings(const SMI_SleepSettings& _Settings)
 {
-    btVector3 newPos = btVector3(pos.x, pos.y, pos.z);
-    btTransform TransPos;
-    objRigidBody->getMotionState()->getWorldTransform(TransPos);
-    TransPos.setOrigin(newPos);
-    objRigidBody->getMotionState()->setWorldTransform(TransPos);
+    SleepSettings = _Settings;
+    objRigidBody->setSleepingThresholds(SleepSettings.LinearThreshold, SleepSettings.AngularThreshold);
+
+    //DISABLE_DEACTIVATION sticks until it's forced off
+    if (!SleepSettings.CanSleep)
+    {
+        objRigidBody->forceActivationState(DISABLE_DEACTIVATION);
+    }
+    else if (objRigidBody->getActivationState() == DISABLE_DEACTIVATION)
+    {
+        objRigidBody->forceActivationState(ACTIVE_TAG);
+        objRigidBody->setDeactivationTime(0.f);
+    }
+}
+
+void SMI_Physics::WakeUp()
+{
+    //Bullet never puts static bodies back to sleep, so waking one would just make everything near it collide forever.
+    //Kinematic bodies are only woken if it's forced
+    if (BodyType != SMI_PhysicsBodyType::STATIC)
+    {
+        objRigidBody->activate(true);
+    }
 }
 
-glm::vec3 SMI_Physics::GetPosition()
+void SMI_Physics::setDefaultSleepSettings(SMI_PhysicsBodyType _Type, const SMI_SleepSettings& _Settings)
 {
-    btTransform TransPos;
-    objRigidBody->getMotionState()->getWorldTransform(TransPos);
-    btVector3 pos = TransPos.getOrigin();
+    DefaultSleepSettings[static_cast<int>(_Type)] = _Settings;
+}
 
-    return glm::vec3((float)pos.getX(), (float)pos.getY(), (float)pos.getZ());
+const SMI_SleepSettings& SMI_Physics::getDefaultSleepSettings(SMI_PhysicsBodyType _Type)
+{
+    return DefaultSleepSettings[static_cast<int>(_Type)];
+}
+
+void SMI_Physics::setCollisionLayer(const int& _Layer)
+{
+    CollisionLayer = _Layer;
+    //the collision tracker reads the layer back from the body
+    objRigidBody->setUserIndex(CollisionLayer);
+
+    //if the body is already in a world this only affects pairs that haven't been found yet
+    if (objRigidBody->getBroadphaseHandle() != nullptr)
+    {
+        objRigidBody->getBroadphaseHandle()->m_collisionFilterGroup = getCollisionGroup();
+    }
+}
+
+void SMI_Physics::setCollisionMask(const uint32_t& _Mask)
+{
+    CollisionMask = _Mask;
+
+    if (objRigidBody->getBroadphaseHandle() != nullptr)
+    {
+        objRigidBody->getBroadphaseHandle()->m_collisionFilterMask = static_cast<int>(CollisionMask);
+    }
+}
+
+void SMI_Physics::setHasGravity(const bool& _hasGravity)
+{
+    if (_hasGravity == hasGravity)
+    {
+        return;
+    }
+    hasGravity = _hasGravity;
+
+    //bodies normally take their gravity from the world when they're added to it or the world's gravity changes, this
+    //flag makes the world leave them alone
+    WakeUp();
+    if (hasGravity)
+    {
+        //the scene's gravity may have changed while this body had none, so take the world's as it is now. Bodies that
+        //aren't in a world yet get it when they're added
+        objRigidBody->setFlags(objRigidBody->getFlags() & ~BT_DISABLE_WORLD_GRAVITY);
+        if (world != nullptr)
+        {
+            objRigidBody->setGravity(world->getGravity());
+        }
+    }
+    else
+    {
+        objRigidBody->setFlags(objRigidBody->getFlags() | BT_DISABLE_WORLD_GRAVITY);
+        objRigidBody->setGravity(btVector3(0.f, 0.f, 0.f));
+    }
+}
+
+void SMI_Physics::SetPosition(glm::vec3 pos)
+{
+    btTransform pose = objMotionState->getCurrent();
+    pose.setOrigin(btVector3(pos.x, pos.y, pos.z));
+    Teleport(pose);
+}
+
+glm::vec3 SMI_Physics::GetPosition() const
+{
+    const btVector3& pos = objMotionState->getCurrent().getOrigin();
+    return glm::vec3(pos.getX(), pos.getY(), pos.getZ());
 }
 
 void SMI_Physics::SetRotation(glm::vec3 rot)
 {
+    SetOrientation(glm::quat(glm::radians(rot)));
+}
+
+glm::vec3 SMI_Physics::GetRotation() const
+{
+    return glm::degrees(glm::eulerAngles(GetOrientation()));
+}
+
+void SMI_Physics::SetOrientation(const glm::quat& rot)
+{
+    btTransform pose = objMotionState->getCurrent();
+    pose.setRotation(btQuaternion(rot.x, rot.y, rot.z, rot.w));
+    Teleport(pose);
+}
+
+glm::quat SMI_Physics::GetOrientation() const
+{
+    btQuaternion rot = objMotionState->getCurrent().getRotation();
+    return glm::quat(rot.getW(), rot.getX(), rot.getY(), rot.getZ());
+}
+
+void SMI_Physics::SetPose(const glm::vec3& pos, const glm::quat& rot)
+{
+    Teleport(btTransform(btQuaternion(rot.x, rot.y, rot.z, rot.w), btVector3(pos.x, pos.y, pos.z)));
+}
+
+void SMI_Physics::GetPose(glm::vec3& pos, glm::quat& rot) const
+{
+    const btTransform& pose = objMotionState->getCurrent();
+    const btVector3& origin = pose.getOrigin();
+    btQuaternion rotation = pose.getRotation();
+    pos = glm::vec3(origin.getX(), origin.getY(), origin.getZ());
+    rot = glm::quat(rotation.getW(), rotation.getX(), rotation.getY(), rotation.getZ());
+}
+
+void SMI_Physics::SetLinearVelocity(const glm::vec3& velocity)
+{
+    WakeUp();
+    objRigidBody->setLinearVelocity(btVector3(velocity.x, velocity.y, velocity.z));
+}
+
+glm::vec3 SMI_Physics::GetLinearVelocity() const
+{
+    const btVector3& velocity = objRigidBody->getLinearVelocity();
+    return glm::vec3(velocity.getX(), velocity.getY(), velocity.getZ());
+}
+
+void SMI_Physics::SetAngularVelocity(const glm::vec3& velocity)
+{
+    WakeUp();
+    objRigidBody->setAngularVelocity(btVector3(velocity.x, velocity.y, velocity.z));
+}
+
+glm::vec3 SMI_Physics::GetAngularVelocity() const
+{
+    const btVector3& velocity = objRigidBody->getAngularVelocity();
+    return glm::vec3(velocity.getX(), velocity.getY(), velocity.getZ());
 }
 
-glm::vec3 SMI_Physics::GetRotation()
+void SMI_Physics::Teleport(const btTransform& pose)
 {
-	return glm::vec3();
+    objMotionState->Teleport(pose);
+    //Bullet only reads the motion state of kinematic bodies, everything else keeps its own pose once it's in the
+    //world. The interpolation pose is where Bullet thinks the body was last step, moving it too means the jump
+    //isn't turned into a velocity
+    objRigidBody->setWorldTransform(pose);
+    objRigidBody->setInterpolationWorldTransform(pose);
+    WakeUp();
 }
 
 void SMI_Physics::AddForce(glm::vec3 force)
 {
+    WakeUp();
     objRigidBody->applyCentralForce(btVector3(force.x, force.y, force.z));
 }
 
 void SMI_Physics::AddImpulse(glm::vec3 impulse)
 {
+    WakeUp();
     objRigidBody->applyCentralImpulse(btVector3(impulse.x, impulse.y, impulse.z));
 }
 
@@ -129,8 +295,337 @@ void SMI_Physics::ClearForces()
     objRigidBody->clearForces();
 }
 
+SMI_MotionState::SMI_MotionState(const btTransform& _Start)
+{
+    Previous = _Start;
+    Current = _Start;
+    Queue = nullptr;
+    Entity = entt::null;
+    LastStep = 0;
+    Queued = false;
+}
+
+void SMI_MotionState::setWorldTransform(const btTransform& worldTrans)
+{
+    Previous = Current;
+    Current = worldTrans;
+    if (Queue != nullptr)
+    {
+        LastStep = Queue->Step;
+    }
+    Enqueue();
+}
+
+void SMI_MotionState::Teleport(const btTransform& worldTrans)
+{
+    Previous = worldTrans;
+    Current = worldTrans;
+    Enqueue();
+}
+
+void SMI_MotionState::setQueue(SMI_MotionQueue* _Queue, const entt::entity& _Entity)
+{
+    Queue = _Queue;
+    Entity = _Entity;
+    Queued = false;
+    Enqueue();
+}
+
+bool SMI_MotionState::Settle()
+{
+    if (Queue != nullptr && LastStep == Queue->Step)
+    {
+        return true;
+    }
+
+    Previous = Current;
+    Queued = false;
+    return false;
+}
+
+void SMI_MotionState::Enqueue()
+{
+    if (Queue != nullptr && !Queued)
+    {
+        Queue->Moved.push_back(Entity);
+        Queued = true;
+    }
+}
+
+SMI_KinematicController::SMI_KinematicController()
+{
+    Mode = SMI_TrackMode::LOOP;
+    Rotates = false;
+    TrackTime = 0.f;
+    Speed = 1.f;
+    Playing = false;
+    Snap = false;
+    LastKey = 0;
+
+    HasTarget = false;
+    TargetRotates = false;
+    TargetPosition = glm::vec3(0.f);
+    TargetRotation = glm::quat(1.f, 0.f, 0.f, 0.f);
+
+    LinearVelocity = glm::vec3(0.f);
+    AngularVelocity = glm::vec3(0.f);
+}
+
+void SMI_KinematicController::setTarget(const glm::vec3& _Position)
+{
+    HasTarget = true;
+    TargetRotates = false;
+    TargetPosition = _Position;
+}
+
+void SMI_KinematicController::setTarget(const glm::vec3& _Position, const glm::quat& _Rotation)
+{
+    HasTarget = true;
+    TargetRotates = true;
+    TargetPosition = _Position;
+    TargetRotation = _Rotation;
+}
+
+void SMI_KinematicController::setTrack(const std::vector<SMI_Keyframe>& _Track, SMI_TrackMode _Mode, bool _Rotates)
+{
+    Track = _Track;
+    Mode = _Mode;
+    Rotates = _Rotates;
+    LastKey = 0;
+    setTrackTime(0.f);
+    Play();
+}
+
+void SMI_KinematicController::addKeyframe(float _Time, const glm::vec3& _Position)
+{
+    Track.push_back({ _Time, _Position, glm::quat(1.f, 0.f, 0.f, 0.f) });
+    if (!Playing)
+    {
+        Play();
+    }
+}
+
+void SMI_KinematicController::addKeyframe(float _Time, const glm::vec3& _Position, const glm::quat& _Rotation)
+{
+    //only the first keyframe decides if the track turns the body, so a track doesn't half turn it
+    if (Track.empty())
+    {
+        Rotates = true;
+    }
+    Track.push_back({ _Time, _Position, _Rotation });
+    if (!Playing)
+    {
+        Play();
+    }
+}
+
+void SMI_KinematicController::clearTrack()
+{
+    Track.clear();
+    Rotates = false;
+    Playing = false;
+    TrackTime = 0.f;
+    LastKey = 0;
+}
+
+void SMI_KinematicController::Play()
+{
+    Playing = !Track.empty();
+    Snap = Playing;
+}
+
+void SMI_KinematicController::setTrackTime(const float& _TrackTime)
+{
+    TrackTime = _TrackTime;
+    Snap = Playing;
+}
+
+void SMI_KinematicController::Sample(float _Time, glm::vec3& _Position, glm::quat& _Rotation) const
+{
+    if (Track.empty())
+    {
+        return;
+    }
+
+    const SMI_Keyframe* key = nullptr;
+    if (Track.size() == 1 || _Time <= Track.front().Time)
+    {
+        key = &Track.front();
+    }
+    else if (_Time >= Track.back().Time)
+    {
+        key = &Track.back();
+    }
+    if (key != nullptr)
+    {
+        _Position = key->Position;
+        if (Rotates)
+        {
+            _Rotation = key->Rotation;
+        }
+        return;
+    }
+
+    //tracks are usually played forwards a little at a time, so start looking from the last pair of keyframes
+    if (LastKey + 1 >= Track.size() || Track[LastKey].Time > _Time)
+    {
+        LastKey = 0;
+    }
+    while (Track[LastKey + 1].Time < _Time)
+    {
+        LastKey++;
+    }
+
+    const SMI_Keyframe& from = Track[LastKey];
+    const SMI_Keyframe& to = Track[LastKey + 1];
+    float span = to.Time - from.Time;
+    float t = span > 0.f ? (_Time - from.Time) / span : 1.f;
+    _Position = glm::mix(from.Position, to.Position, t);
+    if (Rotates)
+    {
+        _Rotation = glm::slerp(from.Rotation, to.Rotation, t);
+    }
+}
+
+bool SMI_KinematicController::Advance(float _Step, const btTransform& _Current, btTransform& _Target, bool& _Snap)
+{
+    btQuaternion current = _Current.getRotation();
+    glm::vec3 position;
+    glm::quat rotation = glm::quat(current.getW(), current.getX(), current.getY(), current.getZ());
+    _Snap = false;
+
+    if (HasTarget)
+    {
+        position = TargetPosition;
+        if (TargetRotates)
+        {
+            rotation = TargetRotation;
+        }
+        HasTarget = false;
+    }
+    else if (Playing)
+    {
+        float length = getTrackLength();
+        TrackTime += _Step * Speed;
+        _Snap = Snap;
+        Snap = false;
+
+        if (Mode == SMI_TrackMode::ONCE || length <= 0.f)
+        {
+            if (TrackTime >= length || TrackTime <= 0.f)
+            {
+                TrackTime = glm::clamp(TrackTime, 0.f, length);
+                Playing = false;
+            }
+            Sample(TrackTime, position, rotation);
+        }
+        else if (Mode == SMI_TrackMode::LOOP)
+        {
+            //going past the end starts again from the start, which is a jump rather than something the body moves
+            //through, so nothing gets flung by it
+            if (TrackTime >= length || TrackTime < 0.f)
+            {
+                TrackTime -= std::floor(TrackTime / length) * length;
+                _Snap = true;
+            }
+            Sample(TrackTime, position, rotation);
+        }
+        else
+        {
+            //one trip there and back
+            TrackTime -= std::floor(TrackTime / (2.f * length)) * 2.f * length;
+            Sample(TrackTime <= length ? TrackTime : 2.f * length - TrackTime, position, rotation);
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    _Target.setOrigin(btVector3(position.x, position.y, position.z));
+    _Target.setRotation(btQuaternion(rotation.x, rotation.y, rotation.z, rotation.w));
+    return true;
+}
+
+void SMI_KinematicController::Step(SMI_Physics& _Body, float _Step)
+{
+    if (_Body.getBodyType() != SMI_PhysicsBodyType::KINEMATIC)
+    {
+        return;
+    }
+
+    SMI_MotionState* state = _Body.getMotionState();
+    btRigidBody* body = _Body.getRigidBody();
+    btTransform target = state->getCurrent();
+    bool snap = false;
+    if (!Advance(_Step, state->getCurrent(), target, snap))
+    {
+        //left where it is, so Bullet sees it stop and it can fall asleep
+        LinearVelocity = glm::vec3(0.f);
+        AngularVelocity = glm::vec3(0.f);
+        return;
+    }
+
+    if (snap)
+    {
+        //SetPose moves the pose Bullet works out kinematic velocities from too, so the jump isn't turned into one
+        btQuaternion rot = target.getRotation();
+        const btVector3& pos = target.getOrigin();
+        _Body.SetPose(glm::vec3(pos.getX(), pos.getY(), pos.getZ()), glm::quat(rot.getW(), rot.getX(), rot.getY(), rot.getZ()));
+        body->setLinearVelocity(btVector3(0.f, 0.f, 0.f));
+        body->setAngularVelocity(btVector3(0.f, 0.f, 0.f));
+        LinearVelocity = glm::vec3(0.f);
+        AngularVelocity = glm::vec3(0.f);
+        return;
+    }
+
+    btVector3 linear, angular;
+    btTransformUtil::calculateVelocity(state->getCurrent(), target, _Step, linear, angular);
+    LinearVelocity = glm::vec3(linear.getX(), linear.getY(), linear.getZ());
+    AngularVelocity = glm::vec3(angular.getX(), angular.getY(), angular.getZ());
+    if (linear.fuzzyZero() && angular.fuzzyZero())
+    {
+        return;
+    }
+
+    //Bullet reads kinematic bodies from their motion state at the start of the step, and this also blends the
+    //transform between steps the same way dynamic bodies are
+    state->setWorldTransform(target);
+    body->setLinearVelocity(linear);
+    body->setAngularVelocity(angular);
+    _Body.WakeUp();
+}
+
+bool SMI_CollisionFilter::needBroadphaseCollision(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1) const
+{
+    //Bullet's default filtering keeps static bodies apart, so we do the same
+    const btCollisionObject* obj1 = static_cast<const btCollisionObject*>(proxy0->m_clientObject);
+    const btCollisionObject* obj2 = static_cast<const btCollisionObject*>(proxy1->m_clientObject);
+    if (obj1 != nullptr && obj2 != nullptr && obj1->isStaticObject() && obj2->isStaticObject())
+    {
+        return false;
+    }
+
+    return (proxy0->m_collisionFilterGroup & proxy1->m_collisionFilterMask) != 0 &&
+        (proxy1->m_collisionFilterGroup & proxy0->m_collisionFilterMask) != 0;
+}
+
 SMI_Collision::SMI_Collision()
 {
     b1 = entt::null;
     b2 = entt::null;
+    Layer1 = 0;
+    Layer2 = 0;
+    Event = SMI_ContactEvent::BEGIN;
+    Key = PairKey(b1, b2);
+}
+
+SMI_Collision::SMI_Collision(entt::entity _b1, entt::entity _b2, SMI_ContactEvent _Event, int _Layer1, int _Layer2)
+{
+    b1 = _b1;
+    b2 = _b2;
+    Layer1 = _Layer1;
+    Layer2 = _Layer2;
+    Event = _Event;
+    Key = PairKey(b1, b2);
 }
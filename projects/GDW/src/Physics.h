@@ -1,7 +1,9 @@
 #pragma once
 #include "GLM/glm.hpp"
+#include "GLM/gtc/quaternion.hpp"
 #include "entt.hpp"
 #include "btBulletDynamicsCommon.h"
+#include <vector>
 
 enum class SMI_PhysicsBodyType
 {
@@ -10,12 +12,76 @@ enum class SMI_PhysicsBodyType
 	DYNAMIC = 2
 };
 
+//the number of collision layers, each layer is one bit of a collision mask
+static const int SMI_MAX_COLLISION_LAYERS = 32;
+
+//when Bullet is allowed to put a body to sleep. A body that has been moving slower than both thresholds for the
+//scene's time to sleep stops being simulated until something touches it, pushes it or moves it
+struct SMI_SleepSettings
+{
+	bool CanSleep = true;
+	float LinearThreshold = 0.8f;
+	float AngularThreshold = 1.0f;
+};
+
+//the bodies that have moved since the scene last updated transforms, so it only has to look at things that move
+struct SMI_MotionQueue
+{
+	//the number of physics steps taken so far
+	uint32_t Step = 0;
+	std::vector<entt::entity> Moved;
+};
+
+//holds the pose of a body for the last two physics steps, and adds the body to its scene's motion queue whenever
+//Bullet moves it. Bullet never moves static bodies, so they never end up in the queue
+class SMI_MotionState : public btMotionState
+{
+public:
+	SMI_MotionState(const btTransform& _Start);
+	~SMI_MotionState() = default;
+
+	//called by Bullet to get the pose of kinematic bodies, and to hand us the pose of dynamic bodies after each step
+	void getWorldTransform(btTransform& worldTrans) const override { worldTrans = Current; }
+	void setWorldTransform(const btTransform& worldTrans) override;
+
+	//moves the body straight to a new pose, without blending from where it was
+	void Teleport(const btTransform& worldTrans);
+
+	//connects the body to a scene's queue, and queues it so the scene picks up its starting pose
+	void setQueue(SMI_MotionQueue* _Queue, const entt::entity& _Entity);
+
+	//the pose before and after the latest step that moved the body
+	const btTransform& getPrevious() const { return Previous; }
+	const btTransform& getCurrent() const { return Current; }
+
+	//called by the scene once it has written the body's pose. If the body didn't move in the latest step it has come to
+	//rest, so the previous pose catches up and the body leaves the queue. Returns true if it should stay in the queue
+	bool Settle();
+
+private:
+	btTransform Previous;
+	btTransform Current;
+
+	SMI_MotionQueue* Queue;
+	entt::entity Entity;
+	//the step the body last moved in, and whether it is already in the queue
+	uint32_t LastStep;
+	bool Queued;
+
+	void Enqueue();
+};
+
 class SMI_Physics
 {
 public:
 	SMI_Physics();
+	//makes a box body, boxes with the same scale share one shape
 	SMI_Physics(glm::vec3 position, glm::vec3 rotation, glm::vec3 scale, entt::entity _Entity, 
 									SMI_PhysicsBodyType _BodyType = SMI_PhysicsBodyType::DYNAMIC, float _objMass = 1.f);
+	//makes a body with any shape, ex: one from the ShapeCache. The shape is not deleted with the body, so it must stay
+	//alive as long as the body does
+	SMI_Physics(glm::vec3 position, glm::vec3 rotation, btCollisionShape* _Shape, entt::entity _Entity,
+									SMI_PhysicsBodyType _BodyType = SMI_PhysicsBodyType::DYNAMIC, float _objMass = 1.f);
 
 	//copy, move, and assingment constructors for entt
 	SMI_Physics(const SMI_Physics&) = default;
@@ -33,24 +99,60 @@ public:
 
 	void setInWorld(const bool& _inWorld) { inWorld = _inWorld; }
 	bool getInWorld() const { return inWorld; }
+	//the world the body was added to, used to pick up the world's current gravity when gravity is turned back on
+	void setWorld(btDynamicsWorld* _world) { world = _world; inWorld = _world != nullptr; }
 
-	void setHasGravity(const bool& _hasGravity) { hasGravity = _hasGravity; }
+	//bodies with gravity follow the scene's gravity, others have none
+	void setHasGravity(const bool& _hasGravity);
 	bool getHasGravity() const { return hasGravity; }
 
 	void setEntity(const entt::entity& _Entity) { Entity = _Entity; }
 	entt::entity getEntity() const { return Entity; }
 
-	void setIdentity(const int& _Identity) { ObjIdentity = _Identity; }
-	int getIdentity() const { return ObjIdentity; }
+	//sleeping, new bodies start with the defaults for their body type. Sleeping bodies wake up when something active
+	//touches them, or when they're moved, pushed or given forces through here
+	void setSleepSettings(const SMI_SleepSettings& _Settings);
+	const SMI_SleepSettings& getSleepSettings() const { return SleepSettings; }
+	bool isAwake() const { return objRigidBody->isActive(); }
+	void WakeUp();
+
+	//the sleep settings that new bodies of each type start with
+	static void setDefaultSleepSettings(SMI_PhysicsBodyType _Type, const SMI_SleepSettings& _Settings);
+	static const SMI_SleepSettings& getDefaultSleepSettings(SMI_PhysicsBodyType _Type);
 
+	//collision filtering, each body is in one layer and only collides with bodies in the layers set in its mask (and
+	//whose mask has its layer). These should be set before the body is attached to a scene
+	void setCollisionLayer(const int& _Layer);
+	int getCollisionLayer() const { return CollisionLayer; }
+	void setCollisionMask(const uint32_t& _Mask);
+	uint32_t getCollisionMask() const { return CollisionMask; }
+	//the group bits that Bullet uses for this body's layer
+	int getCollisionGroup() const { return static_cast<int>(1u << CollisionLayer); }
+
+	btCollisionShape* getShape() const { return objShape; }
 	btRigidBody* getRigidBody() const { return objRigidBody; }
+	SMI_MotionState* getMotionState() const { return objMotionState; }
 
 	//Functions to interface with Bullet
+	//the pose is read from the motion state, so it's where the body was after the last physics step. Setting any part
+	//of it moves the body straight there without blending, and wakes it up
 	void SetPosition(glm::vec3 pos);
-	glm::vec3 GetPosition();
+	glm::vec3 GetPosition() const;
+	//rotation in degrees, the same as the constructors take
 	void SetRotation(glm::vec3 rot);
-	glm::vec3 GetRotation();
-	
+	glm::vec3 GetRotation() const;
+	void SetOrientation(const glm::quat& rot);
+	glm::quat GetOrientation() const;
+	void SetPose(const glm::vec3& pos, const glm::quat& rot);
+	void GetPose(glm::vec3& pos, glm::quat& rot) const;
+
+	//velocity in units per second, and radians per second around each axis. Kinematic bodies get theirs from how they
+	//are moved (see SMI_KinematicController), so setting them does nothing
+	void SetLinearVelocity(const glm::vec3& velocity);
+	glm::vec3 GetLinearVelocity() const;
+	void SetAngularVelocity(const glm::vec3& velocity);
+	glm::vec3 GetAngularVelocity() const;
+
 	void AddForce(glm::vec3 force);
 	void AddImpulse(glm::vec3 impulse);
 	void ClearForces();
@@ -60,52 +162,170 @@ private:
 	float objMass;
 	btCollisionShape* objShape;
 	btTransform objPos;
-	btMotionState* objMotionState;
+	SMI_MotionState* objMotionState;
 	btRigidBody* objRigidBody;
 
-	//variable used to check for when player is colliding with ground
-	int ObjIdentity = 0;
+	//collision layer and the layers it collides with, used to filter collisions and pick collision callbacks
+	int CollisionLayer = 0;
+	uint32_t CollisionMask = ~0u;
+
+	SMI_SleepSettings SleepSettings;
 
 	bool inWorld;
 	bool hasGravity;
+	btDynamicsWorld* world;
 
 	entt::entity Entity;
 
 	SMI_PhysicsBodyType BodyType;
+
+	//moves both the motion state and the body, so Bullet doesn't carry on from the old pose
+	void Teleport(const btTransform& pose);
 };
 
-class SMI_Collision
+//what a kinematic track does once it reaches its last keyframe
+enum class SMI_TrackMode
+{
+	//stops on the last keyframe
+	ONCE = 0,
+	//jumps back to the first keyframe and starts again
+	LOOP = 1,
+	//plays backwards to the first keyframe, then forwards again
+	PING_PONG = 2
+};
+
+//a pose on a kinematic track, Time is in seconds from the start of the track
+struct SMI_Keyframe
+{
+	float Time;
+	glm::vec3 Position;
+	glm::quat Rotation;
+};
+
+//drives a kinematic body (ex: platforms, doors, elevators). Give it a target pose each tick, or a track of keyframes to
+//follow, and the scene moves the body there over each physics step. Bullet then sees the velocity the body moved at, so
+//it carries and pushes what it touches instead of popping into it, and the body can sleep once it stops.
+//Needs a KINEMATIC SMI_Physics on the same entity
+class SMI_KinematicController
 {
 public:
-	typedef std::shared_ptr<SMI_Collision>sptr;
+	SMI_KinematicController();
 
-	static inline sptr Create()
-	{
-		return std::make_shared<SMI_Collision>();
-	}
+	//moves the body to a pose over the next physics step, instead of following the track for that step. The first
+	//version keeps the body's rotation
+	void setTarget(const glm::vec3& _Position);
+	void setTarget(const glm::vec3& _Position, const glm::quat& _Rotation);
+	bool hasTarget() const { return HasTarget; }
+
+	//tracks, keyframes must be in time order. A track only turns the body if it was given rotations, otherwise the body
+	//keeps the rotation it has
+	void setTrack(const std::vector<SMI_Keyframe>& _Track, SMI_TrackMode _Mode = SMI_TrackMode::LOOP, bool _Rotates = true);
+	void addKeyframe(float _Time, const glm::vec3& _Position);
+	void addKeyframe(float _Time, const glm::vec3& _Position, const glm::quat& _Rotation);
+	void clearTrack();
+	const std::vector<SMI_Keyframe>& getTrack() const { return Track; }
+	//the time of the last keyframe
+	float getTrackLength() const { return Track.empty() ? 0.f : Track.back().Time; }
+
+	void setTrackMode(const SMI_TrackMode& _Mode) { Mode = _Mode; }
+	SMI_TrackMode getTrackMode() const { return Mode; }
+
+	//playback, tracks start playing as soon as they have keyframes. Playing puts the body straight onto the track, so
+	//it doesn't rush there from wherever it was. Pause a track before teleporting its body with SMI_Physics::SetPosition
+	void Play();
+	void Pause() { Playing = false; }
+	bool isPlaying() const { return Playing; }
+	void setTrackTime(const float& _TrackTime);
+	float getTrackTime() const { return TrackTime; }
+	//how fast the track plays, negative plays it backwards
+	void setSpeed(const float& _Speed) { Speed = _Speed; }
+	float getSpeed() const { return Speed; }
+
+	//the pose on the track at a time, clamped to the first and last keyframes. Rotation is left alone if the track
+	//doesn't turn the body
+	void Sample(float _Time, glm::vec3& _Position, glm::quat& _Rotation) const;
+
+	//the velocity the body moved at in the last physics step
+	glm::vec3 getLinearVelocity() const { return LinearVelocity; }
+	glm::vec3 getAngularVelocity() const { return AngularVelocity; }
+
+	//called by the scene before each physics step, moves the body to where it should be at the end of the step
+	void Step(SMI_Physics& _Body, float _Step);
+
+private:
+	//works out where the body should be at the end of the step. Returns false if it isn't going anywhere, snap is set
+	//if the body should be moved there without a velocity (ex: a looping track jumping back to its start)
+	bool Advance(float _Step, const btTransform& _Current, btTransform& _Target, bool& _Snap);
 
-	//Removing implicit constructors
-	SMI_Collision(const SMI_Collision& other) = delete;
-	SMI_Collision(SMI_Collision& other) = delete;
-	SMI_Collision& operator=(const SMI_Collision& other) = delete;
-	SMI_Collision& operator=(SMI_Collision&& other) = delete;
+	std::vector<SMI_Keyframe> Track;
+	SMI_TrackMode Mode;
+	bool Rotates;
+	float TrackTime;
+	float Speed;
+	bool Playing;
+	//set when the body needs to jump onto the track
+	bool Snap;
+	//the keyframe we were last after, so finding the next one is usually just a step forward
+	mutable size_t LastKey;
 
+	bool HasTarget;
+	bool TargetRotates;
+	glm::vec3 TargetPosition;
+	glm::quat TargetRotation;
 
+	glm::vec3 LinearVelocity;
+	glm::vec3 AngularVelocity;
+};
+
+//what happened to a pair of bodies in the last physics step
+enum class SMI_ContactEvent
+{
+	BEGIN = 0,
+	STAY = 1,
+	END = 2
+};
+
+//only lets pairs through the broadphase if their layers and masks allow it, and never pairs two static bodies
+class SMI_CollisionFilter : public btOverlapFilterCallback
+{
+public:
+	bool needBroadphaseCollision(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1) const override;
+};
+
+class SMI_Collision
+{
+public:
 	//constructors and destructors
 	SMI_Collision();
+	SMI_Collision(entt::entity _b1, entt::entity _b2, SMI_ContactEvent _Event, int _Layer1 = 0, int _Layer2 = 0);
 	~SMI_Collision() = default;
 
-	//getters and setters
-	void setB1(const entt::entity& _b1) { b1 = _b1; }
+	//getters
 	entt::entity getB1() const { return b1; }
-	void setB2(const entt::entity& _b2) { b2 = _b2; }
 	entt::entity getB2() const { return b2; }
+	int getLayer1() const { return Layer1; }
+	int getLayer2() const { return Layer2; }
+	SMI_ContactEvent getEvent() const { return Event; }
+	uint64_t getKey() const { return Key; }
+
+	//gets a key for a pair of entities that is the same no matter which order they're given in (no repeats collisions)
+	static uint64_t PairKey(entt::entity _b1, entt::entity _b2)
+	{
+		uint64_t first = static_cast<uint32_t>(_b1);
+		uint64_t second = static_cast<uint32_t>(_b2);
+		return first < second ? (first << 32) | second : (second << 32) | first;
+	}
 
-	//Checks collisions to see if they're caused by the same two objects (no repeats collisions)
-	static bool Same(sptr C1, sptr C2) { return ((C1->b1 == C2->b1 && C1->b2 == C2->b2) || (C1->b1 == C2->b2 && C1->b2 == C2->b1)); }
+	//Checks collisions to see if they're caused by the same two objects
+	static bool Same(const SMI_Collision& C1, const SMI_Collision& C2) { return C1.Key == C2.Key; }
 
 private:
-	//used to define the space and two objects involved in a collision
+	//used to define the two objects involved in a collision
 	entt::entity b1;
 	entt::entity b2;
+	//the collision layers of the two objects
+	int Layer1;
+	int Layer2;
+	SMI_ContactEvent Event;
+	uint64_t Key;
 };
@@ -0,0 +1,104 @@
+#include "PhysicsTaskScheduler.h"
+
+#include <algorithm>
+#include <vector>
+#include <thread>
+
+// Set on our worker threads while they run a chunk. Bullet can start a loop from inside another one, and waiting on
+// the pool from one of its own workers would never return, so those loops are just run on the spot
+static thread_local bool inWorker = false;
+
+PhysicsTaskScheduler::PhysicsTaskScheduler(uint32_t numThreads) :
+	btITaskScheduler("PhysicsTaskScheduler"),
+	_workers(nullptr),
+	_numThreads(1)
+{
+	if (numThreads == 0) {
+		numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	setNumThreads(static_cast<int>(numThreads));
+}
+
+PhysicsTaskScheduler* PhysicsTaskScheduler::GetDefault()
+{
+	static PhysicsTaskScheduler scheduler;
+	return &scheduler;
+}
+
+void PhysicsTaskScheduler::setNumThreads(int numThreads)
+{
+	numThreads = std::max(1, std::min(numThreads, getMaxNumThreads()));
+	if (numThreads == _numThreads && _workers != nullptr) {
+		return;
+	}
+
+	// The thread that calls into Bullet does some of the work, so we only need workers for the rest
+	_numThreads = numThreads;
+	_workers = numThreads > 1 ? ThreadPool::Create(static_cast<uint32_t>(numThreads - 1)) : nullptr;
+}
+
+void PhysicsTaskScheduler::parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body)
+{
+	int chunkSize = 0;
+	int chunks = _GetChunks(iEnd - iBegin, grainSize, chunkSize);
+	if (chunks <= 1) {
+		body.forLoop(iBegin, iEnd);
+		return;
+	}
+
+	for (int chunk = 1; chunk < chunks; chunk++) {
+		int begin = iBegin + chunk * chunkSize;
+		int end = std::min(begin + chunkSize, iEnd);
+		_workers->Enqueue([&body, begin, end]() {
+			inWorker = true;
+			body.forLoop(begin, end);
+			inWorker = false;
+		});
+	}
+	body.forLoop(iBegin, std::min(iBegin + chunkSize, iEnd));
+	_workers->Wait();
+}
+
+btScalar PhysicsTaskScheduler::parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body)
+{
+	int chunkSize = 0;
+	int chunks = _GetChunks(iEnd - iBegin, grainSize, chunkSize);
+	if (chunks <= 1) {
+		return body.sumLoop(iBegin, iEnd);
+	}
+
+	// Each chunk writes to its own slot, and they're added up in order so the result doesn't depend on timing
+	std::vector<btScalar> sums(chunks, btScalar(0));
+	for (int chunk = 1; chunk < chunks; chunk++) {
+		int begin = iBegin + chunk * chunkSize;
+		int end = std::min(begin + chunkSize, iEnd);
+		btScalar* result = &sums[chunk];
+		_workers->Enqueue([&body, begin, end, result]() {
+			inWorker = true;
+			*result = body.sumLoop(begin, end);
+			inWorker = false;
+		});
+	}
+	sums[0] = body.sumLoop(iBegin, std::min(iBegin + chunkSize, iEnd));
+	_workers->Wait();
+
+	btScalar total = btScalar(0);
+	for (btScalar sum : sums) {
+		total += sum;
+	}
+	return total;
+}
+
+int PhysicsTaskScheduler::_GetChunks(int count, int grainSize, int& chunkSize) const
+{
+	if (_workers == nullptr || inWorker || count <= 0) {
+		chunkSize = count;
+		return 1;
+	}
+
+	// Never split finer than Bullet asked for, small loops aren't worth waking the workers for
+	grainSize = std::max(grainSize, 1);
+	int chunks = std::min(_numThreads, (count + grainSize - 1) / grainSize);
+	chunkSize = (count + chunks - 1) / chunks;
+	return (count + chunkSize - 1) / chunkSize;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include "LinearMath/btThreads.h"
+#include "Utils/ThreadPool.h"
+
+/// <summary>
+/// Runs Bullet's parallel loops on our own ThreadPool, so the multithreaded physics world doesn't need Bullet's Win32
+/// or OpenMP schedulers. Each loop is split into one chunk per thread, the calling thread works on the first chunk
+/// while the workers take the rest, and the call returns once every chunk is done.
+///
+/// The chunks only depend on the size of the loop and the number of threads, and sums are added up in chunk order, so
+/// the same work on the same number of threads always produces the same results
+/// </summary>
+class PhysicsTaskScheduler : public btITaskScheduler
+{
+public:
+	/// <summary>
+	/// Creates a new scheduler
+	/// </summary>
+	/// <param name="numThreads">The number of threads to run loops on, including the one that calls into Bullet, or 0 to use one per core</param>
+	PhysicsTaskScheduler(uint32_t numThreads = 0);
+	~PhysicsTaskScheduler() override = default;
+
+	/// <summary>
+	/// Gets the scheduler that scenes use when they aren't given one
+	/// </summary>
+	static PhysicsTaskScheduler* GetDefault();
+
+	int getMaxNumThreads() const override { return BT_MAX_THREAD_COUNT; }
+	int getNumThreads() const override { return _numThreads; }
+	/// <summary>
+	/// Changes the number of threads loops are run on, this restarts the worker threads so don't call it mid step
+	/// </summary>
+	void setNumThreads(int numThreads) override;
+
+	void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) override;
+	btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) override;
+
+protected:
+	ThreadPool::Sptr _workers;
+	int _numThreads;
+
+	// Works out how many chunks to split a loop into, and how big each one is
+	int _GetChunks(int count, int grainSize, int& chunkSize) const;
+};
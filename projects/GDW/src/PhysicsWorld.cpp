@@ -0,0 +1,74 @@
+#include "PhysicsWorld.h"
+#include "PhysicsTaskScheduler.h"
+#include "Logging.h"
+
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
+#include "BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h"
+#include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h"
+
+SMI_PhysicsWorld::SMI_PhysicsWorld(const SMI_PhysicsSettings& _Settings)
+{
+    Settings = _Settings;
+    CollisionConfig = new btDefaultCollisionConfiguration(); //default collision config
+    OverlappingPairCache = new btDbvtBroadphase();//basic board phase
+#if !BT_THREADSAFE
+    //the Bullet libraries in dependencies/bullet3 are built without BT_THREADSAFE, so btParallelFor never reaches our
+    //scheduler and Bullet's mutexes do nothing. The Mt world would run on one thread at best and race at worst
+    if (Settings.Multithreaded)
+    {
+        LOG_ERROR("Multithreaded physics needs Bullet built with BT_THREADSAFE=1, using the single threaded world instead");
+        Settings.Multithreaded = false;
+    }
+#endif
+    if (Settings.Multithreaded)
+    {
+        //Bullet's parallel loops go through one global scheduler, which has to be set before any of the Mt classes are made
+        btITaskScheduler* scheduler = Settings.TaskScheduler;
+        if (scheduler == nullptr)
+        {
+            scheduler = PhysicsTaskScheduler::GetDefault();
+        }
+        if (Settings.NumThreads != 0)
+        {
+            scheduler->setNumThreads(static_cast<int>(Settings.NumThreads));
+        }
+        btSetTaskScheduler(scheduler);
+
+        if (Settings.ParallelCollision)
+        {
+            Dispatcher = new btCollisionDispatcherMt(CollisionConfig);
+        }
+        else
+        {
+            Dispatcher = new btCollisionDispatcher(CollisionConfig);
+        }
+        //one solver per thread so islands can be solved at the same time, and one that splits up big islands
+        btConstraintSolverPoolMt* solverPool = new btConstraintSolverPoolMt(scheduler->getNumThreads());
+        Solver = solverPool;
+        SolverMt = new btSequentialImpulseConstraintSolverMt();
+
+        //create the physics world
+        World = new btDiscreteDynamicsWorldMt(Dispatcher, OverlappingPairCache, solverPool, SolverMt, CollisionConfig);
+        LOG_INFO("Multithreaded physics world on {} threads using {}", scheduler->getNumThreads(), scheduler->getName());
+    }
+    else
+    {
+        Dispatcher = new btCollisionDispatcher(CollisionConfig); //default collision dispatcher
+        Solver = new btSequentialImpulseConstraintSolver;//default collision solver
+        SolverMt = nullptr;
+
+        //create the physics world
+        World = new btDiscreteDynamicsWorld(Dispatcher, OverlappingPairCache, Solver, CollisionConfig);
+    }
+}
+
+SMI_PhysicsWorld::~SMI_PhysicsWorld()
+{
+    //delete the physics world and it's attributes
+    delete World;
+    delete SolverMt;
+    delete Solver;
+    delete OverlappingPairCache;
+    delete Dispatcher;
+    delete CollisionConfig;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "btBulletDynamicsCommon.h"
+#include "LinearMath/btThreads.h"
+#include <cstdint>
+
+//how a scene's physics world is set up
+struct SMI_PhysicsSettings
+{
+	//use Bullet's multithreaded world, which solves islands and moves bodies on several threads at once. This needs
+	//Bullet built with BT_THREADSAFE=1 and BT_THREADSAFE defined for the project, otherwise the scene logs an error and
+	//uses the single threaded world (getPhysicsSettings shows which one it got)
+	bool Multithreaded = false;
+	//the number of threads to use, including the one that updates the scene, 0 leaves the scheduler as it is (one
+	//thread per core by default). Bullet only has one scheduler for the whole program, so this affects every scene
+	uint32_t NumThreads = 0;
+	//find contacts on the worker threads too. The order contacts are found in then depends on timing, so two runs of the
+	//same scene can drift apart, leave this off when the results need to be the same every time
+	bool ParallelCollision = false;
+	//the scheduler that runs Bullet's parallel loops, a PhysicsTaskScheduler is used if this is null. It must outlive
+	//the scene
+	btITaskScheduler* TaskScheduler = nullptr;
+};
+
+//the Bullet world a scene steps, along with the collision config, broadphase, dispatcher and solvers that go with it.
+//It's kept out of SMI_Scene so a world can be set up without a window or OpenGL (ex: by the physics benchmarks)
+class SMI_PhysicsWorld
+{
+public:
+	SMI_PhysicsWorld(const SMI_PhysicsSettings& _Settings = SMI_PhysicsSettings());
+
+	//the world holds pointers to the other parts, so it can't be copied
+	SMI_PhysicsWorld(const SMI_PhysicsWorld&) = delete;
+	SMI_PhysicsWorld& operator=(const SMI_PhysicsWorld&) = delete;
+
+	//deletes the world and its parts, anything still in the world has to be removed and deleted by its owner first
+	~SMI_PhysicsWorld();
+
+	btDiscreteDynamicsWorld* getWorld() const { return World; }
+	//the settings the world was made with, Multithreaded is off if Bullet can't run the multithreaded world
+	const SMI_PhysicsSettings& getSettings() const { return Settings; }
+
+private:
+	SMI_PhysicsSettings Settings;
+	btDefaultCollisionConfiguration* CollisionConfig;
+	btCollisionDispatcher* Dispatcher;
+	btBroadphaseInterface* OverlappingPairCache;
+	btConstraintSolver* Solver;
+	//multithreaded worlds hand small islands to a pool of solvers (Solver), and big ones to this
+	btConstraintSolver* SolverMt;
+	btDiscreteDynamicsWorld* World;
+};
@@ -4,6 +4,7 @@ Renderer::Renderer()
 {
 	m_Material = nullptr;
 	m_VAO = nullptr;
+	m_BoundsDirty = true;
 }
 
 Renderer::Renderer(SMI_Material::Sptr _mat, VertexArrayObject::Sptr _vao)
@@ -12,6 +13,12 @@ Renderer::Renderer(SMI_Material::Sptr _mat, VertexArrayObject::Sptr _vao)
 	setVAO(_vao);
 }
 
+void Renderer::updateWorldBounds(const glm::mat4& _world)
+{
+	m_WorldBounds = m_VAO != nullptr ? m_VAO->GetBounds().Transformed(_world) : Bounds();
+	m_BoundsDirty = false;
+}
+
 void Renderer::Render()
 {
 	if (m_Material != nullptr && m_VAO != nullptr)
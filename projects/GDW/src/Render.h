@@ -14,11 +14,16 @@ public:
 
 	//setters
 	void setMaterial(SMI_Material::Sptr _material) { m_Material = _material; }
-	void setVAO(VertexArrayObject::Sptr _vao) { m_VAO = _vao; }
+	void setVAO(VertexArrayObject::Sptr _vao) { m_VAO = _vao; m_BoundsDirty = true; }
+	//recalculates the world space bounds of the mesh, called by the scene whenever the object moves
+	void updateWorldBounds(const glm::mat4& _world);
 
 	//getters
 	SMI_Material::Sptr getMaterial() const { return m_Material; }
 	VertexArrayObject::Sptr getVAO() const { return m_VAO; }
+	const Bounds& getWorldBounds() const { return m_WorldBounds; }
+	//true if the mesh has changed since the world bounds were last calculated
+	bool getBoundsDirty() const { return m_BoundsDirty; }
 
 	//destructor
 	~Renderer();
@@ -26,5 +31,7 @@ public:
 private:
 	SMI_Material::Sptr m_Material;
 	VertexArrayObject::Sptr m_VAO;
+	Bounds m_WorldBounds;
+	bool m_BoundsDirty;
 
 };
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <cstring>
+#include "GLM/gtc/matrix_access.hpp"
+
+VertexBuffer::Sptr RenderQueue::__instanceBuffer = nullptr;
+
+// The per-instance model matrix, as four vec4 columns in slots 4-7 (see vertex_shader_instanced.glsl)
+const std::vector<BufferAttribute> RenderQueue::__instanceLayout = {
+	BufferAttribute(4, 4, AttributeType::Float, sizeof(glm::mat4), 0 * sizeof(glm::vec4), AttribUsage::User0),
+	BufferAttribute(5, 4, AttributeType::Float, sizeof(glm::mat4), 1 * sizeof(glm::vec4), AttribUsage::User1),
+	BufferAttribute(6, 4, AttributeType::Float, sizeof(glm::mat4), 2 * sizeof(glm::vec4), AttribUsage::User2),
+	BufferAttribute(7, 4, AttributeType::Float, sizeof(glm::mat4), 3 * sizeof(glm::vec4), AttribUsage::User3)
+};
+
+// We track which texture is in each of the first 32 slots, textures in higher slots are always bound
+static const int MAX_TRACKED_SLOTS = 32;
+
+RenderQueue::RenderQueue() :
+	_packets(std::vector<Packet>()),
+	_draws(std::vector<Draw>()),
+	_instanceData(std::vector<glm::mat4>()),
+	_depthPlane(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)),
+	_stats(Stats())
+{ }
+
+void RenderQueue::Begin(const glm::mat4& viewProjection)
+{
+	_packets.clear();
+
+	// Clip space w is the distance in front of the camera for a perspective projection, but always 1 for an
+	// orthographic one (its bottom row stays 0, 0, 0, 1 through the view matrix). There we sort by clip space z
+	// instead, shifted from -1..1 to 0..2 since MakeKey only keeps positive depths
+	glm::vec4 wRow = glm::row(viewProjection, 3);
+	if (wRow.x == 0.0f && wRow.y == 0.0f && wRow.z == 0.0f) {
+		_depthPlane = glm::row(viewProjection, 2) + glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	} else {
+		_depthPlane = wRow;
+	}
+}
+
+void RenderQueue::PushObject(SMI_Material* material, VertexArrayObject* vao, const glm::mat4& model, Pass pass)
+{
+	Shader* shader = material->getShader().get();
+
+	Packet packet;
+	packet.Instanced = shader->GetInstancedVariant() != nullptr && material->canInstance();
+	packet.Program = packet.Instanced ? shader->GetInstancedVariant().get() : shader;
+	packet.Material = material;
+	packet.Vao = vao;
+	packet.Model = model;
+	packet.Key = _GetKey(material, packet.Program, vao, glm::vec3(model[3]), pass);
+	_packets.push_back(packet);
+}
+
+void RenderQueue::Submit()
+{
+	_stats = Stats();
+	_stats.Packets = static_cast<uint32_t>(_packets.size());
+	if (_packets.empty()) {
+		return;
+	}
+
+	std::sort(_packets.begin(), _packets.end(), [](const Packet& a, const Packet& b) {
+		return a.Key < b.Key;
+	});
+	_BuildDraws();
+
+	// Upload all the instance data for the frame in one go, and make sure every instanced mesh reads from it. We do
+	// this before drawing anything since attaching the buffer will change the bound VAO
+	if (!_instanceData.empty()) {
+		if (__instanceBuffer == nullptr) {
+			__instanceBuffer = VertexBuffer::Create(BufferUsage::StreamDraw);
+		}
+		__instanceBuffer->LoadData(_instanceData.data(), _instanceData.size());
+
+		for (const Draw& draw : _draws) {
+			if (draw.Instanced) {
+				_packets[draw.First].Vao->SetInstanceBuffer(__instanceBuffer, __instanceLayout);
+			}
+		}
+	}
+
+	Shader* boundShader = nullptr;
+	VertexArrayObject* boundVao = nullptr;
+	ITexture* boundTextures[MAX_TRACKED_SLOTS];
+	std::memset(boundTextures, 0, sizeof(boundTextures));
+	uint32_t boundSlots = 0;
+
+	for (const Draw& draw : _draws) {
+		const Packet& packet = _packets[draw.First];
+		if (packet.Program != boundShader) {
+			packet.Program->Bind();
+			boundShader = packet.Program;
+			_stats.ShaderBinds++;
+		} else {
+			_stats.ShaderBindsElided++;
+		}
+
+		// Bind the material's textures, skipping the slots that already hold the right one
+		uint32_t usedSlots = 0;
+		for (const auto& texture : packet.Material->getTextures()) {
+			int slot = texture.first;
+			if (slot >= 0 && slot < MAX_TRACKED_SLOTS) {
+				usedSlots |= 1u << slot;
+				if (boundTextures[slot] == texture.second.get()) {
+					_stats.TextureBindsElided++;
+					continue;
+				}
+				boundTextures[slot] = texture.second.get();
+			}
+			texture.second->Bind(slot);
+			_stats.TextureBinds++;
+		}
+		// Anything the last material had bound that this one doesn't use gets unbound, so it samples the same as before
+		uint32_t staleSlots = boundSlots & ~usedSlots;
+		for (int slot = 0; staleSlots != 0; slot++, staleSlots >>= 1) {
+			if (staleSlots & 1) {
+				ITexture::Unbind(slot);
+				boundTextures[slot] = nullptr;
+			}
+		}
+		boundSlots = usedSlots;
+
+		if (!draw.Instanced) {
+			packet.Material->setModelMatrix(packet.Model);
+			packet.Material->BindAllUniform();
+		}
+
+		if (packet.Vao != boundVao) {
+			packet.Vao->Bind();
+			boundVao = packet.Vao;
+			_stats.VaoBinds++;
+		} else {
+			_stats.VaoBindsElided++;
+		}
+
+		if (!draw.Instanced) {
+			packet.Vao->DrawBound();
+		} else {
+			packet.Vao->DrawInstancedBound(draw.Count, draw.BaseInstance);
+		}
+	}
+
+	// Leave things the way Renderer::Render would have
+	for (int slot = 0; boundSlots != 0; slot++, boundSlots >>= 1) {
+		if (boundSlots & 1) {
+			ITexture::Unbind(slot);
+		}
+	}
+	Shader::Unbind();
+	VertexArrayObject::Unbind();
+}
+
+uint64_t RenderQueue::MakeKey(Pass pass, uint32_t shader, uint32_t textureSet, uint32_t vao, float depth)
+{
+	// Positive floats sort the same way as their bits do, so the top 16 bits make a cheap depth that works at any scale
+	uint32_t depthBits = 0;
+	if (depth > 0.0f) {
+		std::memcpy(&depthBits, &depth, sizeof(float));
+	}
+
+	return (static_cast<uint64_t>(pass) & 0xF) << 60 |
+		(static_cast<uint64_t>(shader) & 0xFFF) << 48 |
+		(static_cast<uint64_t>(textureSet) & 0xFFFF) << 32 |
+		(static_cast<uint64_t>(vao) & 0xFFFF) << 16 |
+		static_cast<uint64_t>(depthBits >> 16);
+}
+
+void RenderQueue::_BuildDraws()
+{
+	_draws.clear();
+	_instanceData.clear();
+	for (size_t ix = 0; ix < _packets.size(); ) {
+		const Packet& first = _packets[ix];
+
+		// Sorting put everything with the same shader, textures and mesh next to each other, so the run ends as soon as
+		// one of them changes (or the texture set hash collided and the textures don't actually match)
+		size_t end = ix + 1;
+		if (first.Instanced) {
+			while (end < _packets.size()) {
+				const Packet& next = _packets[end];
+				if (!next.Instanced || next.Program != first.Program || next.Vao != first.Vao ||
+					!next.Material->hasSameTextures(*first.Material)) {
+					break;
+				}
+				end++;
+			}
+		}
+
+		Draw draw = { static_cast<uint32_t>(ix), static_cast<uint32_t>(end - ix), static_cast<uint32_t>(_instanceData.size()), first.Instanced };
+		if (draw.Instanced) {
+			for (size_t packet = ix; packet < end; packet++) {
+				_instanceData.push_back(_packets[packet].Model);
+			}
+			_stats.InstancedDraws++;
+			_stats.InstancedObjects += draw.Count;
+		}
+		_draws.push_back(draw);
+		ix = end;
+	}
+	_stats.DrawCalls = static_cast<uint32_t>(_draws.size());
+}
+
+uint64_t RenderQueue::_GetKey(SMI_Material* material, Shader* program, VertexArrayObject* vao, const glm::vec3& position, Pass pass) const
+{
+	float depth = glm::dot(_depthPlane, glm::vec4(position, 1.0f));
+	return MakeKey(pass, program->GetHandle(), GetTextureSet(material), vao->GetHandle(), depth);
+}
+
+uint32_t RenderQueue::GetTextureSet(const SMI_Material* material)
+{
+	// The texture map is unordered, so each slot is mixed on its own and the results added up, which doesn't care what
+	// order we visit them in. A collision only puts two sets next to each other, binds are still checked slot by slot
+	uint32_t set = 0;
+	for (const auto& texture : material->getTextures()) {
+		uint32_t handle = texture.second != nullptr ? texture.second->GetHandle() : 0;
+		uint32_t mixed = (handle + 1) * 0x9E3779B1u ^ static_cast<uint32_t>(texture.first) * 0x85EBCA77u;
+		set += mixed ^ (mixed >> 15);
+	}
+	// Fold the top half in, MakeKey only keeps the low 16 bits
+	return set ^ (set >> 16);
+}
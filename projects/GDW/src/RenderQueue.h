@@ -0,0 +1,136 @@
+#pragma once
+#include <vector>
+#include "GLM/glm.hpp"
+#include "Material.h"
+#include "VertexArrayObject.h"
+#include "VertexBuffer.h"
+
+/// <summary>
+/// Collects everything a scene wants to draw in a frame as draw packets, sorts them by a 64 bit key and then submits
+/// them all at once. Because packets that share a shader, textures and mesh end up next to each other, most of the
+/// shader, texture and VAO binds can be skipped, and nothing is unbound until the whole queue has been drawn. Runs of
+/// packets that can be instanced and share all of their state are merged into a single instanced draw call.
+///
+/// From most to least significant, the key holds the pass (4 bits), shader (12 bits), texture set (16 bits), VAO (16
+/// bits) and view depth (16 bits), so within a group of identical state objects are drawn front to back. The shader,
+/// texture and VAO are identified by their OpenGL handles, which are unique while the object is alive and need no
+/// bookkeeping when it's destroyed. The texture set is a hash of every slot the material binds, and depth is the
+/// distance from the camera for perspective projections or the clip space z for orthographic ones
+/// </summary>
+class RenderQueue
+{
+public:
+	/// <summary>
+	/// The passes that packets can be drawn in, lower passes are drawn first
+	/// </summary>
+	enum class Pass : uint8_t {
+		Opaque = 0
+	};
+
+	/// <summary>
+	/// Counters for the last call to Submit. Elided binds are ones that were skipped because the state was already bound
+	/// </summary>
+	struct Stats {
+		uint32_t Packets;
+		uint32_t DrawCalls;
+		// Draw calls that used instancing, and how many packets they covered
+		uint32_t InstancedDraws;
+		uint32_t InstancedObjects;
+		uint32_t ShaderBinds;
+		uint32_t ShaderBindsElided;
+		uint32_t TextureBinds;
+		uint32_t TextureBindsElided;
+		uint32_t VaoBinds;
+		uint32_t VaoBindsElided;
+	};
+
+	RenderQueue();
+	~RenderQueue() = default;
+
+	/// <summary>
+	/// Removes all packets from the queue, and sets the view projection matrix used to sort the next packets by depth.
+	/// Orthographic projections are detected from the matrix itself
+	/// </summary>
+	void Begin(const glm::mat4& viewProjection);
+
+	/// <summary>
+	/// Queues an object. If its material can be instanced (see SMI_Material::canInstance) and its shader has an
+	/// instanced variant, it's drawn with the instanced variant even when nothing ends up sharing its draw call, so its
+	/// key doesn't depend on how many others it gets batched with. Otherwise it's drawn on its own with its Model
+	/// uniform set
+	/// </summary>
+	/// <param name="material">The material to draw with, must stay alive until Submit</param>
+	/// <param name="vao">The mesh to draw, must stay alive until Submit</param>
+	/// <param name="model">The object's model matrix</param>
+	/// <param name="pass">The pass to draw the object in</param>
+	void PushObject(SMI_Material* material, VertexArrayObject* vao, const glm::mat4& model, Pass pass = Pass::Opaque);
+
+	/// <summary>
+	/// Sorts and draws everything in the queue, then unbinds any state it left bound
+	/// </summary>
+	void Submit();
+
+	/// <summary>
+	/// Gets the counters for the last call to Submit
+	/// </summary>
+	const Stats& GetStats() const { return _stats; }
+
+	/// <summary>
+	/// Builds a sort key from its parts, ids that are too large for their field wrap around (which only affects the
+	/// order packets are drawn in, not what gets bound)
+	/// </summary>
+	static uint64_t MakeKey(Pass pass, uint32_t shader, uint32_t textureSet, uint32_t vao, float depth);
+	/// <summary>
+	/// Hashes the textures a material binds, and the slots they go in, into the texture set field of a sort key.
+	/// Materials that bind the same textures to the same slots always get the same value
+	/// </summary>
+	static uint32_t GetTextureSet(const SMI_Material* material);
+
+protected:
+	struct Packet
+	{
+		uint64_t           Key;
+		Shader*            Program;
+		SMI_Material*      Material;
+		VertexArrayObject* Vao;
+		// True if Program is the instanced variant, so the packet can share a draw call with others like it
+		bool               Instanced;
+		glm::mat4          Model;
+	};
+
+	// A run of sorted packets drawn with a single draw call, or a single packet drawn on its own
+	struct Draw
+	{
+		uint32_t First;
+		uint32_t Count;
+		uint32_t BaseInstance;
+		bool     Instanced;
+	};
+
+	std::vector<Packet>    _packets;
+	std::vector<Draw>      _draws;
+	std::vector<glm::mat4> _instanceData;
+	// Dotted with a world space position to get the depth packets are sorted by, see Begin
+	glm::vec4              _depthPlane;
+	Stats                  _stats;
+
+	/// <summary>
+	/// Gets the key a packet is sorted by, this is the only place keys are built
+	/// </summary>
+	/// <param name="material">The material the packet is drawn with</param>
+	/// <param name="program">The shader the packet is drawn with, the instanced variant for instanced packets</param>
+	/// <param name="vao">The mesh to draw</param>
+	/// <param name="position">The world space position used for depth sorting</param>
+	/// <param name="pass">The pass the packet is drawn in</param>
+	uint64_t _GetKey(SMI_Material* material, Shader* program, VertexArrayObject* vao, const glm::vec3& position, Pass pass) const;
+	/// <summary>
+	/// Merges the sorted packets into draws, and gathers the model matrices of the instanced ones
+	/// </summary>
+	void _BuildDraws();
+
+
+	// Holds the model matrices for instanced packets. This is shared by every queue, since the VAOs it gets attached
+	// to come from the mesh cache and can be shared between scenes too
+	static VertexBuffer::Sptr __instanceBuffer;
+	static const std::vector<BufferAttribute> __instanceLayout;
+};
@@ -1,23 +1,43 @@
 #include "Scene.h"
+#include "Logging.h"
 
-SMI_Scene::SMI_Scene()
+#include <algorithm>
+#include <cmath>
+
+static inline glm::vec3 ToGlm(const btVector3& vec)
+{
+    return glm::vec3(vec.getX(), vec.getY(), vec.getZ());
+}
+
+static inline glm::quat ToGlm(const btQuaternion& quat)
+{
+    return glm::quat(quat.getW(), quat.getX(), quat.getY(), quat.getZ());
+}
+
+SMI_Scene::SMI_Scene(const SMI_PhysicsSettings& _physicsSettings)
+    : physics(_physicsSettings)
 {
     //scene is active and not paused
 	isActive = true;
 	isPaused = false;
+    hierarchyDirty = false;
 
     //setting up physics world
-    CollisionConfig = new btDefaultCollisionConfiguration(); //default collision config
-    Dispatcher = new btCollisionDispatcher(CollisionConfig); //default collision dispatcher
-    OverlappingPairCache = new btDbvtBroadphase();//basic board phase
-    Solver = new btSequentialImpulseConstraintSolver;//default collision solver
-    Collisions = std::vector<SMI_Collision::sptr>();
-
-    //create the physics world
-    physicsWorld = new btDiscreteDynamicsWorld(Dispatcher, OverlappingPairCache, Solver, CollisionConfig);
+    physicsWorld = physics.getWorld();
+    motionQueue = std::make_unique<SMI_MotionQueue>();
     physicsWorld->setGravity(btVector3(0.f, 0.f, 0.f));
+    //use collision layers to decide which pairs the broadphase reports
+    physicsWorld->getPairCache()->setOverlapFilterCallback(&collisionFilter);
+    collisionHandlerTable.fill(-1);
     gravity = glm::vec3(0.0, 0.0, 0.0);
 
+    //step physics at 60hz, catching up at most 8 steps (down to 7.5 fps) and a quarter second in a frame
+    fixedTimeStep = 1.f / 60.f;
+    maxSubSteps = 8;
+    maxFrameTime = 0.25f;
+    accumulator = 0.f;
+    physicsStats = PhysicsStats();
+
     //create registry
     Store = entt::registry();
     camera = nullptr;
@@ -45,13 +65,7 @@ SMI_Scene::~SMI_Scene()
         //and delete it
         delete PhyObject;
     }
-
-    //delete the physics world and it's attributes
-    delete physicsWorld;
-    delete Solver;
-    delete OverlappingPairCache;
-    delete Dispatcher;
-    delete CollisionConfig;
+    //the physics world and it's attributes are deleted along with physics
 }
 
 entt::entity SMI_Scene::CreateEntity()
@@ -64,12 +78,23 @@ void SMI_Scene::DeleteEntity(entt::entity target)
     if (Store.has<SMI_Physics>(target))
     {
         btRigidBody* TargetBody = Store.get<SMI_Physics>(target).getRigidBody();
+        WakeTouching(TargetBody);
         delete TargetBody->getMotionState();
-        delete TargetBody->getCollisionShape();
         physicsWorld->removeRigidBody(TargetBody);
         delete TargetBody;
     }
 
+    //any children will be turned into roots during the next update
+    if (Store.has<SMI_Transform>(target))
+    {
+        hierarchyDirty = true;
+    }
+
+    if (Store.has<SpatialProxy>(target))
+    {
+        spatialIndex.Remove(Store.get<SpatialProxy>(target).Proxy);
+    }
+
     Store.destroy(target);
 }
 
@@ -82,78 +107,416 @@ void SMI_Scene::Update(float deltaTime)
 {
     if (!isPaused)
     {
-        physicsWorld->stepSimulation(deltaTime);
-        
-        //creating view for physics
-        auto PhysicsView = Store.view<SMI_Physics>();
-        for (auto entity : PhysicsView)
+        physicsStats.SubSteps = 0;
+        physicsStats.TimeDropped = 0.f;
+
+        //a long frame would take so many steps to catch up on that the next frame would be even longer, so we only
+        //simulate so much of it
+        if (deltaTime > maxFrameTime)
+        {
+            physicsStats.TimeDropped += deltaTime - maxFrameTime;
+            deltaTime = maxFrameTime;
+        }
+        accumulator += deltaTime;
+
+        while (accumulator >= fixedTimeStep && physicsStats.SubSteps < static_cast<uint32_t>(maxSubSteps))
+        {
+            //no substeps, we've already split the time into fixed steps ourselves
+            motionQueue->Step++;
+            FixedUpdate(fixedTimeStep);
+            UpdateKinematics();
+            physicsWorld->stepSimulation(fixedTimeStep, 0);
+
+            //contacts are collected after every step, so short touches between steps aren't missed
+            CollisionManage();
+
+            accumulator -= fixedTimeStep;
+            physicsStats.SubSteps++;
+        }
+
+        //if we're still behind, drop the whole steps we couldn't get to and keep the part of a step that's left
+        if (accumulator >= fixedTimeStep)
+        {
+            float behind = accumulator - std::fmod(accumulator, fixedTimeStep);
+            physicsStats.TimeDropped += behind;
+            accumulator -= behind;
+        }
+
+        physicsStats.Alpha = accumulator / fixedTimeStep;
+        physicsStats.TotalSubSteps += physicsStats.SubSteps;
+        physicsStats.TotalTimeDropped += physicsStats.TimeDropped;
+
+        //only bodies that have moved are in the queue, everything else already has the right transform. The time left
+        //over is part of the way to the next step, so moving bodies are drawn that far past the last step
+        std::vector<entt::entity>& moved = motionQueue->Moved;
+        for (size_t ix = 0; ix < moved.size(); )
+        {
+            entt::entity entity = moved[ix];
+            if (!Store.valid(entity) || !Store.has<SMI_Physics>(entity))
+            {
+                moved[ix] = moved.back();
+                moved.pop_back();
+                continue;
+            }
+
+            SMI_MotionState* state = GetComponent<SMI_Physics>(entity).getMotionState();
+            bool moving = state->Settle();
+
+            SMI_Transform* trans = Store.try_get<SMI_Transform>(entity);
+            if (trans != nullptr)
+            {
+                const btTransform& previous = state->getPrevious();
+                const btTransform& current = state->getCurrent();
+                glm::quat previousRot = ToGlm(previous.getRotation());
+                glm::quat currentRot = ToGlm(current.getRotation());
+
+                //the model can be turned differently from its body, so we keep whatever difference there was when we
+                //first saw it
+                PhysicsState* physState = Store.try_get<PhysicsState>(entity);
+                if (physState == nullptr)
+                {
+                    physState = &Store.emplace<PhysicsState>(entity, PhysicsState{ glm::inverse(currentRot) * trans->getRot(), currentRot });
+                }
+
+                //blending two equal values can still come out an ULP off, so they're only blended if they differ
+                glm::vec3 previousPos = ToGlm(previous.getOrigin());
+                glm::vec3 currentPos = ToGlm(current.getOrigin());
+                glm::vec3 pos = previousPos == currentPos ? currentPos : glm::mix(previousPos, currentPos, physicsStats.Alpha);
+                if (pos != trans->getPos())
+                {
+                    trans->setPos(pos);
+                }
+                //the rotation is left alone unless the body turned, so bodies that are only ever moved don't undo
+                //anything that spins their transform
+                glm::quat rot = previousRot == currentRot ? currentRot : glm::slerp(previousRot, currentRot, physicsStats.Alpha);
+                if (rot != physState->BodyRotation)
+                {
+                    trans->setRot(rot * physState->RotationOffset);
+                    physState->BodyRotation = rot;
+                }
+            }
+
+            if (moving)
+            {
+                ix++;
+            }
+            else
+            {
+                moved[ix] = moved.back();
+                moved.pop_back();
+            }
+        }
+    }
+}
+
+void SMI_Scene::setParent(entt::entity child, entt::entity parent)
+{
+    LOG_ASSERT(Store.has<SMI_Transform>(child), "Child must have a transform!");
+    LOG_ASSERT(parent == entt::null || Store.has<SMI_Transform>(parent), "Parent must have a transform!");
+
+    //walk up from the new parent, if we find the child along the way this would make a loop
+    for (entt::entity ancestor = parent; ancestor != entt::null; ancestor = Store.get<SMI_Transform>(ancestor).Parent)
+    {
+        if (ancestor == child)
         {
-            SMI_Physics& phys = GetComponent<SMI_Physics>(entity);
-            phys.getRigidBody()->setActivationState(true);
+            LOG_WARN("Cannot parent an object to one of its own children, ignoring");
+            return;
+        }
+        if (!Store.valid(ancestor) || !Store.has<SMI_Transform>(ancestor))
+        {
+            break;
+        }
+    }
+
+    SMI_Transform& trans = Store.get<SMI_Transform>(child);
+    trans.Parent = parent;
+    trans.Dirty = true;
+    hierarchyDirty = true;
+}
+
+void SMI_Scene::setGravity(const glm::vec3& _gravity)
+{
+    //Bullet hands this to every body that hasn't had its gravity turned off
+    gravity = _gravity;
+    physicsWorld->setGravity(btVector3(gravity.x, gravity.y, gravity.z));
+}
+
+void SMI_Scene::UpdateTransforms()
+{
+    auto TransView = Store.view<SMI_Transform>();
+
+    //adding or removing transforms moves others around in the pool, so make sure parents still come first
+    if (!hierarchyDirty)
+    {
+        uint32_t lastDepth = 0;
+        for (auto entity : TransView)
+        {
+            uint32_t depth = TransView.get(entity).Depth;
+            if (depth < lastDepth)
+            {
+                hierarchyDirty = true;
+                break;
+            }
+            lastDepth = depth;
+        }
+    }
+    if (hierarchyDirty)
+    {
+        SortTransforms();
+    }
+
+    //parents are always updated before their children, so one pass is enough to find everything that changed
+    changedTransforms.clear();
+    for (auto entity : TransView)
+    {
+        SMI_Transform& trans = TransView.get(entity);
 
-            //set gravity value
-            if (phys.getHasGravity())
+        const SMI_Transform* parent = nullptr;
+        if (trans.Parent != entt::null)
+        {
+            if (Store.valid(trans.Parent) && Store.has<SMI_Transform>(trans.Parent))
             {
-                phys.getRigidBody()->setGravity(btVector3(gravity.x, gravity.y, gravity.z));
+                parent = &TransView.get(trans.Parent);
             }
             else
             {
-                phys.getRigidBody()->setGravity(btVector3(0.f, 0.f, 0.f));
+                //our parent was deleted, so we're a root now
+                trans.Parent = entt::null;
+                trans.Dirty = true;
             }
+        }
 
-            phys.Update(deltaTime);
+        trans.Changed = trans.Dirty || (parent != nullptr && parent->Changed);
+        if (trans.Changed)
+        {
+            changedTransforms.push_back(&trans);
         }
+        trans.Dirty = false;
+    }
 
-        CollisionManage();
+    //then the world matrices are built in batches, one level of the hierarchy at a time so that every parent is done
+    //before its children read it
+    transformPositions.resize(changedTransforms.size());
+    transformRotations.resize(changedTransforms.size());
+    transformScales.resize(changedTransforms.size());
+    transformParents.resize(changedTransforms.size());
+    transformOutputs.resize(changedTransforms.size());
+    for (size_t ix = 0; ix < changedTransforms.size(); ix++)
+    {
+        SMI_Transform& trans = *changedTransforms[ix];
+        transformPositions[ix] = trans.Pos;
+        transformRotations[ix] = trans.Rot;
+        transformScales[ix] = trans.Scale;
+        transformParents[ix] = trans.Parent != entt::null ? &TransView.get(trans.Parent).Global : nullptr;
+        transformOutputs[ix] = &trans.Global;
+    }
 
-        auto TransPhysView = Store.view<SMI_Physics, SMI_Transform>();
-        for (auto entity : TransPhysView)
+    for (size_t first = 0; first < changedTransforms.size(); )
+    {
+        size_t end = first + 1;
+        while (end < changedTransforms.size() && changedTransforms[end]->Depth == changedTransforms[first]->Depth)
         {
-            SMI_Transform& trans = GetComponent<SMI_Transform>(entity);
-            SMI_Physics& phys = GetComponent<SMI_Physics>(entity);
+            end++;
+        }
+
+        TransformKernel::Compose(&transformPositions[first], &transformRotations[first], &transformScales[first],
+            &transformParents[first], &transformOutputs[first], end - first);
+        first = end;
+    }
 
-            trans.setPos(phys.GetPosition());
+    //anything that moved or changed mesh needs new world space bounds, which are kept in the spatial index
+    auto BoundsView = Store.view<Renderer, SMI_Transform>();
+    for (auto entity : BoundsView)
+    {
+        Renderer& rend = BoundsView.get<Renderer>(entity);
+        const SMI_Transform& trans = BoundsView.get<SMI_Transform>(entity);
+        if (!trans.Changed && !rend.getBoundsDirty())
+        {
+            continue;
+        }
+
+        rend.updateWorldBounds(trans.Global);
+        const Bounds& bounds = rend.getWorldBounds();
+        SpatialProxy* proxy = Store.try_get<SpatialProxy>(entity);
+        if (proxy != nullptr && bounds.IsValid())
+        {
+            spatialIndex.Move(proxy->Proxy, bounds.Min, bounds.Max);
+        }
+        else if (proxy != nullptr)
+        {
+            //objects without bounds can't be culled, so they stay out of the index and are always drawn
+            spatialIndex.Remove(proxy->Proxy);
+            Store.remove<SpatialProxy>(entity);
+        }
+        else if (bounds.IsValid())
+        {
+            Store.emplace<SpatialProxy>(entity, spatialIndex.Insert(bounds.Min, bounds.Max, static_cast<uint32_t>(entity)));
         }
     }
+
+    //anything that has lost its renderer or transform since the last update leaves the index
+    staleProxies.clear();
+    auto ProxyView = Store.view<SpatialProxy>();
+    for (auto entity : ProxyView)
+    {
+        if (!Store.has<Renderer>(entity) || !Store.has<SMI_Transform>(entity))
+        {
+            staleProxies.push_back(entity);
+        }
+    }
+    for (auto entity : staleProxies)
+    {
+        spatialIndex.Remove(ProxyView.get(entity).Proxy);
+        Store.remove<SpatialProxy>(entity);
+    }
+
+    spatialIndex.Optimize();
 }
 
-void SMI_Scene::Render()
+void SMI_Scene::QueryAABB(const glm::vec3& min, const glm::vec3& max, std::vector<entt::entity>& results) const
 {
-    auto RenderView = Store.view<Renderer, SMI_Transform>();
-    for (auto entity : RenderView)
-    {
-        SMI_Transform& trans = GetComponent<SMI_Transform>(entity);
-        Renderer& rend = GetComponent<Renderer>(entity);
+    //the index stores fattened boxes, so we check the real bounds before reporting anything
+    spatialIndex.QueryAABB(min, max, [&](uint32_t data) {
+        entt::entity entity = static_cast<entt::entity>(data);
+        const Bounds& bounds = Store.get<Renderer>(entity).getWorldBounds();
+        if (glm::all(glm::lessThanEqual(bounds.Min, max)) && glm::all(glm::lessThanEqual(min, bounds.Max)))
+        {
+            results.push_back(entity);
+        }
+    });
+}
 
-        UniformMatrixObject<glm::mat4>::Sptr ModelMatrix = std::dynamic_pointer_cast<UniformMatrixObject<glm::mat4>>
-                                                     (rend.getMaterial()->getUniform("Model"));
-        UniformMatrixObject<glm::mat4>::Sptr MVPMatrix = std::dynamic_pointer_cast<UniformMatrixObject<glm::mat4>>
-                                                   (rend.getMaterial()->getUniform("MVP"));
+void SMI_Scene::QuerySphere(const glm::vec3& center, float radius, std::vector<entt::entity>& results) const
+{
+    spatialIndex.QuerySphere(center, radius, [&](uint32_t data) {
+        entt::entity entity = static_cast<entt::entity>(data);
+        const Bounds& bounds = Store.get<Renderer>(entity).getWorldBounds();
+        glm::vec3 offset = glm::clamp(center, bounds.Min, bounds.Max) - center;
+        if (glm::dot(offset, offset) <= radius * radius)
+        {
+            results.push_back(entity);
+        }
+    });
+}
+
+void SMI_Scene::QueryFrustum(const Frustum& frustum, std::vector<entt::entity>& results) const
+{
+    spatialIndex.QueryFrustum(frustum, [&](uint32_t data) {
+        entt::entity entity = static_cast<entt::entity>(data);
+        if (frustum.TestBounds(Store.get<Renderer>(entity).getWorldBounds()))
+        {
+            results.push_back(entity);
+        }
+    });
+}
 
-        //check if nullptr and create uniform if needed
-        if (ModelMatrix == nullptr)
+bool SMI_Scene::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, entt::entity& hit, float& distance) const
+{
+    glm::vec3 invDir = 1.0f / direction;
+    hit = entt::null;
+    spatialIndex.Raycast(origin, direction, maxDistance, [&](uint32_t data, float maxDist) {
+        entt::entity entity = static_cast<entt::entity>(data);
+        const Bounds& bounds = Store.get<Renderer>(entity).getWorldBounds();
+        float entry = 0.0f;
+        if (DynamicBVH::RayAABB(origin, invDir, bounds.Min, bounds.Max, maxDist, entry))
         {
-            ModelMatrix = UniformMatrixObject<glm::mat4>::Create();
-            ModelMatrix->setName("Model");
-            ModelMatrix->setData(glm::mat4());
-            rend.getMaterial()->setUniform(ModelMatrix);
+            hit = entity;
+            distance = entry;
+            return entry;
         }
-        if (MVPMatrix == nullptr)
+        return maxDist;
+    });
+    return hit != entt::null;
+}
+
+void SMI_Scene::SortTransforms()
+{
+    auto TransView = Store.view<SMI_Transform>();
+    for (auto entity : TransView)
+    {
+        SMI_Transform& trans = TransView.get(entity);
+
+        //count how many parents are above us, stopping at any that have been deleted
+        uint32_t depth = 0;
+        for (entt::entity ancestor = trans.Parent; ancestor != entt::null; ancestor = TransView.get(ancestor).Parent)
         {
-            MVPMatrix = UniformMatrixObject<glm::mat4>::Create();
-            MVPMatrix->setName("MVP");
-            MVPMatrix->setData(glm::mat4());
-            rend.getMaterial()->setUniform(MVPMatrix);
+            if (!Store.valid(ancestor) || !Store.has<SMI_Transform>(ancestor))
+            {
+                break;
+            }
+            depth++;
         }
+        trans.Depth = depth;
+    }
+
+    Store.sort<SMI_Transform>([](const SMI_Transform& a, const SMI_Transform& b) {
+        return a.Depth < b.Depth;
+    });
+    hierarchyDirty = false;
+}
+
+void SMI_Scene::Render()
+{
+    UpdateTransforms();
+
+    renderStats = RenderStats();
+    glm::mat4 viewProjection = camera != nullptr ? camera->GetViewProjection() : glm::mat4(1.0f);
+
+    //everything that's the same for every object goes in the Frame block, which is only written once
+    UniformBlocks::FrameData frame = UniformBlocks::FrameData();
+    frame.View = camera != nullptr ? camera->GetView() : glm::mat4(1.0f);
+    frame.Projection = camera != nullptr ? camera->GetProjection() : glm::mat4(1.0f);
+    frame.ViewProjection = viewProjection;
+    frame.CameraPos = glm::vec4(camera != nullptr ? camera->GetPosition() : glm::vec3(0.0f), 1.0f);
+    int lightCount = static_cast<int>(std::min(lights.size(), static_cast<size_t>(UniformBlocks::MAX_LIGHTS)));
+    for (int ix = 0; ix < lightCount; ix++)
+    {
+        frame.LightPos[ix] = glm::vec4(lights[ix].Position, 1.0f);
+        frame.LightColor[ix] = glm::vec4(lights[ix].Color, 1.0f);
+    }
+    frame.LightCount = glm::ivec4(lightCount, 0, 0, 0);
+    UniformBlocks::SetFrameData(frame);
 
-        ModelMatrix->setData(trans.getGlobal());
-        if (camera != nullptr)
+    //find everything that's on screen, the spatial index lets us skip whole groups of objects at once. Objects without
+    //bounds aren't in the index, so they're always drawn
+    visibleEntities.clear();
+    auto RenderView = Store.view<Renderer, SMI_Transform>();
+    if (camera != nullptr)
+    {
+        QueryFrustum(Frustum(viewProjection), visibleEntities);
+        renderStats.CullTested = static_cast<uint32_t>(spatialIndex.GetProxyCount());
+        renderStats.Culled = renderStats.CullTested - static_cast<uint32_t>(visibleEntities.size());
+
+        auto UnboundedView = Store.view<Renderer, SMI_Transform>(entt::exclude<SpatialProxy>);
+        visibleEntities.insert(visibleEntities.end(), UnboundedView.begin(), UnboundedView.end());
+    }
+    else
+    {
+        visibleEntities.insert(visibleEntities.end(), RenderView.begin(), RenderView.end());
+    }
+
+    //hand everything on screen to the render queue, which sorts it, merges whatever can be instanced and skips as
+    //many binds as it can
+    renderQueue.Begin(viewProjection);
+    for (auto entity : visibleEntities)
+    {
+        Renderer& rend = RenderView.get<Renderer>(entity);
+        if (rend.getMaterial() == nullptr || rend.getVAO() == nullptr)
         {
-            MVPMatrix->setData(camera->GetViewProjection() * trans.getGlobal());
+            continue;
         }
 
-        rend.Render();
+        //reload anything the texture budget unloaded now, so that no draw has to wait on the disk
+        renderStats.TexturesReloaded += rend.getMaterial()->makeTexturesResident();
+        renderQueue.PushObject(rend.getMaterial().get(), rend.getVAO().get(), RenderView.get<SMI_Transform>(entity).getGlobal());
+        renderStats.Objects++;
     }
+    renderQueue.Submit();
+
+    const RenderQueue::Stats& queueStats = renderQueue.GetStats();
+    renderStats.DrawCalls = queueStats.DrawCalls;
+    renderStats.InstancedDraws = queueStats.InstancedDraws;
+    renderStats.InstancedObjects = queueStats.InstancedObjects;
 }
 
 void SMI_Scene::PostRender()
@@ -163,45 +526,116 @@ void SMI_Scene::PostRender()
 void SMI_Scene::CollisionManage()
 {
     //based on code from https://andysomogyi.github.io/mechanica/bullet.html
-    Collisions.clear();
+    collisions.Update(physicsWorld->getDispatcher());
 
-    int manifolds = physicsWorld->getDispatcher()->getNumManifolds();
-    for (int i = 0; i < manifolds; i++)
+    //hand each contact to whatever is registered for its layers
+    for (const SMI_Collision& collision : collisions.GetContacts())
     {
-        btPersistentManifold* Contact = physicsWorld->getDispatcher()->getManifoldByIndexInternal(i);
-        //collision body 1 and 2
-        const btCollisionObject* obj1 = Contact->getBody0();
-        const btCollisionObject* obj2 = Contact->getBody1();
+        DispatchCollision(collision);
+    }
+    for (const SMI_Collision& collision : collisions.GetEnded())
+    {
+        DispatchCollision(collision);
+    }
+}
 
-        //int for number of contacts
-        int numcon = Contact->getNumContacts();
-        for (int j = 0; j < numcon; j++)
+void SMI_Scene::WakeTouching(btRigidBody* body)
+{
+    btDispatcher* dispatcher = physicsWorld->getDispatcher();
+    for (int i = 0; i < dispatcher->getNumManifolds(); i++)
+    {
+        btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(i);
+        if (manifold->getBody0() == body || manifold->getBody1() == body)
         {
-            btManifoldPoint& point = Contact->getContactPoint(j);
-            if (point.getDistance() < 0.f)
-            {
-                const btRigidBody* FirstBody = btRigidBody::upcast(obj1);
-                const btRigidBody* SecondBody = btRigidBody::upcast(obj2);
+            const btCollisionObject* other = manifold->getBody0() == body ? manifold->getBody1() : manifold->getBody0();
+            const_cast<btCollisionObject*>(other)->activate();
+        }
+    }
+}
 
-                SMI_Collision::sptr NewCollide = SMI_Collision::Create();
-                NewCollide->setB1(static_cast<entt::entity>(reinterpret_cast<uint32_t>(FirstBody->getUserPointer())));
-                NewCollide->setB2(static_cast<entt::entity>(reinterpret_cast<uint32_t>(SecondBody->getUserPointer())));
+void SMI_Scene::FixedUpdate(float fixedTimeStep)
+{
+}
 
-                bool Add = true;
-                for (int k = 0; k < Collisions.size(); k++)
-                {
-                    if (SMI_Collision::Same(NewCollide, Collisions[k]))
-                    {
-                        Add = false;
-                        break;
-                    }
-                }
+void SMI_Scene::UpdateKinematics()
+{
+    auto view = Store.view<SMI_KinematicController, SMI_Physics>();
+    for (auto entity : view)
+    {
+        view.get<SMI_KinematicController>(entity).Step(view.get<SMI_Physics>(entity), fixedTimeStep);
+    }
+}
 
-                if (Add)
-                {
-                    Collisions.push_back(NewCollide);
-                }
-            }
+size_t SMI_Scene::getActiveBodyCount() const
+{
+    size_t count = 0;
+    const btCollisionObjectArray& objects = physicsWorld->getCollisionObjectArray();
+    for (int i = 0; i < objects.size(); i++)
+    {
+        if (!objects[i]->isStaticObject() && objects[i]->isActive())
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t SMI_Scene::getSleepingBodyCount() const
+{
+    size_t count = 0;
+    const btCollisionObjectArray& objects = physicsWorld->getCollisionObjectArray();
+    for (int i = 0; i < objects.size(); i++)
+    {
+        if (!objects[i]->isStaticObject() && !objects[i]->isActive())
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+void SMI_Scene::RegisterCollisionCallback(int layerA, int layerB, const CollisionCallback& callback)
+{
+    LOG_ASSERT(layerA >= 0 && layerA < SMI_MAX_COLLISION_LAYERS && layerB >= 0 && layerB < SMI_MAX_COLLISION_LAYERS,
+        "Collision layers must be between 0 and {}!", SMI_MAX_COLLISION_LAYERS - 1);
+
+    //the pair can be reported either way around, so the handler goes in both slots of the table, and is told to swap
+    //the entities when they come in backwards
+    for (int order = 0; order < (layerA == layerB ? 1 : 2); order++)
+    {
+        int slot = order == 0 ? layerA * SMI_MAX_COLLISION_LAYERS + layerB : layerB * SMI_MAX_COLLISION_LAYERS + layerA;
+        int index = static_cast<int>(collisionHandlers.size());
+        collisionHandlers.push_back({ callback, order == 1, -1 });
+
+        //handlers are called in the order they were registered
+        int* next = &collisionHandlerTable[slot];
+        while (*next != -1)
+        {
+            next = &collisionHandlers[*next].next;
+        }
+        *next = index;
+    }
+}
+
+void SMI_Scene::DispatchCollision(const SMI_Collision& collision)
+{
+    int layer1 = collision.getLayer1();
+    int layer2 = collision.getLayer2();
+    if (layer1 < 0 || layer1 >= SMI_MAX_COLLISION_LAYERS || layer2 < 0 || layer2 >= SMI_MAX_COLLISION_LAYERS)
+    {
+        return;
+    }
+
+    for (int ix = collisionHandlerTable[layer1 * SMI_MAX_COLLISION_LAYERS + layer2]; ix != -1; ix = collisionHandlers[ix].next)
+    {
+        const CollisionHandler& handler = collisionHandlers[ix];
+        if (handler.swap)
+        {
+            handler.callback(collision.getB2(), collision.getB1(), collision.getEvent());
+        }
+        else
+        {
+            handler.callback(collision.getB1(), collision.getB2(), collision.getEvent());
         }
     }
 }
@@ -3,24 +3,36 @@
 #include "GLM/glm.hpp"
 #include "GLM/common.hpp"
 #include "Physics.h"
+#include "CollisionTracker.h"
+#include "PhysicsWorld.h"
 #include "Camera.h"
 #include "Transform.h"
+#include "TransformKernel.h"
+#include "Frustum.h"
+#include "DynamicBVH.h"
 #include "Render.h"
+#include "RenderQueue.h"
+#include "UniformBlocks.h"
 #include "Framebuffer.h"
 
 #include <vector>
+#include <array>
+#include <memory>
+#include <functional>
 
 //class to create a scene 
 class SMI_Scene
 {
 public:
 	//constructor calls
-	SMI_Scene();
+	SMI_Scene(const SMI_PhysicsSettings& _physicsSettings = SMI_PhysicsSettings());
 
-	//copy, move, and assignment operators
-	SMI_Scene(const SMI_Scene& oldScene) = default;
-	SMI_Scene(SMI_Scene&&) = default;
-	SMI_Scene& operator=(SMI_Scene&) = default;
+	//scenes can't be copied or moved, the physics world holds pointers back into the scene (ex: the collision filter)
+	//that would be left pointing at the old one
+	SMI_Scene(const SMI_Scene& oldScene) = delete;
+	SMI_Scene(SMI_Scene&&) = delete;
+	SMI_Scene& operator=(const SMI_Scene&) = delete;
+	SMI_Scene& operator=(SMI_Scene&&) = delete;
 
 	//destructor call
 	~SMI_Scene();
@@ -32,6 +44,9 @@ public:
 	//function declarations for a scene 
 	virtual void InitScene();
 	virtual void Update(float deltaTime);
+	//called right before each fixed physics step, so gameplay that pushes bodies around (forces, jumps) runs once per
+	//step no matter the frame rate. Forces are cleared after every step, so they need to be added here
+	virtual void FixedUpdate(float fixedTimeStep);
 	virtual void Render();
 	virtual void PostRender();
 
@@ -47,11 +62,84 @@ public:
 	template <typename T>
 	void Remove(entt::entity target);
 
+	//Transform hierarchy
+	//makes parent the parent of child, pass entt::null to make child a root again. Both need a transform, and child's
+	//position, rotation and scale become relative to its parent
+	void setParent(entt::entity child, entt::entity parent);
+	//recomputes the world matrix of every transform that has changed, or whose parent has. This is done at the start
+	//of Render, but can be called earlier if up to date world matrices are needed
+	void UpdateTransforms();
+
+	//Spatial queries
+	//these search the world space bounds of everything with a renderer, as of the last call to UpdateTransforms. Any
+	//entities that are found are added to results
+	void QueryAABB(const glm::vec3& min, const glm::vec3& max, std::vector<entt::entity>& results) const;
+	void QuerySphere(const glm::vec3& center, float radius, std::vector<entt::entity>& results) const;
+	void QueryFrustum(const Frustum& frustum, std::vector<entt::entity>& results) const;
+	//finds the closest bounds hit by a ray, returning false if nothing was hit. Distances are in multiples of the
+	//direction's length
+	bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, entt::entity& hit, float& distance) const;
+
+	//Contact events from the last physics step
+	//every pair that is touching, BEGIN on the first step they touch and STAY after that
+	const std::vector<SMI_Collision>& getCollisions() const { return collisions.GetContacts(); }
+	//every pair that stopped touching, each is reported once as an END
+	const std::vector<SMI_Collision>& getEndedCollisions() const { return collisions.GetEnded(); }
+
+	//Collision callbacks
+	//called with the two entities and the event, the first entity is always the one in layerA
+	typedef std::function<void(entt::entity, entt::entity, SMI_ContactEvent)> CollisionCallback;
+	//calls callback for every contact event between a body in layerA and a body in layerB, right after each physics
+	//step. Handlers for the same pair of layers are called in the order they were registered
+	void RegisterCollisionCallback(int layerA, int layerB, const CollisionCallback& callback);
+
 	//Physics for scenes
 	//gravity setter and getter
-	void setGravity(const glm::vec3& _gravity) { gravity = _gravity; }
+	void setGravity(const glm::vec3& _gravity);
 	glm::vec3 getGravity() const { return gravity; }
 
+	//physics always steps by the fixed time step, as many times as it takes to catch up with the time passed to Update,
+	//and transforms are blended between the last two steps so motion stays smooth at any frame rate
+	void setFixedTimeStep(const float& _fixedTimeStep) { fixedTimeStep = _fixedTimeStep; }
+	float getFixedTimeStep() const { return fixedTimeStep; }
+	//the most steps that will be taken in one update, any time left over after that is dropped
+	void setMaxSubSteps(const int& _maxSubSteps) { maxSubSteps = _maxSubSteps; }
+	int getMaxSubSteps() const { return maxSubSteps; }
+	//the longest frame that will be simulated, so one long hitch (ex: loading) doesn't make every frame after it fall behind
+	void setMaxFrameTime(const float& _maxFrameTime) { maxFrameTime = _maxFrameTime; }
+	float getMaxFrameTime() const { return maxFrameTime; }
+
+	//how long a body has to stay below its sleep thresholds before it falls asleep, in seconds. This is Bullet's global
+	//gDeactivationTime, not a setting of any one scene, so changing it changes it for every scene and world at once
+	static void setTimeToSleep(const float& _timeToSleep) { gDeactivationTime = _timeToSleep; }
+	static float getTimeToSleep() { return gDeactivationTime; }
+	//the number of bodies that Bullet is simulating, and the number that are asleep. Static bodies aren't counted
+	size_t getActiveBodyCount() const;
+	size_t getSleepingBodyCount() const;
+
+	//bulk pose and velocity reads, for every entity with an SMI_Physics and all of the Filter components. The arrays are
+	//cleared and filled in one pass, so the pose of entities[i] is in positions[i] and rotations[i]
+	template <typename... Filter>
+	void GetBodyPoses(std::vector<entt::entity>& entities, std::vector<glm::vec3>& positions, std::vector<glm::quat>& rotations);
+	template <typename... Filter>
+	void GetBodyVelocities(std::vector<entt::entity>& entities, std::vector<glm::vec3>& linear, std::vector<glm::vec3>& angular);
+
+	//counters for the last call to Update, and totals since the scene was made
+	struct PhysicsStats
+	{
+		//the number of fixed steps taken
+		uint32_t SubSteps;
+		//the time that was thrown away instead of simulated, in seconds
+		float TimeDropped;
+		//how far between the last two steps transforms were blended, from 0 (the older step) to 1 (the newer one)
+		float Alpha;
+		uint64_t TotalSubSteps;
+		double TotalTimeDropped;
+	};
+	const PhysicsStats& getPhysicsStats() const { return physicsStats; }
+	//how the physics world was set up
+	const SMI_PhysicsSettings& getPhysicsSettings() const { return physics.getSettings(); }
+
 	//setter and getter for active scene 
 	void setActive(const bool& _isActive) { isActive = _isActive; }
 	bool getActive() const { return isActive; }
@@ -64,6 +152,36 @@ public:
 	void setCamera(const Camera::Sptr& _cam) { camera = _cam; }
 	Camera::Sptr getCamera() const { return camera; }
 
+	//lights that are passed to every shader through the Frame block, only the first UniformBlocks::MAX_LIGHTS are used
+	struct Light
+	{
+		glm::vec3 Position;
+		glm::vec3 Color;
+	};
+	void addLight(const glm::vec3& _position, const glm::vec3& _color = glm::vec3(1.0f)) { lights.push_back({ _position, _color }); }
+	void clearLights() { lights.clear(); }
+	const std::vector<Light>& getLights() const { return lights; }
+
+	//counters for the last call to Render, useful for seeing how well objects are being batched
+	struct RenderStats
+	{
+		//the number of objects that were drawn (this was also the number of draw calls before batching)
+		uint32_t Objects;
+		//the number of draw calls used to draw them
+		uint32_t DrawCalls;
+		//the number of draw calls that used instancing, and how many objects they drew
+		uint32_t InstancedDraws;
+		uint32_t InstancedObjects;
+		//the number of objects checked against the camera's frustum, and how many of them were skipped for being off screen
+		uint32_t CullTested;
+		uint32_t Culled;
+		//the number of textures that had been unloaded to stay within the texture budget and were reloaded to draw
+		uint32_t TexturesReloaded;
+	};
+	const RenderStats& getRenderStats() const { return renderStats; }
+	//counters for how many binds the render queue was able to skip in the last call to Render
+	const RenderQueue::Stats& getQueueStats() const { return renderQueue.GetStats(); }
+
 private:
 	//create registry
 	entt::registry Store;
@@ -75,24 +193,85 @@ private:
 
 	//physics variables
 	glm::vec3 gravity;
+	float fixedTimeStep;
+	int maxSubSteps;
+	float maxFrameTime;
+	//time that has passed but hasn't been simulated yet
+	float accumulator;
+	PhysicsStats physicsStats;
+
+	//bodies add themselves to this when they move, so we only update the transforms of things that move
+	std::unique_ptr<SMI_MotionQueue> motionQueue;
+	//the difference between how a body and its transform are turned, taken the first time the body is synced, and the
+	//body rotation that was last written to the transform
+	struct PhysicsState
+	{
+		glm::quat RotationOffset;
+		glm::quat BodyRotation;
+	};
 
-	//physics world properties
-	btDefaultCollisionConfiguration* CollisionConfig;
-	btCollisionDispatcher* Dispatcher;
-	btBroadphaseInterface* OverlappingPairCache;
-	btSequentialImpulseConstraintSolver* Solver;
-	//physics world
+	//physics world and the parts it's made from
+	SMI_PhysicsWorld physics;
+	//physics world, the same as physics.getWorld()
 	btDiscreteDynamicsWorld* physicsWorld;
 
 
 	//manages collisions
 	void CollisionManage();
+	//moves every body that has a kinematic controller to where it should be at the end of the coming step, all in one
+	//pass before the step is taken
+	void UpdateKinematics();
+	//wakes up everything touching a body that's about to be removed, so nothing is left asleep in mid air
+	void WakeTouching(btRigidBody* body);
+	//keeps track of which bodies are touching between steps
+	CollisionTracker collisions;
+	//decides which pairs of bodies can collide, based on their collision layers
+	SMI_CollisionFilter collisionFilter;
+
+	//a registered collision callback, with the next handler for the same pair of layers
+	struct CollisionHandler
+	{
+		CollisionCallback callback;
+		//set if the handler is stored under (layerB, layerA), so the entities need to be swapped
+		bool swap;
+		int next;
+	};
+	std::vector<CollisionHandler> collisionHandlers;
+	//the first handler for each pair of layers, indexed by layer1 * SMI_MAX_COLLISION_LAYERS + layer2, or -1
+	std::array<int, SMI_MAX_COLLISION_LAYERS * SMI_MAX_COLLISION_LAYERS> collisionHandlerTable;
+	//calls the handlers for a contact event
+	void DispatchCollision(const SMI_Collision& collision);
+
+	//set when a parent changes, so the transforms need to be sorted again before the next update
+	bool hierarchyDirty;
+	//works out the depth of every transform and sorts them so that parents come before their children
+	void SortTransforms();
+	//scratch space for the transforms that need their world matrix rebuilt, laid out the way TransformKernel wants it
+	std::vector<SMI_Transform*> changedTransforms;
+	std::vector<glm::vec3> transformPositions;
+	std::vector<glm::quat> transformRotations;
+	std::vector<glm::vec3> transformScales;
+	std::vector<const glm::mat4*> transformParents;
+	std::vector<glm::mat4*> transformOutputs;
+
+	//the world bounds of every renderer are kept in a BVH, for culling and spatial queries. Each entity in it gets a
+	//SpatialProxy so we can find its leaf again
+	struct SpatialProxy
+	{
+		int32_t Proxy;
+	};
+	DynamicBVH spatialIndex;
+	std::vector<entt::entity> staleProxies;
+	std::vector<entt::entity> visibleEntities;
+
+	RenderStats renderStats;
+	//sorts and submits everything we draw
+	RenderQueue renderQueue;
 
 protected:
 	//handle used to reference camera object
 	Camera::Sptr camera;
-	//vector to hold all collisions to manage
-	std::vector<SMI_Collision::sptr> Collisions;
+	std::vector<Light> lights;
 
 	Semi::SMI_Framebuffer::ssptr DefaultBuffer;
 };
@@ -111,8 +290,9 @@ inline void SMI_Scene::Attach<SMI_Physics>(entt::entity target)
 	SMI_Physics& phys = GetComponent<SMI_Physics>(target);
 
 	phys.setEntity(target);
-	physicsWorld->addRigidBody(phys.getRigidBody());
-	phys.setInWorld(true);
+	physicsWorld->addRigidBody(phys.getRigidBody(), phys.getCollisionGroup(), static_cast<int>(phys.getCollisionMask()));
+	phys.getMotionState()->setQueue(motionQueue.get(), target);
+	phys.setWorld(physicsWorld);
 }
 
 template <typename T>
@@ -127,8 +307,43 @@ inline void SMI_Scene::AttachCopy<SMI_Physics>(entt::entity target, const SMI_Ph
 	SMI_Physics& phys = GetComponent<SMI_Physics>(target);
 
 	phys.setEntity(target);
-	physicsWorld->addRigidBody(phys.getRigidBody());
-	phys.setInWorld(true);
+	physicsWorld->addRigidBody(phys.getRigidBody(), phys.getCollisionGroup(), static_cast<int>(phys.getCollisionMask()));
+	phys.getMotionState()->setQueue(motionQueue.get(), target);
+	phys.setWorld(physicsWorld);
+}
+
+template <typename... Filter>
+inline void SMI_Scene::GetBodyPoses(std::vector<entt::entity>& entities, std::vector<glm::vec3>& positions, std::vector<glm::quat>& rotations)
+{
+	auto view = Store.view<SMI_Physics, Filter...>();
+	entities.clear();
+	positions.clear();
+	rotations.clear();
+	for (auto entity : view)
+	{
+		glm::vec3 pos;
+		glm::quat rot;
+		view.template get<SMI_Physics>(entity).GetPose(pos, rot);
+		entities.push_back(entity);
+		positions.push_back(pos);
+		rotations.push_back(rot);
+	}
+}
+
+template <typename... Filter>
+inline void SMI_Scene::GetBodyVelocities(std::vector<entt::entity>& entities, std::vector<glm::vec3>& linear, std::vector<glm::vec3>& angular)
+{
+	auto view = Store.view<SMI_Physics, Filter...>();
+	entities.clear();
+	linear.clear();
+	angular.clear();
+	for (auto entity : view)
+	{
+		const SMI_Physics& phys = view.template get<SMI_Physics>(entity);
+		entities.push_back(entity);
+		linear.push_back(phys.GetLinearVelocity());
+		angular.push_back(phys.GetAngularVelocity());
+	}
 }
 
 template <typename T>
@@ -151,13 +366,14 @@ inline void SMI_Scene::Remove(entt::entity target)
 template <>
 inline void SMI_Scene::Remove<SMI_Physics>(entt::entity target)
 {
-	//deletes bullet components and physics
+	//deletes bullet components and physics, the shape is shared through the ShapeCache so it stays
 	btRigidBody* TargetBody = Store.get<SMI_Physics>(target).getRigidBody();
+	WakeTouching(TargetBody);
 	delete TargetBody->getMotionState();
-	delete TargetBody->getCollisionShape();
 	physicsWorld->removeRigidBody(TargetBody);
 	delete TargetBody;
 
-	//deletes component
+	//deletes component, and what we were using to blend it
 	Store.remove<SMI_Physics>(target);
+	Store.remove_if_exists<PhysicsState>(target);
 }
\ No newline at end of file
@@ -2,12 +2,15 @@
 #include "Logging.h"
 #include <fstream>
 #include <sstream>
+#include <vector>
+#include <algorithm>
 
 Shader::Shader() :
 	// We zero out all of our members so we don't have garbage data in our class
 	_vs(0),
 	_fs(0),
-	_handle(0)
+	_handle(0),
+	_instancedVariant(nullptr)
 {
 	_handle = glCreateProgram();
 }
@@ -124,6 +127,8 @@ bool Shader::Link()
 		} else {
 			LOG_ERROR("Shader failed to link for an unknown reason!");
 		}
+	} else {
+		__ReflectUniforms();
 	}
 	return status != GL_FALSE;
 }
@@ -173,19 +178,80 @@ void Shader::SetUniform(int location, const glm::ivec4* value, int count) {
 
 void Shader::SetUniform(int location, const bool* value, int count) {
 	LOG_ASSERT(count == 1, "SetUniform for bools only supports setting single values at a time!");
-	glProgramUniform1i(location, *value, 1);
+	glProgramUniform1i(_handle, location, *value);
 }
 void Shader::SetUniform(int location, const glm::bvec2* value, int count) {
 	LOG_ASSERT(count == 1, "SetUniform for bools only supports setting single values at a time!");
-	glProgramUniform2i(location, value->x, value->y, 1);
+	glProgramUniform2i(_handle, location, value->x, value->y);
 }
 void Shader::SetUniform(int location, const glm::bvec3* value, int count) {
 	LOG_ASSERT(count == 1, "SetUniform for bools only supports setting single values at a time!");
-	glProgramUniform3i(location, value->x, value->y, value->z, 1);
+	glProgramUniform3i(_handle, location, value->x, value->y, value->z);
 }
 void Shader::SetUniform(int location, const glm::bvec4* value, int count) {
 	LOG_ASSERT(count == 1, "SetUniform for bools only supports setting single values at a time!");
-	glProgramUniform4i(location, value->x, value->y, value->z, value->w, 1);
+	glProgramUniform4i(_handle, location, value->x, value->y, value->z, value->w);
+}
+
+void Shader::__ReflectUniforms() {
+	_uniformLocs.clear();
+	_blocks.clear();
+	_blockMembers.clear();
+
+	GLint maxNameLength = 0, maxBlockNameLength = 0;
+	glGetProgramInterfaceiv(_handle, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxNameLength);
+	glGetProgramInterfaceiv(_handle, GL_UNIFORM_BLOCK, GL_MAX_NAME_LENGTH, &maxBlockNameLength);
+	std::vector<char> name(std::max(std::max(maxNameLength, maxBlockNameLength), 1));
+
+	// Find the uniform blocks first, so we can tell which block each uniform belongs to
+	GLint numBlocks = 0;
+	glGetProgramInterfaceiv(_handle, GL_UNIFORM_BLOCK, GL_ACTIVE_RESOURCES, &numBlocks);
+	std::vector<std::string> blockNames(numBlocks);
+	for (GLint ix = 0; ix < numBlocks; ix++) {
+		const GLenum props[] = { GL_BUFFER_DATA_SIZE };
+		GLint size = 0;
+		glGetProgramResourceiv(_handle, GL_UNIFORM_BLOCK, ix, 1, props, 1, nullptr, &size);
+		glGetProgramResourceName(_handle, GL_UNIFORM_BLOCK, ix, static_cast<GLsizei>(name.size()), nullptr, name.data());
+		blockNames[ix] = name.data();
+		_blocks[blockNames[ix]] = size;
+	}
+
+	GLint numUniforms = 0;
+	glGetProgramInterfaceiv(_handle, GL_UNIFORM, GL_ACTIVE_RESOURCES, &numUniforms);
+	for (GLint ix = 0; ix < numUniforms; ix++) {
+		const GLenum props[] = { GL_LOCATION, GL_BLOCK_INDEX, GL_OFFSET };
+		GLint values[3] = { -1, -1, -1 };
+		glGetProgramResourceiv(_handle, GL_UNIFORM, ix, 3, props, 3, nullptr, values);
+		glGetProgramResourceName(_handle, GL_UNIFORM, ix, static_cast<GLsizei>(name.size()), nullptr, name.data());
+		std::string uniformName = name.data();
+
+		// Arrays are reported as "name[0]", but we want to be able to look them up by just their name as well
+		std::string baseName;
+		size_t bracket = uniformName.find("[0]");
+		if (bracket != std::string::npos && bracket + 3 == uniformName.size()) {
+			baseName = uniformName.substr(0, bracket);
+		}
+
+		if (values[1] != -1) {
+			// Uniforms inside of blocks don't have a location, they're set through their buffer instead
+			BlockMember member = { blockNames[values[1]], values[2] };
+			_blockMembers[uniformName] = member;
+			if (!baseName.empty()) _blockMembers[baseName] = member;
+		} else if (values[0] != -1) {
+			_uniformLocs[uniformName] = values[0];
+			if (!baseName.empty()) _uniformLocs[baseName] = values[0];
+		}
+	}
+}
+
+int Shader::GetUniformBlockSize(const std::string& block) const {
+	auto it = _blocks.find(block);
+	return it != _blocks.end() ? it->second : -1;
+}
+
+int Shader::GetUniformBlockOffset(const std::string& block, const std::string& name) const {
+	auto it = _blockMembers.find(name);
+	return it != _blockMembers.end() && it->second.Block == block ? it->second.Offset : -1;
 }
 
 int Shader::__GetUniformLocation(const std::string& name) {
@@ -78,6 +78,32 @@ public:
 	/// </summary>
 	GLuint GetHandle() const { return _handle; }
 
+	/// <summary>
+	/// Sets the shader to use when objects using this shader are drawn with instancing. The variant should read the
+	/// model matrix from the per-instance inModel attribute (locations 4-7) and ViewProjection from the Frame block
+	/// (binding 0, see UniformBlocks.h), it gets no per-object uniforms
+	/// </summary>
+	void SetInstancedVariant(const Sptr& variant) { _instancedVariant = variant; }
+	/// <summary>
+	/// Gets the shader to use when drawing with instancing, or nullptr if this shader can't be instanced
+	/// </summary>
+	const Sptr& GetInstancedVariant() const { return _instancedVariant; }
+
+	/// <summary>
+	/// Gets the location of a uniform in this shader, or -1 if it does not exist. Locations are read from the program
+	/// when it is linked, so look them up once and keep them instead of calling this every frame
+	/// </summary>
+	int GetUniformLocation(const std::string& name) { return __GetUniformLocation(name); }
+	/// <summary>
+	/// Gets the size in bytes of one of this shader's uniform blocks, or -1 if the shader does not use the block
+	/// </summary>
+	int GetUniformBlockSize(const std::string& block) const;
+	/// <summary>
+	/// Gets the offset in bytes of a uniform inside of one of this shader's uniform blocks, or -1 if the uniform is not
+	/// a member of that block
+	/// </summary>
+	int GetUniformBlockOffset(const std::string& block, const std::string& name) const;
+
 public:
 	void SetUniformMatrix(int location, const glm::mat3* value, int count = 1, bool transposed = false);
 	void SetUniformMatrix(int location, const glm::mat4* value, int count = 1, bool transposed = false);
@@ -121,7 +147,20 @@ protected:
 	// Stores the shader program handle
 	GLuint _handle;
 
+	// The version of this shader that reads its model matrix per instance
+	Sptr _instancedVariant;
+
 	// Map and access to look up uniform locations
 	std::unordered_map<std::string, int> _uniformLocs;
 	int __GetUniformLocation(const std::string& name);
+	// The size of each uniform block, and which block and offset each uniform inside of a block lives at
+	struct BlockMember {
+		std::string Block;
+		int         Offset;
+	};
+	std::unordered_map<std::string, int> _blocks;
+	std::unordered_map<std::string, BlockMember> _blockMembers;
+
+	// Fills in _uniformLocs, _blocks and _blockMembers with every active uniform in the program, called after linking
+	void __ReflectUniforms();
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "Texture2D.h"
 #include <stb_image.h>
 #include <Logging.h>
+#include "Utils/BakedTexture.h"
 #include "GLM/glm.hpp"
 
 /// <summary>
@@ -13,19 +14,20 @@ inline int CalcRequiredMipLevels(int width, int height) {
 	return (1 + floor(log2(glm::max(width, height))));
 }
 
-Texture2D::Texture2D() : ITexture(TextureType::_2D)
+Texture2D::Texture2D() : ITexture(TextureType::_2D), _isResident(true)
 {
 }
 
-Texture2D::Texture2D(const Texture2DDescription& description) : ITexture(TextureType::_2D) {
+Texture2D::Texture2D(const Texture2DDescription& description) : ITexture(TextureType::_2D), _isResident(true) {
 	_description = description;
 	_SetTextureParams();
-	if (!description.Filename.empty()) {
+	// If the size was given, the caller already has the pixels (ex: decoded on a worker) and will upload them with LoadData
+	if (!description.Filename.empty() && description.Width * description.Height == 0) {
 		_LoadDataFromFile();
 	}
 }
 
-Texture2D::Texture2D(const std::string& filePath) : ITexture(TextureType::_2D) {
+Texture2D::Texture2D(const std::string& filePath) : ITexture(TextureType::_2D), _isResident(true) {
 	_description.Filename = filePath;
 	_SetTextureParams();
 	_LoadDataFromFile();
@@ -46,12 +48,51 @@ void Texture2D::SetAnisoLevel(float value) {
 		_description.MaxAnisotropic = glm::clamp(value, 1.0f, ITexture::GetLimits().MAX_ANISOTROPY);
 		glTextureParameterf(_handle, GL_TEXTURE_MAX_ANISOTROPY, _description.MaxAnisotropic);
 
-		if (_description.GenerateMipMaps) {
+		// Compressed textures come with their mip chain already built
+		if (_description.GenerateMipMaps && GetCompressedBlockSize(_description.Format) == 0) {
 			glGenerateTextureMipmap(_handle);
 		}
 	}
 }
 
+size_t Texture2D::GetGpuBytes() const {
+	if (!_isResident) {
+		return 0;
+	}
+
+	size_t blockSize = GetCompressedBlockSize(_description.Format);
+	size_t bytes = blockSize != 0 ?
+		static_cast<size_t>((_description.Width + 3) / 4) * ((_description.Height + 3) / 4) * blockSize :
+		static_cast<size_t>(_description.Width) * _description.Height * GetTexelSize(_description.Format);
+	// A full mip chain adds another third on top of the base level
+	return _description.GenerateMipMaps ? bytes + bytes / 3 : bytes;
+}
+
+void Texture2D::Unload() {
+	if (!_isResident || _description.Filename.empty()) {
+		return;
+	}
+
+	// Texture storage is immutable, so the only way to give the memory back is to delete the texture. We grab a new
+	// empty handle right away so that anything holding on to our handle doesn't end up with a dangling one
+	glDeleteTextures(1, &_handle);
+	glCreateTextures((GLenum)_type, 1, &_handle);
+	_description.Width = 0;
+	_description.Height = 0;
+	_isResident = false;
+}
+
+bool Texture2D::MakeResident() {
+	if (_isResident) {
+		return false;
+	}
+
+	LOG_INFO("Reloading evicted texture \"{}\"", _description.Filename);
+	_LoadDataFromFile();
+	_isResident = true;
+	return true;
+}
+
 void Texture2D::LoadData(uint32_t width, uint32_t height, PixelFormat format, PixelType type, void* data, uint32_t offsetX, uint32_t offsetY) {
 	// Ensure the rectangle we're setting is within the bounds of the image
 	LOG_ASSERT((width + offsetX) <= _description.Width, "Pixel bounds are outside of the X extents of the image!");
@@ -71,10 +112,32 @@ void Texture2D::LoadData(uint32_t width, uint32_t height, PixelFormat format, Pi
 	}
 }
 
+void Texture2D::LoadCompressedData(uint32_t level, uint32_t width, uint32_t height, const void* data, size_t size) {
+	LOG_ASSERT(GetCompressedBlockSize(_description.Format) != 0, "This texture does not use a compressed format!");
+	glCompressedTextureSubImage2D(_handle, level, 0, 0, width, height, (GLenum)_description.Format, (GLsizei)size, data);
+}
+
 void Texture2D::_LoadDataFromFile() {
 	LOG_ASSERT(_description.Width + _description.Height == 0, "This texture has already been configured with a size! Cannot re-allocate memory!");
 
 	if (!_description.Filename.empty()) {
+		// If the image has been baked, we can upload the compressed blocks and mip chain straight from the baked file
+		BakedTexture::Image baked;
+		std::unique_ptr<MappedFile> bakedFile = BakedTexture::Open(_description.Filename, baked);
+		if (bakedFile != nullptr) {
+			_description.Format = baked.Format;
+			_description.Width = baked.Width;
+			_description.Height = baked.Height;
+			_description.GenerateMipMaps = _description.GenerateMipMaps && baked.Levels.size() > 1;
+			_SetTextureParams();
+
+			size_t levelCount = _description.GenerateMipMaps ? baked.Levels.size() : 1;
+			for (uint32_t level = 0; level < levelCount; level++) {
+				LoadCompressedData(level, baked.Levels[level].Width, baked.Levels[level].Height, baked.Levels[level].Data, baked.Levels[level].Size);
+			}
+			return;
+		}
+
 		// Variables that will store properties about our image
 		int width, height, numChannels;
 		const int targetChannels = GetTexelComponentCount(_description.FormatHint);
@@ -127,6 +127,27 @@ public:
 	float GetAnisoLevel() const { return _description.MaxAnisotropic; }
 	void SetAnisoLevel(float value);
 
+	/// <summary>
+	/// Gets an estimate of how much GPU memory this texture is using, including its mip chain
+	/// </summary>
+	size_t GetGpuBytes() const;
+
+	/// <summary>
+	/// Returns true if this texture's data is currently stored on the GPU
+	/// </summary>
+	bool IsResident() const { return _isResident; }
+	/// <summary>
+	/// Frees this texture's GPU memory. The texture will be reloaded from its file by the next call to MakeResident, so
+	/// this does nothing for textures that were not loaded from a file
+	/// </summary>
+	void Unload();
+
+	/// <summary>
+	/// Reloads this texture from its file if it was unloaded
+	/// </summary>
+	/// <returns>True if the texture had to be reloaded</returns>
+	virtual bool MakeResident() override;
+
 	/// <summary>
 	/// Loads a region of data into this texture
 	/// Bounds must be contained by the bounds of the texture
@@ -141,6 +162,18 @@ public:
 	/// <param name="offsetY">The y edge of the destination rectangle in the texture, bottom->top</param>
 	void LoadData(uint32_t width, uint32_t height, PixelFormat format, PixelType type, void* data, uint32_t offsetX = 0, uint32_t offsetY = 0);
 
+	/// <summary>
+	/// Loads a single mip level of pre-compressed blocks into this texture. The texture must have been created with a
+	/// block compressed format (see GetCompressedBlockSize), and mip maps are never generated for it, so every level
+	/// needs to be loaded
+	/// </summary>
+	/// <param name="level">The mip level to load, 0 is the full size image</param>
+	/// <param name="width">The width of the mip level, in pixels</param>
+	/// <param name="height">The height of the mip level, in pixels</param>
+	/// <param name="data">A pointer to the compressed blocks</param>
+	/// <param name="size">The size of the compressed data, in bytes</param>
+	void LoadCompressedData(uint32_t level, uint32_t width, uint32_t height, const void* data, size_t size);
+
 	/// <summary>
 	/// Gets this texture's description, which contains basic information about the
 	/// texture's dimensions and creation parameters
@@ -149,6 +182,7 @@ public:
 
 protected:
 	Texture2DDescription _description;
+	bool _isResident;
 
 	/// <summary>
 	/// Loads this texture from the file specified in the description
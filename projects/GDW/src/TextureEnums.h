@@ -5,6 +5,14 @@
 #include "Logging.h"
 #include "glad/glad.h"
 
+// S3TC is supported by every desktop GPU, but it's an extension, so glad doesn't define the formats for us
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
 /// <summary>
 /// The types of texture we will support in our framework
 /// </summary>
@@ -34,7 +42,9 @@ ENUM(InternalFormat, GLint,
 	RGBA8        = GL_RGBA8,
 	SRGBA        = GL_SRGB8_ALPHA8,
 	RGBA16       = GL_RGBA16,
-	RGB32AF      = GL_RGBA32F
+	RGB32AF      = GL_RGBA32F,
+	BC1          = GL_COMPRESSED_RGB_S3TC_DXT1_EXT,  // 4x4 RGB blocks in 8 bytes
+	BC3          = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT  // 4x4 RGBA blocks in 16 bytes
 	// Note: There are sized internal formats but there is a LOT of them
 );
 
@@ -170,4 +180,52 @@ constexpr GLint GetTexelComponentCount(PixelFormat format) {
  */
 constexpr size_t GetTexelSize(PixelFormat format, PixelType type) {
 	return GetTexelComponentSize(type) * GetTexelComponentCount(format);
+}
+
+/*
+ * Gets the number of bytes the GPU will use to store a single texel of the given internal format. This is an
+ * estimate, drivers are free to pad formats (ex: RGB8 is usually stored as RGBA8, so we count it as 4 bytes)
+ * @param format The internal format of the texture
+ * @returns The size of a single texel in GPU memory, in bytes
+ */
+constexpr size_t GetTexelSize(InternalFormat format) {
+	switch (format) {
+		case InternalFormat::R8:
+			return 1;
+		case InternalFormat::R16:
+		case InternalFormat::RG8:
+			return 2;
+		case InternalFormat::Depth:
+		case InternalFormat::DepthStencil:
+		case InternalFormat::RGB8:
+		case InternalFormat::SRGB:
+		case InternalFormat::RGB10:
+		case InternalFormat::RGBA8:
+		case InternalFormat::SRGBA:
+			return 4;
+		case InternalFormat::RGB16:
+		case InternalFormat::RGBA16:
+			return 8;
+		case InternalFormat::RGB32F:
+		case InternalFormat::RGB32AF:
+			return 16;
+		default:
+			return 0;
+	}
+}
+
+/*
+ * Gets the number of bytes used by a single 4x4 block of a block compressed format
+ * @param format The internal format of the texture
+ * @returns The size of a single block in bytes, or 0 if the format is not block compressed
+ */
+constexpr size_t GetCompressedBlockSize(InternalFormat format) {
+	switch (format) {
+		case InternalFormat::BC1:
+			return 8;
+		case InternalFormat::BC3:
+			return 16;
+		default:
+			return 0;
+	}
 }
\ No newline at end of file
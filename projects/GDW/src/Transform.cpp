@@ -2,56 +2,23 @@
 
 SMI_Transform::SMI_Transform()
 {
-	m_parent = nullptr;
-
 	Pos = glm::vec3(0.0f);
 	Scale = glm::vec3(1.0f);
 	Rot = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
 
 	Global = glm::mat4(1.0f);
-}
-
-void SMI_Transform::DoFK()
-{
-	//First, grab our local transform...
-	glm::mat4 local  =  glm::translate(Pos) *
-						glm::toMat4(glm::normalize(Rot)) *
-						glm::scale(Scale);
-
-	//If we have a parent, we need to multiply by our parent's
-	//global transform.
-	if (m_parent != nullptr)
-		Global = m_parent->Global * local;
 
-	//If we have no parent object, our global transform is our
-	//local transform!
-	else
-		Global = local;
-
-	//FK is recursive - we now repeat this process on our child nodes.
-	//Eventually, we'll be at the bottom of the hierarchy and this will
-	//return.
-	for (auto* child : m_children)
-	{
-		child->DoFK();
-	}
+	Parent = entt::null;
+	Depth = 0;
+	Dirty = true;
+	Changed = false;
 }
 
-const glm::mat4& SMI_Transform::RecomputeGlobal()
+glm::mat4 SMI_Transform::computeLocal() const
 {
-	//Just as with FK, compute our local, then multiply with
-		//our parent's transform if applicable.
-
-	glm::mat4 local  =  glm::translate(Pos) *
-						glm::toMat4(Rot) *
-						glm::scale(Scale);
-
-	if (m_parent != nullptr)
-		Global = m_parent->RecomputeGlobal() * local;
-	else
-		Global = local;
-
-	return Global;
+	return glm::translate(Pos) *
+		   glm::toMat4(glm::normalize(Rot)) *
+		   glm::scale(Scale);
 }
 
 glm::mat3 SMI_Transform::GetNormal() const
@@ -77,31 +44,18 @@ glm::mat3 SMI_Transform::GetNormal() const
 	return glm::inverse(glm::transpose(glm::mat3(Global)));
 }
 
-void SMI_Transform::SetParent(SMI_Transform* parent)
-{
-}
-
 void SMI_Transform::FixedRotate(glm::vec3 _rot)
 {
 	Rot = glm::quat(glm::radians(_rot)) * Rot;
-	RecomputeGlobal();
+	Dirty = true;
 }
 
 void SMI_Transform::RelativeRotate(glm::vec3 _rot)
 {
 	Rot = Rot * glm::quat(glm::radians(_rot));
-	RecomputeGlobal();
+	Dirty = true;
 }
 
 SMI_Transform::~SMI_Transform()
-{
-	SetParent(nullptr);
-}
-
-void SMI_Transform::AddChild(SMI_Transform* child)
-{
-}
-
-void SMI_Transform::RemoveChild(SMI_Transform* child)
 {
 }
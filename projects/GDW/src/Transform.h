@@ -3,11 +3,15 @@
 #include "GLM/common.hpp"
 #include "GLM/glm.hpp"
 #include <vector>
+#include "entt.hpp"
 //allow use of experimental glm features
 #define GLM_ENABLE_EXPERIMENTAL
 #include "GLM/gtx/quaternion.hpp"
 #include "GLM/gtx/transform.hpp"
 
+//transforms are stored as components, and form a hierarchy through the entity of their parent. The scene keeps the
+//component pool sorted so that parents always come before their children, which lets it update every world matrix
+//in a single pass (see SMI_Scene::UpdateTransforms). Setters only mark the transform as dirty
 class SMI_Transform
 {
 public:
@@ -15,44 +19,43 @@ public:
 	SMI_Transform();
 	SMI_Transform(const SMI_Transform& other) = default;
 
-	//This will update the transform on the object and all of its children.
-	void DoFK();
-
-	//This will recompute and return the global transform of this object.
-	const glm::mat4& RecomputeGlobal();
+	//builds the local transform from the position, rotation and scale
+	glm::mat4 computeLocal() const;
 
 	//This will return the current normal matrix of the object
 	//(used for lighting). As above, make sure you have called
 	//the appropriate update first.
 	glm::mat3 GetNormal() const;
 
-	//Sets a pointer to the parent object and updates child references
-	//for the old and new parent objects accordingly.
-	//Pass in nullptr if you wish for the object to not have a parent.
-	void SetParent(SMI_Transform* parent);
-
 	//functions for rotation
 	void FixedRotate(glm::vec3 _rot);
 	void RelativeRotate(glm::vec3 _rot);
 
 	//setter functions
-	void setPos(const glm::vec3 _Pos) { Pos = _Pos; RecomputeGlobal(); }
-	void setScale(const glm::vec3 _Scale) { Scale = _Scale; RecomputeGlobal(); }
-	void setRot(const glm::quat _Rot) { Rot = _Rot; RecomputeGlobal(); }
-	void SetDegree(const glm::vec3 _Rot) { Rot = glm::quat(glm::radians(_Rot)); RecomputeGlobal(); }
+	void setPos(const glm::vec3 _Pos) { Pos = _Pos; Dirty = true; }
+	void setScale(const glm::vec3 _Scale) { Scale = _Scale; Dirty = true; }
+	void setRot(const glm::quat _Rot) { Rot = _Rot; Dirty = true; }
+	void SetDegree(const glm::vec3 _Rot) { Rot = glm::quat(glm::radians(_Rot)); Dirty = true; }
 
 	//getter functions
 	glm::vec3 getPos() const { return Pos; }
 	glm::vec3 getScale() const { return Scale; }
 	glm::quat getRot() const { return Rot; }
-	glm::mat4 getGlobal() const { return Global; }
+	//the world matrix as of the last call to SMI_Scene::UpdateTransforms
+	const glm::mat4& getGlobal() const { return Global; }
+	//the entity of our parent, or entt::null if we are a root. Use SMI_Scene::setParent to change it
+	entt::entity getParent() const { return Parent; }
+	//true if we've changed since the last update
+	bool isDirty() const { return Dirty; }
 
 	//destructor
 	virtual ~SMI_Transform();
 
 private:
-	//mat4 variables for scene graph and model matrix
-	glm::mat4 Local;
+	//the scene sets up the hierarchy and updates our world matrix
+	friend class SMI_Scene;
+
+	//mat4 variable for the model matrix
 	glm::mat4 Global;
 
 	//variables for position, rotation and scale
@@ -60,13 +63,11 @@ private:
 	glm::vec3 Scale;
 	glm::quat Rot;
 
-protected:
-	SMI_Transform* m_parent;
-	std::vector<SMI_Transform*> m_children;
-
-	//These functions are protected since they will be handled
-	//by SetParent - we don't want to have to manually update this ourselves
-	//whenever we switch an object's parent!
-	void AddChild(SMI_Transform* child);
-	void RemoveChild(SMI_Transform* child);
+	//our place in the hierarchy, depth is the number of parents above us and is what the pool is sorted on
+	entt::entity Parent;
+	uint32_t Depth;
+	//set when our local transform changes, or our parent changes
+	bool Dirty;
+	//set during an update if our world matrix was recomputed, so our children know to recompute theirs
+	bool Changed;
 };
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "TransformKernel.h"
+
+#if defined(__AVX__)
+	#include <immintrin.h>
+	#define TRANSFORM_KERNEL_AVX
+	#define TRANSFORM_KERNEL_SSE
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define TRANSFORM_KERNEL_SSE
+#endif
+
+/*
+ * All three versions use the same maths. With s = 2 / |q|^2 (which saves normalizing q first), and x2 = x * s etc, the
+ * columns of the rotation matrix are:
+ *   col0 = (1, 0, 0) + y2 * (-y,  x, -w) + z2 * (-z,  w,  x)
+ *   col1 = (0, 1, 0) + x2 * ( y, -x,  w) + z2 * (-w, -z,  y)
+ *   col2 = (0, 0, 1) + x2 * ( z, -w, -x) + y2 * ( w,  z, -y)
+ * which only needs three shuffles of q: (y, x, w), (z, w, x) and (w, z, y). A zero quaternion gives s = 0, and so the
+ * identity, the same as glm::normalize would
+ */
+
+// Builds one transform in plain C++
+static inline void ComposeScalar(const glm::vec3& pos, const glm::quat& rot, const glm::vec3& scale, const glm::mat4* parent, glm::mat4& out)
+{
+	float len2 = rot.x * rot.x + rot.y * rot.y + rot.z * rot.z + rot.w * rot.w;
+	float s = len2 > 0.0f ? 2.0f / len2 : 0.0f;
+	float x2 = rot.x * s, y2 = rot.y * s, z2 = rot.z * s;
+	float xx = rot.x * x2, yy = rot.y * y2, zz = rot.z * z2;
+	float xy = rot.x * y2, xz = rot.x * z2, yz = rot.y * z2;
+	float wx = rot.w * x2, wy = rot.w * y2, wz = rot.w * z2;
+
+	glm::vec4 col0 = glm::vec4(1.0f - (yy + zz), xy + wz, xz - wy, 0.0f) * scale.x;
+	glm::vec4 col1 = glm::vec4(xy - wz, 1.0f - (xx + zz), yz + wx, 0.0f) * scale.y;
+	glm::vec4 col2 = glm::vec4(xz + wy, yz - wx, 1.0f - (xx + yy), 0.0f) * scale.z;
+
+	if (parent == nullptr) {
+		out[0] = col0;
+		out[1] = col1;
+		out[2] = col2;
+		out[3] = glm::vec4(pos, 1.0f);
+		return;
+	}
+
+	const glm::mat4& p = *parent;
+	out[0] = p[0] * col0.x + p[1] * col0.y + p[2] * col0.z;
+	out[1] = p[0] * col1.x + p[1] * col1.y + p[2] * col1.z;
+	out[2] = p[0] * col2.x + p[1] * col2.y + p[2] * col2.z;
+	out[3] = p[0] * pos.x + p[1] * pos.y + p[2] * pos.z + p[3];
+}
+
+#ifdef TRANSFORM_KERNEL_SSE
+#define SPLAT(v, i) _mm_shuffle_ps(v, v, _MM_SHUFFLE(i, i, i, i))
+
+// Builds one transform with SSE, each register holds one column
+static inline void ComposeSSE(const glm::vec3& pos, const glm::quat& rot, const glm::vec3& scale, const glm::mat4* parent, glm::mat4& out)
+{
+	__m128 q = _mm_loadu_ps(&rot.x);
+
+	// s = 2 / |q|^2 in every lane, or 0 if q is zero
+	__m128 len2 = _mm_mul_ps(q, q);
+	len2 = _mm_add_ps(len2, _mm_shuffle_ps(len2, len2, _MM_SHUFFLE(2, 3, 0, 1)));
+	len2 = _mm_add_ps(len2, _mm_shuffle_ps(len2, len2, _MM_SHUFFLE(1, 0, 3, 2)));
+	__m128 s = _mm_and_ps(_mm_div_ps(_mm_set1_ps(2.0f), len2), _mm_cmpgt_ps(len2, _mm_setzero_ps()));
+	__m128 q2 = _mm_mul_ps(q, s);
+	__m128 x2 = SPLAT(q2, 0);
+	__m128 y2 = SPLAT(q2, 1);
+	__m128 z2 = SPLAT(q2, 2);
+
+	__m128 yxw = _mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 3, 0, 1));
+	__m128 zwx = _mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 0, 3, 2));
+	__m128 wzy = _mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 1, 2, 3));
+
+	// The signs also zero out the w lane, so the columns come out as directions
+	__m128 col0 = _mm_add_ps(_mm_setr_ps(1.0f, 0.0f, 0.0f, 0.0f), _mm_add_ps(
+		_mm_mul_ps(y2, _mm_mul_ps(yxw, _mm_setr_ps(-1.0f, 1.0f, -1.0f, 0.0f))),
+		_mm_mul_ps(z2, _mm_mul_ps(zwx, _mm_setr_ps(-1.0f, 1.0f, 1.0f, 0.0f)))));
+	__m128 col1 = _mm_add_ps(_mm_setr_ps(0.0f, 1.0f, 0.0f, 0.0f), _mm_add_ps(
+		_mm_mul_ps(x2, _mm_mul_ps(yxw, _mm_setr_ps(1.0f, -1.0f, 1.0f, 0.0f))),
+		_mm_mul_ps(z2, _mm_mul_ps(wzy, _mm_setr_ps(-1.0f, -1.0f, 1.0f, 0.0f)))));
+	__m128 col2 = _mm_add_ps(_mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f), _mm_add_ps(
+		_mm_mul_ps(x2, _mm_mul_ps(zwx, _mm_setr_ps(1.0f, -1.0f, -1.0f, 0.0f))),
+		_mm_mul_ps(y2, _mm_mul_ps(wzy, _mm_setr_ps(1.0f, 1.0f, -1.0f, 0.0f)))));
+
+	col0 = _mm_mul_ps(col0, _mm_set1_ps(scale.x));
+	col1 = _mm_mul_ps(col1, _mm_set1_ps(scale.y));
+	col2 = _mm_mul_ps(col2, _mm_set1_ps(scale.z));
+	__m128 col3 = _mm_setr_ps(pos.x, pos.y, pos.z, 1.0f);
+
+	if (parent != nullptr) {
+		__m128 p0 = _mm_loadu_ps(&(*parent)[0][0]);
+		__m128 p1 = _mm_loadu_ps(&(*parent)[1][0]);
+		__m128 p2 = _mm_loadu_ps(&(*parent)[2][0]);
+		__m128 p3 = _mm_loadu_ps(&(*parent)[3][0]);
+
+		col0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p0, SPLAT(col0, 0)), _mm_mul_ps(p1, SPLAT(col0, 1))), _mm_mul_ps(p2, SPLAT(col0, 2)));
+		col1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p0, SPLAT(col1, 0)), _mm_mul_ps(p1, SPLAT(col1, 1))), _mm_mul_ps(p2, SPLAT(col1, 2)));
+		col2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p0, SPLAT(col2, 0)), _mm_mul_ps(p1, SPLAT(col2, 1))), _mm_mul_ps(p2, SPLAT(col2, 2)));
+		col3 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p0, SPLAT(col3, 0)), _mm_mul_ps(p1, SPLAT(col3, 1))), _mm_add_ps(_mm_mul_ps(p2, SPLAT(col3, 2)), p3));
+	}
+
+	_mm_storeu_ps(&out[0][0], col0);
+	_mm_storeu_ps(&out[1][0], col1);
+	_mm_storeu_ps(&out[2][0], col2);
+	_mm_storeu_ps(&out[3][0], col3);
+}
+
+#undef SPLAT
+#endif
+
+#ifdef TRANSFORM_KERNEL_AVX
+#define SPLAT(v, i) _mm256_permute_ps(v, _MM_SHUFFLE(i, i, i, i))
+
+// Puts a into the low half of a register and b into the high half
+static inline __m256 Pair(__m128 a, __m128 b)
+{
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(a), b, 1);
+}
+
+static const glm::mat4 IDENTITY = glm::mat4(1.0f);
+
+// Builds two transforms with AVX, each register holds the same column of both, a in the low half and b in the high
+// half. All the shuffles stay within their half, so this is the SSE version run on both at once
+static inline void ComposeAVX(const glm::vec3* pos, const glm::quat* rot, const glm::vec3* scale, const glm::mat4* parentA, const glm::mat4* parentB, glm::mat4& outA, glm::mat4& outB)
+{
+	__m256 q = Pair(_mm_loadu_ps(&rot[0].x), _mm_loadu_ps(&rot[1].x));
+
+	__m256 len2 = _mm256_mul_ps(q, q);
+	len2 = _mm256_add_ps(len2, _mm256_permute_ps(len2, _MM_SHUFFLE(2, 3, 0, 1)));
+	len2 = _mm256_add_ps(len2, _mm256_permute_ps(len2, _MM_SHUFFLE(1, 0, 3, 2)));
+	__m256 s = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(2.0f), len2), _mm256_cmp_ps(len2, _mm256_setzero_ps(), _CMP_GT_OQ));
+	__m256 q2 = _mm256_mul_ps(q, s);
+	__m256 x2 = SPLAT(q2, 0);
+	__m256 y2 = SPLAT(q2, 1);
+	__m256 z2 = SPLAT(q2, 2);
+
+	__m256 yxw = _mm256_permute_ps(q, _MM_SHUFFLE(3, 3, 0, 1));
+	__m256 zwx = _mm256_permute_ps(q, _MM_SHUFFLE(0, 0, 3, 2));
+	__m256 wzy = _mm256_permute_ps(q, _MM_SHUFFLE(0, 1, 2, 3));
+
+	__m256 col0 = _mm256_add_ps(_mm256_setr_ps(1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f), _mm256_add_ps(
+		_mm256_mul_ps(y2, _mm256_mul_ps(yxw, _mm256_setr_ps(-1.0f, 1.0f, -1.0f, 0.0f, -1.0f, 1.0f, -1.0f, 0.0f))),
+		_mm256_mul_ps(z2, _mm256_mul_ps(zwx, _mm256_setr_ps(-1.0f, 1.0f, 1.0f, 0.0f, -1.0f, 1.0f, 1.0f, 0.0f)))));
+	__m256 col1 = _mm256_add_ps(_mm256_setr_ps(0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f), _mm256_add_ps(
+		_mm256_mul_ps(x2, _mm256_mul_ps(yxw, _mm256_setr_ps(1.0f, -1.0f, 1.0f, 0.0f, 1.0f, -1.0f, 1.0f, 0.0f))),
+		_mm256_mul_ps(z2, _mm256_mul_ps(wzy, _mm256_setr_ps(-1.0f, -1.0f, 1.0f, 0.0f, -1.0f, -1.0f, 1.0f, 0.0f)))));
+	__m256 col2 = _mm256_add_ps(_mm256_setr_ps(0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f), _mm256_add_ps(
+		_mm256_mul_ps(x2, _mm256_mul_ps(zwx, _mm256_setr_ps(1.0f, -1.0f, -1.0f, 0.0f, 1.0f, -1.0f, -1.0f, 0.0f))),
+		_mm256_mul_ps(y2, _mm256_mul_ps(wzy, _mm256_setr_ps(1.0f, 1.0f, -1.0f, 0.0f, 1.0f, 1.0f, -1.0f, 0.0f)))));
+
+	col0 = _mm256_mul_ps(col0, Pair(_mm_set1_ps(scale[0].x), _mm_set1_ps(scale[1].x)));
+	col1 = _mm256_mul_ps(col1, Pair(_mm_set1_ps(scale[0].y), _mm_set1_ps(scale[1].y)));
+	col2 = _mm256_mul_ps(col2, Pair(_mm_set1_ps(scale[0].z), _mm_set1_ps(scale[1].z)));
+	__m256 col3 = _mm256_setr_ps(pos[0].x, pos[0].y, pos[0].z, 1.0f, pos[1].x, pos[1].y, pos[1].z, 1.0f);
+
+	if (parentA != nullptr || parentB != nullptr) {
+		const glm::mat4& pa = parentA != nullptr ? *parentA : IDENTITY;
+		const glm::mat4& pb = parentB != nullptr ? *parentB : IDENTITY;
+		__m256 p0 = Pair(_mm_loadu_ps(&pa[0][0]), _mm_loadu_ps(&pb[0][0]));
+		__m256 p1 = Pair(_mm_loadu_ps(&pa[1][0]), _mm_loadu_ps(&pb[1][0]));
+		__m256 p2 = Pair(_mm_loadu_ps(&pa[2][0]), _mm_loadu_ps(&pb[2][0]));
+		__m256 p3 = Pair(_mm_loadu_ps(&pa[3][0]), _mm_loadu_ps(&pb[3][0]));
+
+		col0 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p0, SPLAT(col0, 0)), _mm256_mul_ps(p1, SPLAT(col0, 1))), _mm256_mul_ps(p2, SPLAT(col0, 2)));
+		col1 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p0, SPLAT(col1, 0)), _mm256_mul_ps(p1, SPLAT(col1, 1))), _mm256_mul_ps(p2, SPLAT(col1, 2)));
+		col2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p0, SPLAT(col2, 0)), _mm256_mul_ps(p1, SPLAT(col2, 1))), _mm256_mul_ps(p2, SPLAT(col2, 2)));
+		col3 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p0, SPLAT(col3, 0)), _mm256_mul_ps(p1, SPLAT(col3, 1))), _mm256_add_ps(_mm256_mul_ps(p2, SPLAT(col3, 2)), p3));
+	}
+
+	_mm_storeu_ps(&outA[0][0], _mm256_castps256_ps128(col0));
+	_mm_storeu_ps(&outA[1][0], _mm256_castps256_ps128(col1));
+	_mm_storeu_ps(&outA[2][0], _mm256_castps256_ps128(col2));
+	_mm_storeu_ps(&outA[3][0], _mm256_castps256_ps128(col3));
+	_mm_storeu_ps(&outB[0][0], _mm256_extractf128_ps(col0, 1));
+	_mm_storeu_ps(&outB[1][0], _mm256_extractf128_ps(col1, 1));
+	_mm_storeu_ps(&outB[2][0], _mm256_extractf128_ps(col2, 1));
+	_mm_storeu_ps(&outB[3][0], _mm256_extractf128_ps(col3, 1));
+}
+
+#undef SPLAT
+#endif
+
+void TransformKernel::Compose(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales,
+	const glm::mat4* const* parents, glm::mat4* const* outputs, size_t count)
+{
+	size_t ix = 0;
+
+#if defined(TRANSFORM_KERNEL_AVX)
+	for (; ix + 2 <= count; ix += 2) {
+		ComposeAVX(positions + ix, rotations + ix, scales + ix,
+			parents != nullptr ? parents[ix] : nullptr, parents != nullptr ? parents[ix + 1] : nullptr,
+			*outputs[ix], *outputs[ix + 1]);
+	}
+#endif
+
+	for (; ix < count; ix++) {
+		const glm::mat4* parent = parents != nullptr ? parents[ix] : nullptr;
+#if defined(TRANSFORM_KERNEL_SSE)
+		ComposeSSE(positions[ix], rotations[ix], scales[ix], parent, *outputs[ix]);
+#else
+		ComposeScalar(positions[ix], rotations[ix], scales[ix], parent, *outputs[ix]);
+#endif
+	}
+}
+
+const char* TransformKernel::GetPath()
+{
+#if defined(TRANSFORM_KERNEL_AVX)
+	return "AVX";
+#elif defined(TRANSFORM_KERNEL_SSE)
+	return "SSE";
+#else
+	return "Scalar";
+#endif
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <GLM/glm.hpp>
+#include <GLM/gtc/quaternion.hpp>
+#include <cstddef>
+
+/// <summary>
+/// Builds world matrices for whole batches of transforms at once. Instead of making a translation, rotation and scale
+/// matrix and multiplying them together (two full 4x4 multiplies per object), the rotation is written straight into
+/// the matrix with the scale folded in, and the multiply by the parent skips the bottom row of the local matrix since
+/// it is always (0, 0, 0, 1).
+///
+/// The widest version the compiler is allowed to use is picked at build time. With /arch:AVX or /arch:AVX2 two
+/// transforms are done per iteration, on x64 SSE does one at a time, and anything else falls back to plain C++
+/// </summary>
+class TransformKernel
+{
+public:
+	/// <summary>
+	/// Builds the world matrix of each transform, outputs[i] = parents[i] * T(positions[i]) * R(rotations[i]) * S(scales[i])
+	///
+	/// Transforms in a batch may be done at the same time, so an output must not be the parent of another transform in
+	/// the same call. Update a hierarchy one level at a time instead
+	/// </summary>
+	/// <param name="positions">The position of each transform</param>
+	/// <param name="rotations">The rotation of each transform, these do not need to be normalized</param>
+	/// <param name="scales">The scale of each transform</param>
+	/// <param name="parents">The parent matrix of each transform, or nullptr for a root. The array itself can be nullptr if every transform is a root</param>
+	/// <param name="outputs">Where to write the matrix of each transform</param>
+	/// <param name="count">The number of transforms in the batch</param>
+	static void Compose(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales,
+		const glm::mat4* const* parents, glm::mat4* const* outputs, size_t count);
+
+	/// <summary>
+	/// Gets the name of the version of Compose that was compiled in, either "AVX", "SSE" or "Scalar"
+	/// </summary>
+	static const char* GetPath();
+
+protected:
+	TransformKernel() = default;
+	~TransformKernel() = default;
+};
@@ -3,6 +3,24 @@
 #include "GLM/glm.hpp"
 #include <memory>
 #include <string>
+#include <cstring>
+#include <cstdint>
+
+//copies a value into a uniform block using std140 rules. Most types are laid out the same as they are in memory,
+//the exceptions are overloaded below
+template <typename T>
+inline void WriteStd140(uint8_t* dest, const T& value) { std::memcpy(dest, &value, sizeof(T)); }
+//each column of a mat3 is padded out to a vec4
+inline void WriteStd140(uint8_t* dest, const glm::mat3& value) {
+	for (int col = 0; col < 3; col++) {
+		std::memcpy(dest + col * sizeof(glm::vec4), &value[col], sizeof(glm::vec3));
+	}
+}
+//bools are stored as 4 byte ints
+inline void WriteStd140(uint8_t* dest, const bool& value) { WriteStd140(dest, static_cast<int>(value)); }
+inline void WriteStd140(uint8_t* dest, const glm::bvec2& value) { WriteStd140(dest, glm::ivec2(value)); }
+inline void WriteStd140(uint8_t* dest, const glm::bvec3& value) { WriteStd140(dest, glm::ivec3(value)); }
+inline void WriteStd140(uint8_t* dest, const glm::bvec4& value) { WriteStd140(dest, glm::ivec4(value)); }
 
 class Uniform
 {
@@ -11,9 +29,10 @@ public:
 
 public:
 	//pure virtual function. Acts as a parent for UniformObject
-	virtual void SetUniform(Shader::Sptr) = 0;
-
-	virtual void SetUniformMatrix(Shader::Sptr) = 0;
+	//uploads the data to the given location in the shader, the material looks the location up once ahead of time
+	virtual void Upload(Shader* shader, int location) const = 0;
+	//writes the data into a uniform block at the given address, using std140 rules
+	virtual void Write(uint8_t* dest) const = 0;
 
 	//setters
 	void setName(const std::string& _name) { UniformName = _name; }
@@ -38,8 +57,8 @@ public:
 
 public:
 	//declare function
-	void SetUniform(Shader::Sptr);
-	void SetUniformMatrix(Shader::Sptr) {};
+	void Upload(Shader* shader, int location) const override;
+	void Write(uint8_t* dest) const override { WriteStd140(dest, UniformData); }
 
 	//setters
 	void setData(const T& _data) { UniformData = _data; }
@@ -64,8 +83,8 @@ public:
 
 public:
 	//declare function
-	void SetUniform(Shader::Sptr) {};
-	void SetUniformMatrix(Shader::Sptr);
+	void Upload(Shader* shader, int location) const override;
+	void Write(uint8_t* dest) const override { WriteStd140(dest, UniformData); }
 
 	//setters
 	void setData(const T& _data) { UniformData = _data; }
@@ -81,13 +100,13 @@ protected:
 
 //function to set the Uniform
 template<typename T>
-inline void UniformObject<T>::SetUniform(Shader::Sptr shader)
+inline void UniformObject<T>::Upload(Shader* shader, int location) const
 {
-	shader->SetUniform(UniformName, UniformData);
+	shader->SetUniform(location, &UniformData, 1);
 }
 
 template<typename T>
-inline void UniformMatrixObject<T>::SetUniformMatrix(Shader::Sptr shader)
+inline void UniformMatrixObject<T>::Upload(Shader* shader, int location) const
 {
-	shader->SetUniformMatrix(UniformName, UniformData);
+	shader->SetUniformMatrix(location, &UniformData, 1);
 }
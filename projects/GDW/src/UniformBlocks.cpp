@@ -0,0 +1,72 @@
+#include "UniformBlocks.h"
+#include "Logging.h"
+
+#include <cstring>
+
+UniformRingBuffer::Sptr UniformBlocks::__ring = nullptr;
+UniformBlocks::FrameData UniformBlocks::__frameData = UniformBlocks::FrameData();
+uint64_t UniformBlocks::__frameNumber = 0;
+
+// The std140 layout of FrameData has no padding between members, so it can be copied straight into the buffer
+static_assert(sizeof(UniformBlocks::FrameData) == 3 * 64 + 2 * 16 + 2 * UniformBlocks::MAX_LIGHTS * 16 + 16, "FrameData must match the std140 layout of the Frame block");
+
+void UniformBlocks::Init(size_t frameSize)
+{
+	__ring = UniformRingBuffer::Create(frameSize);
+}
+
+void UniformBlocks::Shutdown()
+{
+	__ring = nullptr;
+}
+
+void UniformBlocks::BeginFrame(float time, float deltaTime)
+{
+	LOG_ASSERT(__ring != nullptr, "UniformBlocks::Init must be called before use!");
+	__ring->BeginFrame();
+	__frameNumber++;
+	__frameData.Time = glm::vec4(time, deltaTime, 0.0f, 0.0f);
+}
+
+void UniformBlocks::EndFrame()
+{
+	__ring->EndFrame();
+}
+
+void UniformBlocks::SetFrameData(const FrameData& data)
+{
+	glm::vec4 time = __frameData.Time;
+	__frameData = data;
+	__frameData.Time = time;
+
+	size_t offset = 0;
+	uint8_t* dest = Allocate(sizeof(FrameData), offset);
+	// Allocate may have already written the frame block if the ring grew, but it would have been the old data
+	std::memcpy(dest, &__frameData, sizeof(FrameData));
+	BindRange(FRAME_BINDING, offset, sizeof(FrameData));
+}
+
+uint8_t* UniformBlocks::Allocate(size_t size, size_t& offset)
+{
+	uint32_t generation = __ring->GetGeneration();
+	uint8_t* result = __ring->Allocate(size, offset);
+
+	// The old buffer is gone, so the frame block needs to live in the new one too
+	if (__ring->GetGeneration() != generation) {
+		size_t frameOffset = 0;
+		uint8_t* frame = __ring->Allocate(sizeof(FrameData), frameOffset);
+		std::memcpy(frame, &__frameData, sizeof(FrameData));
+		BindRange(FRAME_BINDING, frameOffset, sizeof(FrameData));
+	}
+	return result;
+}
+
+void UniformBlocks::BindRange(GLuint binding, size_t offset, size_t size)
+{
+	__ring->BindRange(binding, offset, size);
+}
+
+uint64_t UniformBlocks::GetStamp()
+{
+	return (static_cast<uint64_t>(__ring->GetGeneration()) << 48) ^ __frameNumber;
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <GLM/glm.hpp>
+#include "UniformRingBuffer.h"
+
+/// <summary>
+/// Manages the uniform blocks that our shaders share. Data that is the same for every draw in a frame (the camera,
+/// time and lights) lives in the Frame block, which is written once per scene render and bound at FRAME_BINDING.
+/// Materials write their own uniforms into a Material block bound at MATERIAL_BINDING. Both are allocated out of a
+/// single persistently mapped ring buffer.
+///
+/// Shaders declare the blocks like so (the Frame block must match FrameData exactly):
+///     layout(std140, binding = 0) uniform Frame { ... };
+///     layout(std140, binding = 1) uniform Material { ... };
+/// </summary>
+class UniformBlocks
+{
+public:
+	static const GLuint FRAME_BINDING = 0;
+	static const GLuint MATERIAL_BINDING = 1;
+	static const int MAX_LIGHTS = 4;
+
+	/// <summary>
+	/// The contents of the Frame block, laid out using std140 rules
+	/// </summary>
+	struct FrameData
+	{
+		glm::mat4  View;
+		glm::mat4  Projection;
+		glm::mat4  ViewProjection;
+		// xyz is the camera's position in world space
+		glm::vec4  CameraPos;
+		// x is the time in seconds since the game started, y is the length of the last frame in seconds
+		glm::vec4  Time;
+		// xyz is the position of each light in world space
+		glm::vec4  LightPos[MAX_LIGHTS];
+		// rgb is the color of each light
+		glm::vec4  LightColor[MAX_LIGHTS];
+		// x is the number of lights in use
+		glm::ivec4 LightCount;
+	};
+
+	/// <summary>
+	/// Creates the ring buffer, must be called after OpenGL has been loaded
+	/// </summary>
+	/// <param name="frameSize">The number of bytes of uniform data we expect to write each frame</param>
+	static void Init(size_t frameSize = 256 * 1024);
+	/// <summary>
+	/// Releases the ring buffer
+	/// </summary>
+	static void Shutdown();
+
+	/// <summary>
+	/// Starts a new frame, this may wait for the GPU to finish with the part of the ring buffer we are about to reuse
+	/// </summary>
+	/// <param name="time">The time in seconds since the game started</param>
+	/// <param name="deltaTime">The length of the last frame in seconds</param>
+	static void BeginFrame(float time, float deltaTime);
+	/// <summary>
+	/// Ends the current frame, should be called after everything has been drawn
+	/// </summary>
+	static void EndFrame();
+
+	/// <summary>
+	/// Writes the Frame block and binds it, the time is filled in from the last call to BeginFrame
+	/// </summary>
+	static void SetFrameData(const FrameData& data);
+
+	/// <summary>
+	/// Allocates space for a block in the ring buffer. If the ring buffer has to grow, the Frame block is written
+	/// again and rebound for you
+	/// </summary>
+	/// <param name="size">The size of the block in bytes</param>
+	/// <param name="offset">Set to the offset to pass to BindRange</param>
+	/// <returns>A pointer to write the block into, valid until the end of the frame</returns>
+	static uint8_t* Allocate(size_t size, size_t& offset);
+	/// <summary>
+	/// Binds a range of the ring buffer that was returned from Allocate to a binding point
+	/// </summary>
+	static void BindRange(GLuint binding, size_t offset, size_t size);
+
+	/// <summary>
+	/// Gets a number that is different for every frame and changes whenever the ring buffer is replaced, blocks that
+	/// were allocated with a different stamp need to be written again
+	/// </summary>
+	static uint64_t GetStamp();
+
+protected:
+	UniformBlocks() = default;
+	~UniformBlocks() = default;
+
+private:
+	static UniformRingBuffer::Sptr __ring;
+	static FrameData __frameData;
+	static uint64_t  __frameNumber;
+};
@@ -0,0 +1,116 @@
+#include "UniformRingBuffer.h"
+#include "Logging.h"
+
+// Rounds a size up to the next multiple of the given alignment
+static inline size_t AlignUp(size_t value, size_t alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+UniformRingBuffer::UniformRingBuffer(size_t frameSize, uint32_t frameCount) :
+	_handle(0),
+	_mapped(nullptr),
+	_frameSize(0),
+	_alignment(256),
+	_frameCount(frameCount),
+	_frame(0),
+	_head(0),
+	_generation(0),
+	_fences(std::vector<GLsync>(frameCount, nullptr))
+{
+	// Bound ranges need to start on a multiple of this, it's usually 256 bytes
+	GLint alignment = 0;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	if (alignment > 0) {
+		_alignment = static_cast<size_t>(alignment);
+	}
+
+	__Allocate(frameSize);
+}
+
+UniformRingBuffer::~UniformRingBuffer()
+{
+	__Release();
+}
+
+void UniformRingBuffer::BeginFrame()
+{
+	_frame = (_frame + 1) % _frameCount;
+	_head = 0;
+
+	// If the GPU is still reading from the section we're about to reuse, wait for it to finish
+	GLsync& fence = _fences[_frame];
+	if (fence != nullptr) {
+		GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+		while (result == GL_TIMEOUT_EXPIRED) {
+			result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		}
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+}
+
+void UniformRingBuffer::EndFrame()
+{
+	GLsync& fence = _fences[_frame];
+	if (fence != nullptr) {
+		glDeleteSync(fence);
+	}
+	fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+uint8_t* UniformRingBuffer::Allocate(size_t size, size_t& offset)
+{
+	size_t start = AlignUp(_head, _alignment);
+	if (start + size > _frameSize) {
+		// Out of room, swap to a bigger buffer. Deleting the old one is safe, OpenGL keeps it alive until the commands
+		// that are already using it have finished
+		size_t newSize = _frameSize * 2;
+		while (newSize < size) {
+			newSize *= 2;
+		}
+		LOG_WARN("Uniform ring buffer is full, growing from {} to {} bytes per frame", _frameSize, newSize);
+
+		__Release();
+		__Allocate(newSize);
+		_frame = 0;
+		start = 0;
+	}
+
+	offset = _frame * _frameSize + start;
+	_head = start + size;
+	return _mapped + offset;
+}
+
+void UniformRingBuffer::BindRange(GLuint binding, size_t offset, size_t size) const
+{
+	glBindBufferRange(GL_UNIFORM_BUFFER, binding, _handle, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+}
+
+void UniformRingBuffer::__Allocate(size_t frameSize)
+{
+	_frameSize = AlignUp(frameSize, _alignment);
+	_generation++;
+
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glCreateBuffers(1, &_handle);
+	glNamedBufferStorage(_handle, _frameSize * _frameCount, nullptr, flags);
+	_mapped = static_cast<uint8_t*>(glMapNamedBufferRange(_handle, 0, _frameSize * _frameCount, flags));
+	LOG_ASSERT(_mapped != nullptr, "Failed to map uniform ring buffer!");
+}
+
+void UniformRingBuffer::__Release()
+{
+	for (GLsync& fence : _fences) {
+		if (fence != nullptr) {
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+	}
+
+	if (_handle != 0) {
+		glUnmapNamedBuffer(_handle);
+		glDeleteBuffers(1, &_handle);
+		_handle = 0;
+		_mapped = nullptr;
+	}
+}
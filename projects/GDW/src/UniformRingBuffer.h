@@ -0,0 +1,89 @@
+#pragma once
+#include <glad/glad.h>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+/// <summary>
+/// A uniform buffer that is persistently mapped and split into a few sections, one per frame in flight. Each frame we
+/// write into the next section while the GPU is still reading from the ones before it, and fences make sure we never
+/// write over a section the GPU hasn't finished with yet. This means uniform data can be written straight into the
+/// buffer with a memcpy, and never causes the driver to stall or copy
+/// </summary>
+class UniformRingBuffer final
+{
+public:
+	typedef std::shared_ptr<UniformRingBuffer> Sptr;
+
+	static inline Sptr Create(size_t frameSize, uint32_t frameCount = 3) {
+		return std::make_shared<UniformRingBuffer>(frameSize, frameCount);
+	}
+
+	// We'll disallow moving and copying, since we want to manually control when the destructor is called
+	// We'll use these classes via pointers
+	UniformRingBuffer(const UniformRingBuffer& other) = delete;
+	UniformRingBuffer(UniformRingBuffer&& other) = delete;
+	UniformRingBuffer& operator=(const UniformRingBuffer& other) = delete;
+	UniformRingBuffer& operator=(UniformRingBuffer&& other) = delete;
+
+public:
+	/// <summary>
+	/// Creates a new ring buffer
+	/// </summary>
+	/// <param name="frameSize">The number of bytes that can be allocated each frame, this will grow if it is exceeded</param>
+	/// <param name="frameCount">The number of frames that can be in flight at once</param>
+	UniformRingBuffer(size_t frameSize, uint32_t frameCount = 3);
+	~UniformRingBuffer();
+
+	/// <summary>
+	/// Moves on to the next section of the buffer, waiting for the GPU to finish with it if it is still in use. Should
+	/// be called once at the start of every frame
+	/// </summary>
+	void BeginFrame();
+	/// <summary>
+	/// Marks the end of the commands that use the current section, should be called once the frame has been submitted
+	/// </summary>
+	void EndFrame();
+
+	/// <summary>
+	/// Allocates space in the current frame's section of the buffer. If the section is full, the buffer is replaced with
+	/// a larger one, which invalidates any earlier allocations that have not been bound yet (see GetGeneration)
+	/// </summary>
+	/// <param name="size">The number of bytes to allocate</param>
+	/// <param name="offset">Set to the offset of the allocation from the start of the buffer, for use with BindRange</param>
+	/// <returns>A pointer to write the data into</returns>
+	uint8_t* Allocate(size_t size, size_t& offset);
+	/// <summary>
+	/// Binds part of this buffer to a uniform block binding point
+	/// </summary>
+	void BindRange(GLuint binding, size_t offset, size_t size) const;
+
+	/// <summary>
+	/// Gets a number that changes whenever the underlying buffer is replaced, offsets from a different generation are
+	/// no longer valid
+	/// </summary>
+	uint32_t GetGeneration() const { return _generation; }
+	/// <summary>
+	/// Gets the number of bytes that can be allocated each frame
+	/// </summary>
+	size_t GetFrameSize() const { return _frameSize; }
+	/// <summary>
+	/// Gets the underlying OpenGL handle that this class is wrapping around
+	/// </summary>
+	GLuint GetHandle() const { return _handle; }
+
+protected:
+	GLuint   _handle;
+	uint8_t* _mapped;
+	size_t   _frameSize;
+	size_t   _alignment;
+	uint32_t _frameCount;
+	uint32_t _frame;
+	size_t   _head;
+	uint32_t _generation;
+	// One fence per section, or nullptr if the GPU is not using that section
+	std::vector<GLsync> _fences;
+
+	void __Allocate(size_t frameSize);
+	void __Release();
+};
@@ -0,0 +1,45 @@
+#include "AssetBaker.h"
+#include "ObjLoader.h"
+#include "BakedMesh.h"
+#include "BakedTexture.h"
+#include "Logging.h"
+
+#include <filesystem>
+
+int AssetBaker::BakeModels(const std::string& folder)
+{
+	int failures = 0;
+	for (const auto& entry : std::filesystem::directory_iterator(folder)) {
+		if (entry.path().extension() != ".obj") continue;
+
+		std::string source = entry.path().string();
+		if (BakedMesh::IsUpToDate(BakedMesh::GetBakedPath(source), source)) continue;
+
+		try {
+			if (!ObjLoader::BakeFile(source)) {
+				failures++;
+			}
+		}
+		catch (const std::exception& e) {
+			LOG_WARN("Failed to bake \"{}\": {}", source, e.what());
+			failures++;
+		}
+	}
+	return failures;
+}
+
+int AssetBaker::BakeTextures(const std::string& folder)
+{
+	int failures = 0;
+	for (const auto& entry : std::filesystem::directory_iterator(folder)) {
+		if (entry.path().extension() != ".png") continue;
+
+		std::string source = entry.path().string();
+		if (BakedTexture::IsUpToDate(BakedTexture::GetBakedPath(source), source)) continue;
+
+		if (!BakedTexture::BakeFile(source)) {
+			failures++;
+		}
+	}
+	return failures;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <string>
+
+/// <summary>
+/// Bakes the game's source assets into the formats we load at runtime. Shared by "GDW --bake" and the standalone
+/// AssetBaker tool in samples/Tools, neither of which needs a window or an OpenGL context. Assets whose baked file is
+/// complete and was made from the current contents of the source are skipped
+/// </summary>
+class AssetBaker
+{
+public:
+	/// <summary>
+	/// Bakes every OBJ file in a folder into our binary mesh format, so that the game doesn't have to parse them at startup
+	/// </summary>
+	/// <param name="folder">The folder holding the models, usually "Models" in the resource directory</param>
+	/// <returns>The number of models that failed to bake</returns>
+	static int BakeModels(const std::string& folder);
+
+	/// <summary>
+	/// Bakes every PNG in a folder into a block compressed DDS with a full mip chain, so that textures can be uploaded
+	/// without decoding or generating mips at startup
+	/// </summary>
+	/// <param name="folder">The folder holding the textures, usually "Textures" in the resource directory</param>
+	/// <returns>The number of textures that failed to bake</returns>
+	static int BakeTextures(const std::string& folder);
+
+protected:
+	AssetBaker() = default;
+	~AssetBaker() = default;
+};
@@ -0,0 +1,230 @@
+#include "AssetLoader.h"
+#include "ObjLoader.h"
+#include "BakedMesh.h"
+#include "BakedTexture.h"
+#include "Logging.h"
+
+#include <chrono>
+#include <stb_image.h>
+
+ThreadPool::Sptr AssetLoader::__workers = nullptr;
+std::deque<AssetLoader::Upload> AssetLoader::__uploads;
+std::mutex AssetLoader::__uploadMutex;
+std::condition_variable AssetLoader::__uploadAvailable;
+std::atomic<size_t> AssetLoader::__pending(0);
+
+void AssetLoader::Init(uint32_t numThreads)
+{
+	if (__workers != nullptr) {
+		return;
+	}
+
+	// This flag is global in stb_image, so we set it once here rather than from every worker. All of our textures
+	// are loaded flipped, so this matches what Texture2D does
+	stbi_set_flip_vertically_on_load(true);
+
+	__workers = ThreadPool::Create(numThreads);
+	LOG_INFO("Asset loader started with {} worker threads", __workers->GetThreadCount());
+}
+
+void AssetLoader::Shutdown()
+{
+	if (__workers == nullptr) {
+		return;
+	}
+
+	Flush();
+	__workers = nullptr;
+}
+
+AssetLoader::Handle<VertexArrayObject::Sptr> AssetLoader::LoadMesh(const std::string& filename)
+{
+	std::shared_ptr<std::promise<VertexArrayObject::Sptr>> promise = std::make_shared<std::promise<VertexArrayObject::Sptr>>();
+	Handle<VertexArrayObject::Sptr> result = promise->get_future().share();
+
+	__Enqueue([filename, promise]() {
+		try {
+			// Prefer the baked copy, mapping it is all the work we need to do on this thread
+			std::string bakedPath = BakedMesh::GetBakedPath(filename);
+			std::shared_ptr<MappedFile> baked = nullptr;
+			if (BakedMesh::IsUpToDate(bakedPath, filename)) {
+				baked = BakedMesh::Open(bakedPath);
+			}
+
+			std::shared_ptr<ObjLoader::MeshData> data = nullptr;
+			if (baked == nullptr) {
+				data = std::make_shared<ObjLoader::MeshData>();
+				ObjLoader::ParseFile(filename, *data);
+				BakedMesh::Write(bakedPath, filename, data->Vertices, data->Indices, data->BoundsMin, data->BoundsMax, data->BoundsRadius);
+			}
+
+			__PostUpload([promise, baked, data]() {
+				try {
+					promise->set_value(baked != nullptr ? BakedMesh::CreateVao(*baked) : ObjLoader::CreateVao(*data));
+				}
+				catch (...) {
+					promise->set_exception(std::current_exception());
+				}
+			});
+		}
+		catch (...) {
+			promise->set_exception(std::current_exception());
+			__pending--;
+		}
+	});
+
+	return result;
+}
+
+AssetLoader::Handle<Texture2D::Sptr> AssetLoader::LoadTexture(const std::string& filename, const Texture2DDescription& description)
+{
+	std::shared_ptr<std::promise<Texture2D::Sptr>> promise = std::make_shared<std::promise<Texture2D::Sptr>>();
+	Handle<Texture2D::Sptr> result = promise->get_future().share();
+
+	__Enqueue([filename, description, promise]() {
+		try {
+			// If the image has been baked, all we need to do here is map it, the GL thread uploads the compressed levels
+			std::shared_ptr<BakedTexture::Image> baked = std::make_shared<BakedTexture::Image>();
+			std::shared_ptr<MappedFile> bakedFile = BakedTexture::Open(filename, *baked);
+			if (bakedFile != nullptr) {
+				Texture2DDescription desc = description;
+				desc.Width = baked->Width;
+				desc.Height = baked->Height;
+				desc.Format = baked->Format;
+				desc.GenerateMipMaps = desc.GenerateMipMaps && baked->Levels.size() > 1;
+				desc.Filename = filename;
+
+				__PostUpload([promise, desc, baked, bakedFile]() {
+					try {
+						Texture2D::Sptr texture = std::make_shared<Texture2D>(desc);
+						size_t levelCount = desc.GenerateMipMaps ? baked->Levels.size() : 1;
+						for (uint32_t level = 0; level < levelCount; level++) {
+							const BakedTexture::Level& data = baked->Levels[level];
+							texture->LoadCompressedData(level, data.Width, data.Height, data.Data, data.Size);
+						}
+						promise->set_value(texture);
+					}
+					catch (...) {
+						promise->set_exception(std::current_exception());
+					}
+				});
+				return;
+			}
+
+			int width, height, numChannels;
+			const int targetChannels = GetTexelComponentCount(description.FormatHint);
+
+			// stbi hands us a malloc'd buffer, we'll keep it in a shared pointer so it can ride along with the upload
+			std::shared_ptr<uint8_t> pixels(stbi_load(filename.c_str(), &width, &height, &numChannels, targetChannels), stbi_image_free);
+			if (pixels == nullptr) {
+				throw std::runtime_error("STBI Failed to load image from \"" + filename + "\"");
+			}
+
+			// numChannels will store the number of channels in the image on disk, if we overrode that we should use the override value
+			if (targetChannels != 0)
+				numChannels = targetChannels;
+
+			// Fill in the size and format, since the size is set the texture won't try to load the file itself. We keep
+			// the filename so the texture can reload itself if it gets evicted
+			Texture2DDescription desc = description;
+			desc.Width = width;
+			desc.Height = height;
+			desc.Format = GetInternalFormatForChannels8(numChannels);
+			desc.Filename = filename;
+			PixelFormat format = GetPixelFormatForChannels(numChannels);
+
+			__PostUpload([promise, desc, format, pixels]() {
+				try {
+					Texture2D::Sptr texture = std::make_shared<Texture2D>(desc);
+					texture->LoadData(desc.Width, desc.Height, format, PixelType::UByte, pixels.get());
+					promise->set_value(texture);
+				}
+				catch (...) {
+					promise->set_exception(std::current_exception());
+				}
+			});
+		}
+		catch (...) {
+			promise->set_exception(std::current_exception());
+			__pending--;
+		}
+	});
+
+	return result;
+}
+
+size_t AssetLoader::ProcessUploads(float budgetSeconds)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	size_t count = 0;
+	while (__RunUpload()) {
+		count++;
+
+		if (budgetSeconds >= 0.0f) {
+			std::chrono::duration<float> elapsed = std::chrono::high_resolution_clock::now() - start;
+			if (elapsed.count() >= budgetSeconds) {
+				break;
+			}
+		}
+	}
+	return count;
+}
+
+void AssetLoader::Flush()
+{
+	while (__pending > 0) {
+		__WaitForUpload();
+	}
+}
+
+void AssetLoader::__Enqueue(ThreadPool::Job job)
+{
+	__pending++;
+
+	// If we haven't been initialized, we'll just do the work right away. The upload still waits for the GL thread
+	if (__workers == nullptr) {
+		job();
+	} else {
+		__workers->Enqueue(std::move(job));
+	}
+}
+
+void AssetLoader::__PostUpload(Upload upload)
+{
+	{
+		std::lock_guard<std::mutex> lock(__uploadMutex);
+		__uploads.push_back(std::move(upload));
+	}
+	__uploadAvailable.notify_one();
+}
+
+bool AssetLoader::__RunUpload()
+{
+	Upload upload;
+	{
+		std::lock_guard<std::mutex> lock(__uploadMutex);
+		if (__uploads.empty()) {
+			return false;
+		}
+		upload = std::move(__uploads.front());
+		__uploads.pop_front();
+	}
+
+	// Uploads catch their own exceptions and hand them to whoever is waiting on the handle
+	upload();
+	__pending--;
+	return true;
+}
+
+void AssetLoader::__WaitForUpload()
+{
+	if (__RunUpload()) {
+		return;
+	}
+
+	// Nothing is ready yet, sleep until a worker posts something. We use a timeout since failed loads don't post
+	// an upload, they just complete their handle
+	std::unique_lock<std::mutex> lock(__uploadMutex);
+	__uploadAvailable.wait_for(lock, std::chrono::milliseconds(1), []() { return !__uploads.empty(); });
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <string>
+#include <deque>
+#include <mutex>
+#include <future>
+#include <atomic>
+#include <condition_variable>
+#include "ThreadPool.h"
+#include "VertexArrayObject.h"
+#include "Texture2D.h"
+
+/// <summary>
+/// Loads assets in the background. The slow parts of loading (reading files, parsing OBJs and decoding images) are
+/// done on a pool of worker threads, and the finished CPU side data is handed back to the GL thread, which uploads it
+/// when ProcessUploads or Wait is called.
+///
+/// Every load returns a handle that becomes ready once the asset has been uploaded, so a scene can queue up all of
+/// its assets at once and then wait on them as it needs them
+/// </summary>
+class AssetLoader
+{
+public:
+	/// <summary>
+	/// A handle to an asset that is being loaded, call AssetLoader::Wait to get the asset out of it. If loading failed,
+	/// getting the asset will re-throw the exception that caused the failure
+	/// </summary>
+	template <typename T>
+	using Handle = std::shared_future<T>;
+
+	/// <summary>
+	/// Starts the worker threads, must be called from the thread that owns the GL context
+	/// </summary>
+	/// <param name="numThreads">The number of workers to start, or 0 to use one less than the number of cores</param>
+	static void Init(uint32_t numThreads = 0);
+	/// <summary>
+	/// Finishes any loads that are in flight and stops the worker threads
+	/// </summary>
+	static void Shutdown();
+
+	/// <summary>
+	/// Starts loading a mesh from an OBJ file, using its baked copy if it is up to date (see ObjLoader::LoadFromFile)
+	/// </summary>
+	/// <param name="filename">The path to the OBJ file to load</param>
+	static Handle<VertexArrayObject::Sptr> LoadMesh(const std::string& filename);
+	/// <summary>
+	/// Starts loading a texture from an image file
+	/// </summary>
+	/// <param name="filename">The path to the image to load</param>
+	/// <param name="description">The sampler settings for the texture, the size and format will be filled in from the image</param>
+	static Handle<Texture2D::Sptr> LoadTexture(const std::string& filename, const Texture2DDescription& description = Texture2DDescription());
+
+	/// <summary>
+	/// Uploads finished assets to OpenGL, must be called from the GL thread. At least one upload is always done if
+	/// one is ready, so that loading makes progress even with a tiny budget
+	/// </summary>
+	/// <param name="budgetSeconds">The amount of time we can spend uploading, or negative to upload everything that is ready</param>
+	/// <returns>The number of assets that were uploaded</returns>
+	static size_t ProcessUploads(float budgetSeconds = -1.0f);
+
+	/// <summary>
+	/// Blocks until the given asset has been loaded, uploading any assets that finish in the meantime. Must be called
+	/// from the GL thread
+	/// </summary>
+	/// <param name="handle">The handle returned when the load was started</param>
+	/// <returns>The loaded asset</returns>
+	template <typename T>
+	static T Wait(const Handle<T>& handle) {
+		while (handle.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			__WaitForUpload();
+		}
+		return handle.get();
+	}
+
+	/// <summary>
+	/// Blocks until every load that has been started is finished
+	/// </summary>
+	static void Flush();
+
+	/// <summary>
+	/// Gets the number of loads that have been started but not yet uploaded
+	/// </summary>
+	static size_t GetPendingCount() { return __pending; }
+
+protected:
+	AssetLoader() = default;
+	~AssetLoader() = default;
+
+private:
+	typedef std::function<void()> Upload;
+
+	static ThreadPool::Sptr __workers;
+
+	// Uploads that are waiting for the GL thread
+	static std::deque<Upload> __uploads;
+	static std::mutex __uploadMutex;
+	static std::condition_variable __uploadAvailable;
+
+	static std::atomic<size_t> __pending;
+
+	static void __Enqueue(ThreadPool::Job job);
+	static void __PostUpload(Upload upload);
+	static bool __RunUpload();
+	static void __WaitForUpload();
+};
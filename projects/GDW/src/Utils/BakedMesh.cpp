@@ -0,0 +1,178 @@
+#include "BakedMesh.h"
+#include "FileUtils.h"
+#include "Logging.h"
+
+#include <fstream>
+#include <filesystem>
+
+// Rounds an offset up to the next multiple of 16, so that our blobs start on nicely aligned addresses
+static inline uint64_t Align16(uint64_t offset) {
+	return (offset + 15) & ~static_cast<uint64_t>(15);
+}
+
+// Index blobs are either 16 or 32 bit, or missing entirely for non-indexed meshes
+static bool IsValidIndexSize(uint32_t indexSize) {
+	return indexSize == 0 || indexSize == sizeof(uint16_t) || indexSize == sizeof(uint32_t);
+}
+
+
+std::string BakedMesh::GetBakedPath(const std::string& sourcePath)
+{
+	return std::filesystem::path(sourcePath).replace_extension(".bmesh").string();
+}
+
+bool BakedMesh::IsUpToDate(const std::string& bakedPath, const std::string& sourcePath)
+{
+	std::ifstream file(bakedPath, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+
+	Header header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(Header))) {
+		return false;
+	}
+
+	if (header.Magic != MAGIC || header.Version != VERSION || !IsValidIndexSize(header.IndexSize)) {
+		return false;
+	}
+
+	// The index blob is the last thing we write, so a complete file ends exactly where it does
+	std::error_code error;
+	uint64_t size = static_cast<uint64_t>(std::filesystem::file_size(bakedPath, error));
+	if (error || size != header.IndexOffset + static_cast<uint64_t>(header.IndexSize) * header.IndexCount) {
+		return false;
+	}
+
+	uint64_t sourceSize = 0;
+	uint64_t sourceHash = 0;
+	return FileUtils::HashFile(sourcePath, sourceSize, sourceHash) && header.SourceSize == sourceSize && header.SourceHash == sourceHash;
+}
+
+VertexArrayObject::Sptr BakedMesh::Load(const std::string& bakedPath)
+{
+	std::unique_ptr<MappedFile> file = Open(bakedPath);
+	return file != nullptr ? CreateVao(*file) : nullptr;
+}
+
+std::unique_ptr<MappedFile> BakedMesh::Open(const std::string& bakedPath)
+{
+	std::unique_ptr<MappedFile> file = std::make_unique<MappedFile>(bakedPath);
+	if (!file->IsOpen() || file->GetSize() < sizeof(Header)) {
+		LOG_WARN("Could not open baked mesh \"{}\"", bakedPath);
+		return nullptr;
+	}
+
+	const Header& header = *reinterpret_cast<const Header*>(file->GetData());
+
+	// Make sure everything the header points to is actually inside the file, in case we were interrupted while writing
+	uint64_t vertexEnd = header.VertexOffset + static_cast<uint64_t>(header.VertexStride) * header.VertexCount;
+	uint64_t indexEnd = header.IndexOffset + static_cast<uint64_t>(header.IndexSize) * header.IndexCount;
+	uint64_t attributeEnd = header.AttributeOffset + header.AttributeCount * sizeof(Attribute);
+	if (header.Magic != MAGIC || header.Version != VERSION || !IsValidIndexSize(header.IndexSize) ||
+		vertexEnd > file->GetSize() || indexEnd > file->GetSize() || attributeEnd > file->GetSize()) {
+		LOG_WARN("Baked mesh \"{}\" is invalid or truncated", bakedPath);
+		return nullptr;
+	}
+
+	return file;
+}
+
+VertexArrayObject::Sptr BakedMesh::CreateVao(const MappedFile& file)
+{
+	const uint8_t* data = file.GetData();
+	const Header& header = *reinterpret_cast<const Header*>(data);
+
+	// Rebuild our vertex layout from the stored attributes
+	const Attribute* attributes = reinterpret_cast<const Attribute*>(data + header.AttributeOffset);
+	std::vector<BufferAttribute> layout;
+	layout.reserve(header.AttributeCount);
+	for (uint32_t ix = 0; ix < header.AttributeCount; ix++) {
+		const Attribute& attrib = attributes[ix];
+		layout.emplace_back(attrib.Slot, attrib.Size, (AttributeType)attrib.Type, attrib.Stride, attrib.Offset,
+			(AttribUsage)attrib.Usage, attrib.Normalized != 0);
+	}
+
+	// Upload straight out of the mapped file, OpenGL copies the data so the file can be unmapped as soon as we're done
+	VertexBuffer::Sptr vertexBuffer = VertexBuffer::Create();
+	vertexBuffer->LoadData(data + header.VertexOffset, header.VertexStride, header.VertexCount);
+
+	VertexArrayObject::Sptr result = VertexArrayObject::Create();
+	result->AddVertexBuffer(vertexBuffer, layout);
+
+	if (header.IndexSize != 0) {
+		IndexBuffer::Sptr indexBuffer = IndexBuffer::Create();
+		indexBuffer->LoadData(data + header.IndexOffset, header.IndexSize, header.IndexCount,
+			header.IndexSize == sizeof(uint16_t) ? IndexType::UShort : IndexType::UInt);
+		result->SetIndexBuffer(indexBuffer);
+	}
+	result->SetBounds(Bounds(header.BoundsMin, header.BoundsMax, header.BoundsRadius));
+
+	return result;
+}
+
+bool BakedMesh::Write(const std::string& bakedPath, const std::string& sourcePath,
+	const void* vertices, uint32_t vertexStride, uint32_t vertexCount, const std::vector<BufferAttribute>& layout,
+	const std::vector<uint32_t>& indices, const glm::vec3& boundsMin, const glm::vec3& boundsMax, float boundsRadius)
+{
+	Header header = Header();
+	header.Magic = MAGIC;
+	header.Version = VERSION;
+	if (!FileUtils::HashFile(sourcePath, header.SourceSize, header.SourceHash)) {
+		LOG_WARN("Could not read source file \"{}\" for baking", sourcePath);
+		return false;
+	}
+
+	header.VertexStride = vertexStride;
+	header.VertexCount = vertexCount;
+	header.AttributeCount = static_cast<uint32_t>(layout.size());
+	header.IndexSize = indices.empty() ? 0 : (vertexCount <= UINT16_MAX ? sizeof(uint16_t) : sizeof(uint32_t));
+	header.IndexCount = static_cast<uint32_t>(indices.size());
+	header.BoundsMin = boundsMin;
+	header.BoundsMax = boundsMax;
+	header.BoundsRadius = boundsRadius;
+	header.AttributeOffset = Align16(sizeof(Header));
+	header.VertexOffset = Align16(header.AttributeOffset + header.AttributeCount * sizeof(Attribute));
+	header.IndexOffset = Align16(header.VertexOffset + static_cast<uint64_t>(vertexStride) * vertexCount);
+
+	// Written under a temporary name and renamed into place, anyone reading the old file at the same time keeps their copy
+	bool written = FileUtils::WriteAtomic(bakedPath, [&](std::ofstream& file) {
+		// Writes zeroes until the file reaches the given offset
+		const char padding[16] = { 0 };
+		auto padTo = [&](uint64_t offset) {
+			uint64_t position = static_cast<uint64_t>(file.tellp());
+			file.write(padding, offset - position);
+		};
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+		padTo(header.AttributeOffset);
+		for (const BufferAttribute& attrib : layout) {
+			Attribute stored;
+			stored.Slot = attrib.Slot;
+			stored.Size = attrib.Size;
+			stored.Type = (uint32_t)attrib.Type;
+			stored.Normalized = attrib.Normalized ? 1 : 0;
+			stored.Stride = attrib.Stride;
+			stored.Offset = attrib.Offset;
+			stored.Usage = (uint32_t)attrib.Usage;
+			file.write(reinterpret_cast<const char*>(&stored), sizeof(Attribute));
+		}
+
+		padTo(header.VertexOffset);
+		file.write(static_cast<const char*>(vertices), static_cast<std::streamsize>(vertexStride) * vertexCount);
+
+		padTo(header.IndexOffset);
+		if (header.IndexSize == sizeof(uint16_t)) {
+			std::vector<uint16_t> shortIndices(indices.begin(), indices.end());
+			file.write(reinterpret_cast<const char*>(shortIndices.data()), shortIndices.size() * sizeof(uint16_t));
+		} else {
+			file.write(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(uint32_t));
+		}
+	});
+	if (!written) {
+		LOG_WARN("Failed to write baked mesh \"{}\"", bakedPath);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <GLM/glm.hpp>
+#include "VertexArrayObject.h"
+#include "MappedFile.h"
+
+/// <summary>
+/// Reads and writes our binary mesh format (.bmesh). A baked mesh stores the exact bytes that we upload to OpenGL, so
+/// loading one is just mapping the file and handing the vertex and index blobs to our buffers.
+///
+/// Layout (all offsets are from the start of the file):
+///   Header
+///   Attribute[AttributeCount] at AttributeOffset
+///   Vertex blob (VertexStride * VertexCount bytes) at VertexOffset, 16 byte aligned
+///   Index blob (IndexSize * IndexCount bytes) at IndexOffset, 16 byte aligned
+/// </summary>
+class BakedMesh
+{
+public:
+	/// <summary>
+	/// Identifies a baked mesh file, "BMSH"
+	/// </summary>
+	static const uint32_t MAGIC = 0x48534D42;
+	/// <summary>
+	/// Bump this whenever the layout of the file changes, older files will be re-baked
+	/// </summary>
+	static const uint32_t VERSION = 3;
+
+	/// <summary>
+	/// The header at the start of every baked mesh
+	/// </summary>
+	struct Header
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		// The size and content hash of the source file when it was baked, used to detect stale files
+		uint64_t SourceSize;
+		uint64_t SourceHash;
+		uint32_t VertexStride;
+		uint32_t VertexCount;
+		uint32_t AttributeCount;
+		// Size of a single index in bytes (2 or 4), or 0 for a non-indexed mesh
+		uint32_t IndexSize;
+		uint32_t IndexCount;
+		// Object space bounds of the mesh
+		glm::vec3 BoundsMin;
+		glm::vec3 BoundsMax;
+		// Radius of the bounding sphere around the center of the bounds
+		float     BoundsRadius;
+		uint64_t AttributeOffset;
+		uint64_t VertexOffset;
+		uint64_t IndexOffset;
+	};
+
+	/// <summary>
+	/// A BufferAttribute stored with fixed size fields
+	/// </summary>
+	struct Attribute
+	{
+		uint32_t Slot;
+		int32_t  Size;
+		uint32_t Type;
+		uint32_t Normalized;
+		int32_t  Stride;
+		int32_t  Offset;
+		uint32_t Usage;
+	};
+
+	/// <summary>
+	/// Gets the path that the baked copy of a source file should live at (ex: Models/crate.obj -> Models/crate.bmesh)
+	/// </summary>
+	static std::string GetBakedPath(const std::string& sourcePath);
+
+	/// <summary>
+	/// Checks whether a baked file exists, is a version we can read, is complete, and was baked from the current contents
+	/// of the source
+	/// </summary>
+	/// <param name="bakedPath">The path to the baked mesh</param>
+	/// <param name="sourcePath">The path to the file it was baked from</param>
+	static bool IsUpToDate(const std::string& bakedPath, const std::string& sourcePath);
+
+	/// <summary>
+	/// Maps a baked mesh and uploads it into a new VAO, directly from the mapped pages
+	/// </summary>
+	/// <param name="bakedPath">The path to the baked mesh</param>
+	/// <returns>The loaded mesh, or nullptr if the file could not be read</returns>
+	static VertexArrayObject::Sptr Load(const std::string& bakedPath);
+
+	/// <summary>
+	/// Maps a baked mesh and checks that it is valid, without touching OpenGL (safe to call from worker threads)
+	/// </summary>
+	/// <param name="bakedPath">The path to the baked mesh</param>
+	/// <returns>The mapped file, or nullptr if the file could not be read or is invalid</returns>
+	static std::unique_ptr<MappedFile> Open(const std::string& bakedPath);
+
+	/// <summary>
+	/// Uploads a baked mesh that was mapped with Open into a new VAO
+	/// </summary>
+	/// <param name="file">The mapped baked mesh</param>
+	static VertexArrayObject::Sptr CreateVao(const MappedFile& file);
+
+	/// <summary>
+	/// Writes a baked mesh to disk
+	/// </summary>
+	/// <param name="bakedPath">The path to write the mesh to</param>
+	/// <param name="sourcePath">The path of the file the mesh came from, used for staleness checks</param>
+	/// <param name="vertices">The vertex data to store</param>
+	/// <param name="vertexStride">The size of a single vertex in bytes</param>
+	/// <param name="vertexCount">The number of vertices to store</param>
+	/// <param name="layout">The vertex attributes of the vertex data</param>
+	/// <param name="indices">The triangle indices, these will be stored as 16 bit when possible</param>
+	/// <param name="boundsMin">The minimum corner of the mesh's bounding box</param>
+	/// <param name="boundsMax">The maximum corner of the mesh's bounding box</param>
+	/// <param name="boundsRadius">The radius of the mesh's bounding sphere, centered on the bounding box</param>
+	/// <returns>True if the file was written</returns>
+	static bool Write(const std::string& bakedPath, const std::string& sourcePath,
+		const void* vertices, uint32_t vertexStride, uint32_t vertexCount, const std::vector<BufferAttribute>& layout,
+		const std::vector<uint32_t>& indices, const glm::vec3& boundsMin, const glm::vec3& boundsMax, float boundsRadius);
+
+	/// <summary>
+	/// Writes a baked mesh to disk, using the vertex type's V_DECL as the layout
+	/// </summary>
+	template <typename VertType>
+	static bool Write(const std::string& bakedPath, const std::string& sourcePath,
+		const std::vector<VertType>& vertices, const std::vector<uint32_t>& indices, const glm::vec3& boundsMin, const glm::vec3& boundsMax, float boundsRadius) {
+		return Write(bakedPath, sourcePath, vertices.data(), sizeof(VertType), static_cast<uint32_t>(vertices.size()), VertType::V_DECL,
+			indices, boundsMin, boundsMax, boundsRadius);
+	}
+
+protected:
+	BakedMesh() = default;
+	~BakedMesh() = default;
+};
@@ -0,0 +1,264 @@
+#include "BakedTexture.h"
+#include "BlockCompression.h"
+#include "FileUtils.h"
+#include "Logging.h"
+
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <stb_image.h>
+
+// Builds a little endian four character code
+static constexpr uint32_t MakeFourCC(char a, char b, char c, char d) {
+	return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) | (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+}
+
+static const uint32_t DDS_MAGIC = MakeFourCC('D', 'D', 'S', ' ');
+static const uint32_t FOURCC_DXT1 = MakeFourCC('D', 'X', 'T', '1');
+static const uint32_t FOURCC_DXT5 = MakeFourCC('D', 'X', 'T', '5');
+// Marks a DDS file as one of ours, so we know the reserved fields hold our source stamp
+static const uint32_t BAKE_TAG = MakeFourCC('G', 'D', 'W', 'B');
+
+// See https://docs.microsoft.com/en-us/windows/win32/direct3ddds/dds-header
+static const uint32_t DDSD_CAPS = 0x1, DDSD_HEIGHT = 0x2, DDSD_WIDTH = 0x4, DDSD_PIXELFORMAT = 0x1000;
+static const uint32_t DDSD_MIPMAPCOUNT = 0x20000, DDSD_LINEARSIZE = 0x80000;
+static const uint32_t DDPF_FOURCC = 0x4;
+static const uint32_t DDSCAPS_COMPLEX = 0x8, DDSCAPS_TEXTURE = 0x1000, DDSCAPS_MIPMAP = 0x400000;
+
+struct DdsPixelFormat
+{
+	uint32_t Size;
+	uint32_t Flags;
+	uint32_t FourCC;
+	uint32_t RgbBitCount;
+	uint32_t RedMask;
+	uint32_t GreenMask;
+	uint32_t BlueMask;
+	uint32_t AlphaMask;
+};
+
+struct DdsHeader
+{
+	uint32_t Magic;
+	uint32_t Size;
+	uint32_t Flags;
+	uint32_t Height;
+	uint32_t Width;
+	uint32_t PitchOrLinearSize;
+	uint32_t Depth;
+	uint32_t MipMapCount;
+	// We keep our bake tag, version and source stamp in the reserved space
+	uint32_t BakeTag;
+	uint32_t BakeVersion;
+	uint64_t SourceSize;
+	uint64_t SourceHash;
+	uint32_t Reserved1[5];
+	DdsPixelFormat PixelFormat;
+	uint32_t Caps;
+	uint32_t Caps2;
+	uint32_t Caps3;
+	uint32_t Caps4;
+	uint32_t Reserved2;
+};
+static_assert(sizeof(DdsHeader) == 128, "DDS header must be 128 bytes (including the magic)");
+
+// Checks that a header is one of ours, and that it was baked from the current version of the source
+static bool IsHeaderUpToDate(const DdsHeader& header, const std::string& sourcePath) {
+	if (header.Magic != DDS_MAGIC || header.BakeTag != BAKE_TAG || header.BakeVersion != BakedTexture::VERSION) {
+		return false;
+	}
+
+	uint64_t sourceSize = 0;
+	uint64_t sourceHash = 0;
+	return FileUtils::HashFile(sourcePath, sourceSize, sourceHash) && header.SourceSize == sourceSize && header.SourceHash == sourceHash;
+}
+
+// Gets the number of bytes in a single level of a block compressed texture
+static inline size_t GetLevelSize(uint32_t width, uint32_t height, size_t blockSize) {
+	return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+}
+
+// Gets the size a complete baked file with this header should have, header included, or 0 if we can't read its format
+static size_t GetBakedFileSize(const DdsHeader& header) {
+	size_t blockSize = 0;
+	if (header.PixelFormat.FourCC == FOURCC_DXT1) {
+		blockSize = GetCompressedBlockSize(InternalFormat::BC1);
+	} else if (header.PixelFormat.FourCC == FOURCC_DXT5) {
+		blockSize = GetCompressedBlockSize(InternalFormat::BC3);
+	} else {
+		return 0;
+	}
+
+	size_t size = sizeof(DdsHeader);
+	uint32_t width = header.Width, height = header.Height;
+	for (uint32_t level = 0; level < std::max(header.MipMapCount, 1u); level++) {
+		size += GetLevelSize(width, height, blockSize);
+		width = std::max(width / 2, 1u);
+		height = std::max(height / 2, 1u);
+	}
+	return size;
+}
+
+std::string BakedTexture::GetBakedPath(const std::string& sourcePath)
+{
+	return std::filesystem::path(sourcePath).replace_extension(".dds").string();
+}
+
+bool BakedTexture::IsUpToDate(const std::string& bakedPath, const std::string& sourcePath)
+{
+	std::ifstream file(bakedPath, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+
+	DdsHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(DdsHeader))) {
+		return false;
+	}
+
+	// A bake that was cut short still has a good header, so make sure every mip level actually made it into the file
+	std::error_code error;
+	uint64_t size = static_cast<uint64_t>(std::filesystem::file_size(bakedPath, error));
+	return !error && size == GetBakedFileSize(header) && IsHeaderUpToDate(header, sourcePath);
+}
+
+std::unique_ptr<MappedFile> BakedTexture::Open(const std::string& sourcePath, Image& result)
+{
+	std::string bakedPath = GetBakedPath(sourcePath);
+	if (!std::filesystem::exists(bakedPath)) {
+		return nullptr;
+	}
+
+	std::unique_ptr<MappedFile> file = std::make_unique<MappedFile>(bakedPath);
+	if (!file->IsOpen() || file->GetSize() < sizeof(DdsHeader)) {
+		return nullptr;
+	}
+
+	const DdsHeader& header = *reinterpret_cast<const DdsHeader*>(file->GetData());
+	if (!IsHeaderUpToDate(header, sourcePath)) {
+		return nullptr;
+	}
+
+	if (header.PixelFormat.FourCC == FOURCC_DXT1) {
+		result.Format = InternalFormat::BC1;
+	} else if (header.PixelFormat.FourCC == FOURCC_DXT5) {
+		result.Format = InternalFormat::BC3;
+	} else {
+		LOG_WARN("Baked texture \"{}\" has an unsupported format", bakedPath);
+		return nullptr;
+	}
+
+	if (file->GetSize() != GetBakedFileSize(header)) {
+		LOG_WARN("Baked texture \"{}\" is truncated", bakedPath);
+		return nullptr;
+	}
+
+	result.Width = header.Width;
+	result.Height = header.Height;
+	result.Levels.clear();
+
+	// Walk the mip chain, we know from the size check above that every level is inside the file
+	const size_t blockSize = GetCompressedBlockSize(result.Format);
+	const uint32_t levelCount = std::max(header.MipMapCount, 1u);
+	size_t offset = sizeof(DdsHeader);
+	uint32_t width = header.Width, height = header.Height;
+	for (uint32_t level = 0; level < levelCount; level++) {
+		size_t size = GetLevelSize(width, height, blockSize);
+		result.Levels.push_back({ width, height, file->GetData() + offset, size });
+		offset += size;
+		width = std::max(width / 2, 1u);
+		height = std::max(height / 2, 1u);
+	}
+
+	return file;
+}
+
+bool BakedTexture::BakeFile(const std::string& sourcePath)
+{
+	// We flip on load to match how the game loads PNGs, so the baked rows are stored bottom to top
+	stbi_set_flip_vertically_on_load(true);
+	int width, height, numChannels;
+	uint8_t* pixels = stbi_load(sourcePath.c_str(), &width, &height, &numChannels, 4);
+	if (pixels == nullptr) {
+		LOG_WARN("STBI Failed to load image from \"{}\"", sourcePath);
+		return false;
+	}
+
+	// Only pay for BC3 if the alpha channel is actually used
+	bool hasAlpha = false;
+	for (size_t ix = 3; ix < static_cast<size_t>(width) * height * 4; ix += 4) {
+		if (pixels[ix] != 255) {
+			hasAlpha = true;
+			break;
+		}
+	}
+
+	DdsHeader header = DdsHeader();
+	header.Magic = DDS_MAGIC;
+	header.Size = sizeof(DdsHeader) - sizeof(uint32_t);
+	header.Flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+	header.Width = width;
+	header.Height = height;
+	header.PitchOrLinearSize = static_cast<uint32_t>(GetLevelSize(width, height, hasAlpha ? 16 : 8));
+	header.BakeTag = BAKE_TAG;
+	header.BakeVersion = VERSION;
+	header.PixelFormat.Size = sizeof(DdsPixelFormat);
+	header.PixelFormat.Flags = DDPF_FOURCC;
+	header.PixelFormat.FourCC = hasAlpha ? FOURCC_DXT5 : FOURCC_DXT1;
+	header.Caps = DDSCAPS_TEXTURE | DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+	if (!FileUtils::HashFile(sourcePath, header.SourceSize, header.SourceHash)) {
+		stbi_image_free(pixels);
+		return false;
+	}
+
+	// Compress every level of the mip chain, down to 1x1, box filtering each level from the one above it
+	std::vector<std::vector<uint8_t>> levels;
+	std::vector<uint8_t> current(pixels, pixels + static_cast<size_t>(width) * height * 4);
+	stbi_image_free(pixels);
+
+	uint32_t levelWidth = width, levelHeight = height;
+	while (true) {
+		levels.push_back(BlockCompression::CompressImage(current.data(), levelWidth, levelHeight, hasAlpha));
+		if (levelWidth == 1 && levelHeight == 1) {
+			break;
+		}
+
+		uint32_t nextWidth = std::max(levelWidth / 2, 1u);
+		uint32_t nextHeight = std::max(levelHeight / 2, 1u);
+		std::vector<uint8_t> next(static_cast<size_t>(nextWidth) * nextHeight * 4);
+		for (uint32_t y = 0; y < nextHeight; y++) {
+			uint32_t y0 = std::min(y * 2, levelHeight - 1), y1 = std::min(y * 2 + 1, levelHeight - 1);
+			for (uint32_t x = 0; x < nextWidth; x++) {
+				uint32_t x0 = std::min(x * 2, levelWidth - 1), x1 = std::min(x * 2 + 1, levelWidth - 1);
+				for (uint32_t channel = 0; channel < 4; channel++) {
+					uint32_t sum =
+						current[(static_cast<size_t>(y0) * levelWidth + x0) * 4 + channel] +
+						current[(static_cast<size_t>(y0) * levelWidth + x1) * 4 + channel] +
+						current[(static_cast<size_t>(y1) * levelWidth + x0) * 4 + channel] +
+						current[(static_cast<size_t>(y1) * levelWidth + x1) * 4 + channel];
+					next[(static_cast<size_t>(y) * nextWidth + x) * 4 + channel] = static_cast<uint8_t>((sum + 2) / 4);
+				}
+			}
+		}
+
+		current.swap(next);
+		levelWidth = nextWidth;
+		levelHeight = nextHeight;
+	}
+	header.MipMapCount = static_cast<uint32_t>(levels.size());
+
+	std::string bakedPath = GetBakedPath(sourcePath);
+	bool written = FileUtils::WriteAtomic(bakedPath, [&](std::ofstream& file) {
+		file.write(reinterpret_cast<const char*>(&header), sizeof(DdsHeader));
+		for (const std::vector<uint8_t>& level : levels) {
+			file.write(reinterpret_cast<const char*>(level.data()), level.size());
+		}
+	});
+	if (!written) {
+		LOG_WARN("Failed to write baked texture \"{}\"", bakedPath);
+		return false;
+	}
+
+	LOG_INFO("Baked \"{}\": {}x{} {}, {} levels", sourcePath, width, height, hasAlpha ? "BC3" : "BC1", levels.size());
+	return true;
+}
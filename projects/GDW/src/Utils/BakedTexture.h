@@ -0,0 +1,80 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include "TextureEnums.h"
+#include "MappedFile.h"
+
+/// <summary>
+/// Reads and writes our baked textures, which are block compressed DDS files with a full mip chain that sit next to
+/// the source image (ex: Textures/crate.png -> Textures/crate.dds). Loading one is just mapping the file and handing
+/// each mip level to glCompressedTextureSubImage2D, there's no decoding or mip generation at runtime.
+///
+/// Baked textures store their rows bottom to top, to match how stb_image flips our PNGs when loading them. The size
+/// and content hash of the source image are kept in the DDS header's reserved space so that stale files can be
+/// detected, the same way BakedMesh does
+/// </summary>
+class BakedTexture
+{
+public:
+	/// <summary>
+	/// Bump this whenever the way we bake textures changes, older files will be re-baked
+	/// </summary>
+	static const uint32_t VERSION = 2;
+
+	/// <summary>
+	/// A single mip level inside of a mapped baked texture
+	/// </summary>
+	struct Level
+	{
+		uint32_t       Width;
+		uint32_t       Height;
+		const uint8_t* Data;
+		size_t         Size;
+	};
+
+	/// <summary>
+	/// Describes the contents of a mapped baked texture, the level data points into the mapped file
+	/// </summary>
+	struct Image
+	{
+		InternalFormat     Format;
+		uint32_t           Width;
+		uint32_t           Height;
+		std::vector<Level> Levels;
+	};
+
+	/// <summary>
+	/// Gets the path that the baked copy of a source image should live at
+	/// </summary>
+	static std::string GetBakedPath(const std::string& sourcePath);
+
+	/// <summary>
+	/// Checks whether a baked texture exists, is a version we can read, has every mip level, and was baked from the
+	/// current contents of the source
+	/// </summary>
+	/// <param name="bakedPath">The path to the baked texture</param>
+	/// <param name="sourcePath">The path to the image it was baked from</param>
+	static bool IsUpToDate(const std::string& bakedPath, const std::string& sourcePath);
+
+	/// <summary>
+	/// Maps the baked copy of the given source image if it exists and is up to date. This does not touch OpenGL, so it
+	/// is safe to call from worker threads
+	/// </summary>
+	/// <param name="sourcePath">The path to the source image</param>
+	/// <param name="result">Filled in with the format and mip levels of the texture, pointing into the mapped file</param>
+	/// <returns>The mapped file, which must be kept alive while result is used, or nullptr if there is no usable baked copy</returns>
+	static std::unique_ptr<MappedFile> Open(const std::string& sourcePath, Image& result);
+
+	/// <summary>
+	/// Loads an image, builds its mip chain, compresses it to BC1 (or BC3 if it has any transparency) and writes the
+	/// baked copy next to it
+	/// </summary>
+	/// <param name="sourcePath">The path to the image to bake</param>
+	/// <returns>True if the baked file was written</returns>
+	static bool BakeFile(const std::string& sourcePath);
+
+protected:
+	BakedTexture() = default;
+	~BakedTexture() = default;
+};
@@ -0,0 +1,205 @@
+#include "BlockCompression.h"
+
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+// Rounds an 8 bit color to 5:6:5
+static inline uint16_t PackRgb565(const float* color) {
+	int r = static_cast<int>(std::round(std::clamp(color[0], 0.0f, 255.0f) * 31.0f / 255.0f));
+	int g = static_cast<int>(std::round(std::clamp(color[1], 0.0f, 255.0f) * 63.0f / 255.0f));
+	int b = static_cast<int>(std::round(std::clamp(color[2], 0.0f, 255.0f) * 31.0f / 255.0f));
+	return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+// Expands a 5:6:5 color back to 8 bits per channel, the same way the GPU will
+static inline void UnpackRgb565(uint16_t packed, float* color) {
+	int r = (packed >> 11) & 31;
+	int g = (packed >> 5) & 63;
+	int b = packed & 31;
+	color[0] = static_cast<float>((r << 3) | (r >> 2));
+	color[1] = static_cast<float>((g << 2) | (g >> 4));
+	color[2] = static_cast<float>((b << 3) | (b >> 2));
+}
+
+static inline void WriteU16(uint8_t* dest, uint16_t value) {
+	dest[0] = static_cast<uint8_t>(value & 0xFF);
+	dest[1] = static_cast<uint8_t>(value >> 8);
+}
+
+// Encodes the color half of a block, this is the whole block for BC1 and the second 8 bytes for BC3
+static void CompressColorBlock(const uint8_t* texels, uint8_t* result) {
+	// Find the average color of the block
+	float mean[3] = { 0.0f, 0.0f, 0.0f };
+	for (int ix = 0; ix < 16; ix++) {
+		mean[0] += texels[ix * 4 + 0];
+		mean[1] += texels[ix * 4 + 1];
+		mean[2] += texels[ix * 4 + 2];
+	}
+	mean[0] /= 16.0f; mean[1] /= 16.0f; mean[2] /= 16.0f;
+
+	// Build the covariance matrix of the colors, its largest eigenvector is the line that best fits the block
+	float cov[6] = { 0.0f };
+	for (int ix = 0; ix < 16; ix++) {
+		float r = texels[ix * 4 + 0] - mean[0];
+		float g = texels[ix * 4 + 1] - mean[1];
+		float b = texels[ix * 4 + 2] - mean[2];
+		cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+		cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+	}
+
+	// A few rounds of power iteration is plenty to find the principal axis
+	float axis[3] = { 1.0f, 1.0f, 1.0f };
+	for (int iteration = 0; iteration < 8; iteration++) {
+		float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+		float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+		float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+		float length = std::max(std::max(std::abs(x), std::abs(y)), std::abs(z));
+		if (length < FLT_EPSILON) {
+			break;
+		}
+		axis[0] = x / length; axis[1] = y / length; axis[2] = z / length;
+	}
+
+	// The texels furthest along the axis in either direction become our endpoints
+	float minDot = FLT_MAX, maxDot = -FLT_MAX;
+	int minIx = 0, maxIx = 0;
+	for (int ix = 0; ix < 16; ix++) {
+		float dot = texels[ix * 4 + 0] * axis[0] + texels[ix * 4 + 1] * axis[1] + texels[ix * 4 + 2] * axis[2];
+		if (dot < minDot) { minDot = dot; minIx = ix; }
+		if (dot > maxDot) { maxDot = dot; maxIx = ix; }
+	}
+
+	// Pull the endpoints in slightly, the extremes are usually outliers and this lowers the average error
+	float maxColor[3], minColor[3];
+	for (int channel = 0; channel < 3; channel++) {
+		float hi = texels[maxIx * 4 + channel];
+		float lo = texels[minIx * 4 + channel];
+		float inset = (hi - lo) / 16.0f;
+		maxColor[channel] = hi - inset;
+		minColor[channel] = lo + inset;
+	}
+
+	uint16_t color0 = PackRgb565(maxColor);
+	uint16_t color1 = PackRgb565(minColor);
+	// color0 > color1 selects the 4 color mode, an equal pair is a solid block
+	if (color0 < color1) {
+		std::swap(color0, color1);
+	}
+
+	WriteU16(result + 0, color0);
+	WriteU16(result + 2, color1);
+
+	uint32_t indices = 0;
+	if (color0 != color1) {
+		float palette[4][3];
+		UnpackRgb565(color0, palette[0]);
+		UnpackRgb565(color1, palette[1]);
+		for (int channel = 0; channel < 3; channel++) {
+			palette[2][channel] = (2.0f * palette[0][channel] + palette[1][channel]) / 3.0f;
+			palette[3][channel] = (palette[0][channel] + 2.0f * palette[1][channel]) / 3.0f;
+		}
+
+		for (int ix = 0; ix < 16; ix++) {
+			uint32_t best = 0;
+			float bestError = FLT_MAX;
+			for (uint32_t entry = 0; entry < 4; entry++) {
+				float r = texels[ix * 4 + 0] - palette[entry][0];
+				float g = texels[ix * 4 + 1] - palette[entry][1];
+				float b = texels[ix * 4 + 2] - palette[entry][2];
+				float error = r * r + g * g + b * b;
+				if (error < bestError) {
+					bestError = error;
+					best = entry;
+				}
+			}
+			indices |= best << (ix * 2);
+		}
+	}
+
+	result[4] = static_cast<uint8_t>(indices);
+	result[5] = static_cast<uint8_t>(indices >> 8);
+	result[6] = static_cast<uint8_t>(indices >> 16);
+	result[7] = static_cast<uint8_t>(indices >> 24);
+}
+
+void BlockCompression::CompressBC1Block(const uint8_t* texels, uint8_t* result)
+{
+	CompressColorBlock(texels, result);
+}
+
+void BlockCompression::CompressBC3Block(const uint8_t* texels, uint8_t* result)
+{
+	uint8_t alpha0 = 0, alpha1 = 255;
+	for (int ix = 0; ix < 16; ix++) {
+		alpha0 = std::max(alpha0, texels[ix * 4 + 3]);
+		alpha1 = std::min(alpha1, texels[ix * 4 + 3]);
+	}
+
+	// alpha0 > alpha1 selects the 8 value mode, six values interpolated between the endpoints
+	result[0] = alpha0;
+	result[1] = alpha1;
+
+	uint64_t indices = 0;
+	if (alpha0 != alpha1) {
+		float palette[8];
+		palette[0] = alpha0;
+		palette[1] = alpha1;
+		for (int entry = 1; entry < 7; entry++) {
+			palette[entry + 1] = ((7 - entry) * alpha0 + entry * alpha1) / 7.0f;
+		}
+
+		for (int ix = 0; ix < 16; ix++) {
+			uint64_t best = 0;
+			float bestError = FLT_MAX;
+			for (uint64_t entry = 0; entry < 8; entry++) {
+				float error = std::abs(texels[ix * 4 + 3] - palette[entry]);
+				if (error < bestError) {
+					bestError = error;
+					best = entry;
+				}
+			}
+			indices |= best << (ix * 3);
+		}
+	}
+
+	for (int byte = 0; byte < 6; byte++) {
+		result[2 + byte] = static_cast<uint8_t>(indices >> (byte * 8));
+	}
+
+	CompressColorBlock(texels, result + 8);
+}
+
+std::vector<uint8_t> BlockCompression::CompressImage(const uint8_t* texels, uint32_t width, uint32_t height, bool hasAlpha)
+{
+	const uint32_t blocksX = (width + 3) / 4;
+	const uint32_t blocksY = (height + 3) / 4;
+	const size_t blockSize = hasAlpha ? 16 : 8;
+
+	std::vector<uint8_t> result(blocksX * blocksY * blockSize);
+	uint8_t block[16 * 4];
+	uint8_t* dest = result.data();
+
+	for (uint32_t by = 0; by < blocksY; by++) {
+		for (uint32_t bx = 0; bx < blocksX; bx++) {
+			// Gather the block, clamping to the edge of the image
+			for (uint32_t y = 0; y < 4; y++) {
+				uint32_t sourceY = std::min(by * 4 + y, height - 1);
+				for (uint32_t x = 0; x < 4; x++) {
+					uint32_t sourceX = std::min(bx * 4 + x, width - 1);
+					const uint8_t* source = texels + (static_cast<size_t>(sourceY) * width + sourceX) * 4;
+					std::copy(source, source + 4, block + (y * 4 + x) * 4);
+				}
+			}
+
+			if (hasAlpha) {
+				CompressBC3Block(block, dest);
+			} else {
+				CompressBC1Block(block, dest);
+			}
+			dest += blockSize;
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// CPU encoders for the S3TC block compressed formats. Every 4x4 block of texels is stored as two endpoint colors and
+/// a small index per texel that picks a color along the line between them, which the GPU decodes for free when
+/// sampling. These are meant for offline baking, not for use at runtime
+/// </summary>
+class BlockCompression
+{
+public:
+	/// <summary>
+	/// Compresses a single 4x4 block of RGBA8 texels into 8 bytes of BC1 (alpha is ignored)
+	/// </summary>
+	/// <param name="texels">16 RGBA8 texels, row by row</param>
+	/// <param name="result">The 8 bytes to write the block into</param>
+	static void CompressBC1Block(const uint8_t* texels, uint8_t* result);
+	/// <summary>
+	/// Compresses a single 4x4 block of RGBA8 texels into 16 bytes of BC3
+	/// </summary>
+	/// <param name="texels">16 RGBA8 texels, row by row</param>
+	/// <param name="result">The 16 bytes to write the block into</param>
+	static void CompressBC3Block(const uint8_t* texels, uint8_t* result);
+
+	/// <summary>
+	/// Compresses an entire RGBA8 image into BC1 or BC3 blocks. Images that are not a multiple of 4 in size have their
+	/// edge texels repeated to fill the last row and column of blocks
+	/// </summary>
+	/// <param name="texels">The RGBA8 image data, row by row</param>
+	/// <param name="width">The width of the image in texels</param>
+	/// <param name="height">The height of the image in texels</param>
+	/// <param name="hasAlpha">True to encode to BC3 and keep the alpha channel, false to encode to BC1</param>
+	/// <returns>The compressed blocks, row by row</returns>
+	static std::vector<uint8_t> CompressImage(const uint8_t* texels, uint32_t width, uint32_t height, bool hasAlpha);
+
+protected:
+	BlockCompression() = default;
+	~BlockCompression() = default;
+};
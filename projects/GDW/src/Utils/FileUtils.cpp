@@ -0,0 +1,100 @@
+#include "FileUtils.h"
+#include "MappedFile.h"
+#include "Logging.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+
+bool FileUtils::WriteAtomic(const std::string& path, const std::function<void(std::ofstream&)>& writer)
+{
+	std::string tempPath = __MakeTempPath(path);
+	bool result = false;
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			LOG_WARN("Could not open \"{}\" for writing", tempPath);
+			return false;
+		}
+		writer(file);
+		file.close();
+		result = !file.fail();
+	}
+
+	std::error_code error;
+	if (result) {
+		std::filesystem::rename(tempPath, path, error);
+		result = !error;
+	}
+	if (!result) {
+		LOG_WARN("Failed to write \"{}\"", path);
+		std::filesystem::remove(tempPath, error);
+	}
+	return result;
+}
+
+std::string FileUtils::GetPathKey(const std::string& path)
+{
+	// weakly_canonical resolves . and .. and makes the path absolute, even if the file doesn't exist
+	std::error_code error;
+	std::filesystem::path result = std::filesystem::weakly_canonical(path, error);
+	if (error) {
+		result = std::filesystem::path(path).lexically_normal();
+	}
+
+	std::string key = result.generic_string();
+	std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	return key;
+}
+
+bool FileUtils::HashFile(const std::string& path, uint64_t& size, uint64_t& hash)
+{
+	// Empty files can't be mapped, but they still have a size and a hash
+	std::error_code error;
+	if (std::filesystem::file_size(path, error) == 0 && !error) {
+		size = 0;
+		hash = Hash(nullptr, 0);
+		return true;
+	}
+
+	MappedFile file(path);
+	if (!file.IsOpen()) {
+		return false;
+	}
+	size = file.GetSize();
+	hash = Hash(file.GetData(), file.GetSize());
+	return true;
+}
+
+uint64_t FileUtils::Hash(const void* data, size_t size)
+{
+	// FNV-1a, but taking 8 bytes at a time so that hashing our bigger models doesn't show up in load times
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	uint64_t hash = 0xcbf29ce484222325ull ^ size;
+	size_t ix = 0;
+	for (; ix + sizeof(uint64_t) <= size; ix += sizeof(uint64_t)) {
+		uint64_t word;
+		memcpy(&word, bytes + ix, sizeof(uint64_t));
+		hash = (hash ^ word) * 0x100000001b3ull;
+	}
+	if (ix < size) {
+		uint64_t word = 0;
+		memcpy(&word, bytes + ix, size - ix);
+		hash = (hash ^ word) * 0x100000001b3ull;
+	}
+
+	// Each word only stirs the bits above it, so mix the high bits back down before handing the hash out
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdull;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+std::string FileUtils::__MakeTempPath(const std::string& path)
+{
+	static std::atomic<uint32_t> counter(0);
+	return path + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + "." + std::to_string(counter++) + ".tmp";
+}
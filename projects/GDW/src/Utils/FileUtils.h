@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+#include <fstream>
+#include <functional>
+#include <cstdint>
+
+/// <summary>
+/// Small helpers for the files we bake and cache on disk
+/// </summary>
+class FileUtils
+{
+public:
+	/// <summary>
+	/// Writes a file by handing a stream to writer, then moves the result into place once writer is done. Until the
+	/// rename, the file at path is untouched, so a crash or a failed write never leaves a partial file behind where a
+	/// later load would pick it up. Safe to call from several threads for the same path, the last one to finish wins
+	/// </summary>
+	/// <param name="path">The path of the file to write</param>
+	/// <param name="writer">Writes the contents of the file to the given stream</param>
+	/// <returns>True if the file was written and moved into place</returns>
+	static bool WriteAtomic(const std::string& path, const std::function<void(std::ofstream&)>& writer);
+
+	/// <summary>
+	/// Turns a path into a key for our asset caches. The path is made absolute with . and .. resolved, uses forward
+	/// slashes, and is lower case since Windows paths are case insensitive, so every way of naming the same file gives
+	/// the same key (ex: "Models/Door2.obj" and "./models/door2.obj")
+	/// </summary>
+	/// <param name="path">The path of the file, it doesn't need to exist</param>
+	static std::string GetPathKey(const std::string& path);
+
+	/// <summary>
+	/// Reads a whole file and hashes its contents. Baked files keep the size and hash of the file they were made from,
+	/// so they go stale when the contents change, and not when the file is just touched, copied or checked out again
+	/// </summary>
+	/// <param name="path">The path of the file to hash</param>
+	/// <param name="size">Set to the size of the file in bytes</param>
+	/// <param name="hash">Set to a 64 bit hash of the file's contents</param>
+	/// <returns>True if the file could be read</returns>
+	static bool HashFile(const std::string& path, uint64_t& size, uint64_t& hash);
+
+	/// <summary>
+	/// Hashes a block of memory, the same way HashFile hashes a file
+	/// </summary>
+	static uint64_t Hash(const void* data, size_t size);
+
+protected:
+	FileUtils() = default;
+	~FileUtils() = default;
+
+	// A name next to path that no other thread is writing to
+	static std::string __MakeTempPath(const std::string& path);
+};
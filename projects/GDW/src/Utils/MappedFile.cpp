@@ -0,0 +1,87 @@
+#include "MappedFile.h"
+
+#ifdef WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path) :
+	_data(nullptr),
+	_size(0),
+	_fileHandle(nullptr),
+	_mappingHandle(nullptr)
+{
+#ifdef WINDOWS
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+		CloseHandle(file);
+		return;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr) {
+		CloseHandle(file);
+		return;
+	}
+
+	_data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (_data == nullptr) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return;
+	}
+
+	_size = static_cast<size_t>(size.QuadPart);
+	_fileHandle = file;
+	_mappingHandle = mapping;
+#else
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0) {
+		return;
+	}
+
+	struct stat info;
+	if (fstat(file, &info) != 0 || info.st_size == 0) {
+		close(file);
+		return;
+	}
+
+	void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	// The mapping stays valid after the descriptor is closed
+	close(file);
+	if (data == MAP_FAILED) {
+		return;
+	}
+
+	_data = static_cast<const uint8_t*>(data);
+	_size = static_cast<size_t>(info.st_size);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+	if (_data == nullptr) {
+		return;
+	}
+
+#ifdef WINDOWS
+	UnmapViewOfFile(_data);
+	CloseHandle(static_cast<HANDLE>(_mappingHandle));
+	CloseHandle(static_cast<HANDLE>(_fileHandle));
+#else
+	munmap(const_cast<uint8_t*>(_data), _size);
+#endif
+	_data = nullptr;
+	_size = 0;
+}
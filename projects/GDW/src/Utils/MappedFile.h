@@ -0,0 +1,43 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include "Macros.h"
+
+/// <summary>
+/// Maps a file into memory as read only, so that it's contents can be read (or handed to OpenGL) straight from the
+/// OS page cache without being copied into our own buffers first
+/// </summary>
+class MappedFile
+{
+public:
+	NO_COPY(MappedFile);
+	NO_MOVE(MappedFile);
+
+	/// <summary>
+	/// Maps the file at the given path, check IsOpen to see if the mapping succeeded
+	/// </summary>
+	/// <param name="path">The path of the file to map</param>
+	MappedFile(const std::string& path);
+	~MappedFile();
+
+	/// <summary>
+	/// Returns true if the file was opened and mapped
+	/// </summary>
+	bool IsOpen() const { return _data != nullptr; }
+	/// <summary>
+	/// Gets a pointer to the start of the mapped file, or nullptr if it failed to map
+	/// </summary>
+	const uint8_t* GetData() const { return _data; }
+	/// <summary>
+	/// Gets the size of the mapped file in bytes
+	/// </summary>
+	size_t GetSize() const { return _size; }
+
+protected:
+	const uint8_t* _data;
+	size_t _size;
+
+	// The OS handles for the file and the mapping (only used on Windows)
+	void* _fileHandle;
+	void* _mappingHandle;
+};
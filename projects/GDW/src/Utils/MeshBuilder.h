@@ -130,6 +130,7 @@ public:
 		VertexArrayObject::Sptr result = VertexArrayObject::Create();
 		result->AddVertexBuffer(vbo, VertType::V_DECL);
 		result->SetIndexBuffer(ebo);
+		result->SetBounds(Bounds::FromVertices(_vertices));
 
 		return result;
 	}
@@ -0,0 +1,73 @@
+#include "MeshCache.h"
+#include "ObjLoader.h"
+#include "FileUtils.h"
+#include "Logging.h"
+
+std::unordered_map<std::string, VertexArrayObject::Sptr> MeshCache::__meshes;
+std::unordered_map<std::string, AssetLoader::Handle<VertexArrayObject::Sptr>> MeshCache::__pending;
+MeshCache::Stats MeshCache::__stats = MeshCache::Stats();
+
+VertexArrayObject::Sptr MeshCache::Load(const std::string& filename)
+{
+	std::string key = FileUtils::GetPathKey(filename);
+
+	auto it = __meshes.find(key);
+	if (it != __meshes.end()) {
+		__stats.Hits++;
+		return it->second;
+	}
+
+	__stats.Misses++;
+	VertexArrayObject::Sptr result = nullptr;
+
+	auto pending = __pending.find(key);
+	if (pending != __pending.end()) {
+		AssetLoader::Handle<VertexArrayObject::Sptr> handle = pending->second;
+		__pending.erase(pending);
+		result = AssetLoader::Wait(handle);
+	} else {
+		result = ObjLoader::LoadFromFile(filename);
+	}
+
+	__meshes[key] = result;
+	return result;
+}
+
+void MeshCache::Prefetch(const std::string& filename)
+{
+	std::string key = FileUtils::GetPathKey(filename);
+	if (__meshes.find(key) == __meshes.end() && __pending.find(key) == __pending.end()) {
+		__pending[key] = AssetLoader::LoadMesh(filename);
+	}
+}
+
+bool MeshCache::Evict(const std::string& filename)
+{
+	if (__meshes.erase(FileUtils::GetPathKey(filename)) > 0) {
+		__stats.Evictions++;
+		return true;
+	}
+	return false;
+}
+
+size_t MeshCache::EvictUnused()
+{
+	size_t count = 0;
+	for (auto it = __meshes.begin(); it != __meshes.end(); ) {
+		// If the cache holds the only reference, nothing is drawing this mesh anymore
+		if (it->second.use_count() == 1) {
+			it = __meshes.erase(it);
+			count++;
+		} else {
+			it++;
+		}
+	}
+	__stats.Evictions += static_cast<uint32_t>(count);
+	return count;
+}
+
+void MeshCache::Clear()
+{
+	__stats.Evictions += static_cast<uint32_t>(__meshes.size());
+	__meshes.clear();
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include "VertexArrayObject.h"
+#include "AssetLoader.h"
+
+/// <summary>
+/// Keeps track of every mesh we've loaded from disk, so that each file is only parsed and uploaded once no matter how
+/// many entities use it. Meshes are keyed by their canonical path, ignoring case, so "Models/crate.obj",
+/// "./Models/crate.obj" and "Models/Crate.obj" are the same entry
+/// </summary>
+class MeshCache
+{
+public:
+	/// <summary>
+	/// Counters for how the cache has been used, useful for seeing how much duplication a scene has
+	/// </summary>
+	struct Stats {
+		uint32_t Hits;
+		uint32_t Misses;
+		uint32_t Evictions;
+	};
+
+	/// <summary>
+	/// Gets the mesh for the given file, loading it with the ObjLoader if it has not been loaded yet
+	/// </summary>
+	/// <param name="filename">The path to the OBJ file to load</param>
+	/// <returns>The shared VAO for the file</returns>
+	static VertexArrayObject::Sptr Load(const std::string& filename);
+	/// <summary>
+	/// Starts loading a mesh in the background with the AssetLoader, so that a later call to Load only has to wait for
+	/// it instead of parsing the file itself. Does nothing if the mesh is already loaded or loading
+	/// </summary>
+	/// <param name="filename">The path to the OBJ file to load</param>
+	static void Prefetch(const std::string& filename);
+
+	/// <summary>
+	/// Removes a mesh from the cache. Any entities still using the VAO will keep it alive until they are done with it
+	/// </summary>
+	/// <param name="filename">The path that the mesh was loaded with</param>
+	/// <returns>True if the mesh was in the cache</returns>
+	static bool Evict(const std::string& filename);
+	/// <summary>
+	/// Removes all meshes that are only being kept alive by the cache
+	/// </summary>
+	/// <returns>The number of meshes that were removed</returns>
+	static size_t EvictUnused();
+	/// <summary>
+	/// Removes all meshes from the cache
+	/// </summary>
+	static void Clear();
+
+	/// <summary>
+	/// Gets the number of meshes currently in the cache
+	/// </summary>
+	static size_t GetSize() { return __meshes.size(); }
+	/// <summary>
+	/// Gets the hit, miss and eviction counters for the cache
+	/// </summary>
+	static const Stats& GetStats() { return __stats; }
+	/// <summary>
+	/// Resets the hit, miss and eviction counters to zero
+	/// </summary>
+	static void ResetStats() { __stats = Stats(); }
+
+protected:
+	MeshCache() = default;
+	~MeshCache() = default;
+
+private:
+	static std::unordered_map<std::string, VertexArrayObject::Sptr> __meshes;
+	// Meshes that have been prefetched but not yet asked for
+	static std::unordered_map<std::string, AssetLoader::Handle<VertexArrayObject::Sptr>> __pending;
+	static Stats __stats;
+};
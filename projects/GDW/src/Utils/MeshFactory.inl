@@ -490,7 +490,7 @@ void MeshFactory::AddPlane(MeshBuilder<Vertex>& mesh, const glm::vec3& pos, cons
 		glm::vec2(1.0f, 0.0f), // 3
 	};
 
-	Vertex verts[4]
+	Vertex verts[4];
 	for(int ix = 0; ix < 4; ix++) {
 		vMap.SetPosition(verts[ix], positions[ix]);
 		vMap.SetNormal(verts[ix], nNorm);
@@ -1,127 +1,336 @@
 #include "ObjLoader.h"
+#include "BakedMesh.h"
+#include "MappedFile.h"
 
 #include <string>
-#include <sstream>
-#include <fstream>
-#include <iostream>
-
-// Borrowed from https://stackoverflow.com/questions/216823/whats-the-best-way-to-trim-stdstring
-#pragma region String Trimming
-
-// trim from start (in place)
-static inline void ltrim(std::string& s) {
-	s.erase(s.begin(), std::find_if(s.begin(), s.end(), [](int ch) {
-		return !std::isspace(ch);
-		}));
+#include <cmath>
+#include <climits>
+#include <filesystem>
+#include "Logging.h"
+
+#pragma region Tokenizing
+
+// The OBJ files we ship are several megabytes of text, so rather than going through operator>> for every token
+// we map the whole file into memory and walk it with a pointer, parsing numbers by hand
+
+// Returns true if the character is a space or tab (but not a line break)
+static inline bool IsBlank(char c) {
+	return c == ' ' || c == '\t';
+}
+
+// Advances the cursor past any spaces or tabs on the current line
+static inline void SkipBlanks(const char*& cursor, const char* end) {
+	while (cursor < end && IsBlank(*cursor)) cursor++;
 }
 
-// trim from end (in place)
-static inline void rtrim(std::string& s) {
-	s.erase(std::find_if(s.rbegin(), s.rend(), [](int ch) {
-		return !std::isspace(ch);
-		}).base(), s.end());
+// Advances the cursor to the first character of the next line
+static inline void SkipLine(const char*& cursor, const char* end) {
+	while (cursor < end && *cursor != '\n') cursor++;
+	if (cursor < end) cursor++;
 }
 
-// trim from both ends (in place)
-static inline void trim(std::string& s) {
-	ltrim(s);
-	rtrim(s);
+// Parses a signed integer, returning false if there were no digits at the cursor
+static inline bool ParseInt(const char*& cursor, const char* end, int& result) {
+	bool negative = false;
+	if (cursor < end && (*cursor == '-' || *cursor == '+')) {
+		negative = *cursor == '-';
+		cursor++;
+	}
+
+	const char* start = cursor;
+	int value = 0;
+	while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+		// Anything this big is out of range for every list we index, saturate instead of overflowing
+		value = value < (INT_MAX - 9) / 10 ? value * 10 + (*cursor - '0') : INT_MAX;
+		cursor++;
+	}
+
+	result = negative ? -value : value;
+	return cursor != start;
 }
 
-#pragma endregion 
+// Parses a float in the forms OBJ exporters write (ex: -1.5, 0.25e-3, 3), skipping any leading blanks
+static inline float ParseFloat(const char*& cursor, const char* end) {
+	// Powers of ten for scaling the digits we read, covers the precision any exporter will write out
+	static const double POW10[] = {
+		1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,
+		1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18
+	};
+
+	SkipBlanks(cursor, end);
+
+	bool negative = false;
+	if (cursor < end && (*cursor == '-' || *cursor == '+')) {
+		negative = *cursor == '-';
+		cursor++;
+	}
+
+	// Accumulate the digits into a single integer, and keep track of the power of ten it needs to be scaled by. Only
+	// the first 18 significant digits are kept, so long runs of digits can't overflow the mantissa (and the digits
+	// after that don't change a float anyways)
+	uint64_t mantissa = 0;
+	int digits = 0;
+	int exponent = 0;
+	while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+		if (digits < 18) {
+			mantissa = mantissa * 10 + (*cursor - '0');
+			digits += mantissa != 0 ? 1 : 0;
+		} else {
+			exponent++;
+		}
+		cursor++;
+	}
+	if (cursor < end && *cursor == '.') {
+		cursor++;
+		while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+			if (digits < 18) {
+				mantissa = mantissa * 10 + (*cursor - '0');
+				digits += mantissa != 0 ? 1 : 0;
+				exponent--;
+			}
+			cursor++;
+		}
+	}
+
+	// Handle scientific notation (some exporters write tiny values as 1.0e-06)
+	if (cursor < end && (*cursor == 'e' || *cursor == 'E')) {
+		cursor++;
+		int power = 0;
+		if (ParseInt(cursor, end, power)) {
+			exponent += power;
+		}
+	}
+
+	double value = static_cast<double>(mantissa);
+	if (exponent < 0 && exponent >= -18) {
+		value /= POW10[-exponent];
+	} else if (exponent > 0 && exponent <= 18) {
+		value *= POW10[exponent];
+	} else if (exponent != 0 && mantissa != 0) {
+		value *= pow(10.0, exponent);
+	}
+
+	return static_cast<float>(negative ? -value : value);
+}
+
+// Resolves a 1-based (or negative, relative to the end) OBJ index into a 0-based index, or -1 if it is invalid
+static inline int ResolveIndex(int index, size_t count) {
+	int result = index > 0 ? index - 1 : static_cast<int>(count) + index;
+	return (index != 0 && result >= 0 && result < static_cast<int>(count)) ? result : -1;
+}
+
+#pragma endregion
 
 VertexArrayObject::Sptr ObjLoader::LoadFromFile(const std::string& filename)
 {
-	// Open our file in binary mode
-	std::ifstream file;
-	file.open(filename, std::ios::binary);
+	// If we've baked this file already, we can skip parsing entirely
+	std::string bakedPath = BakedMesh::GetBakedPath(filename);
+	if (BakedMesh::IsUpToDate(bakedPath, filename)) {
+		VertexArrayObject::Sptr result = BakedMesh::Load(bakedPath);
+		if (result != nullptr) {
+			return result;
+		}
+	}
+
+	MeshData data;
+	ParseFile(filename, data);
 
-	// If our file fails to open, we will throw an error
-	if (!file) {
+	// Write the baked copy so that the next launch can skip parsing
+	BakedMesh::Write(bakedPath, filename, data.Vertices, data.Indices, data.BoundsMin, data.BoundsMax, data.BoundsRadius);
+
+	return CreateVao(data);
+}
+
+void ObjLoader::ParseFile(const std::string& filename, MeshData& result)
+{
+	// Map the whole file, we'll tokenize it straight out of memory. Empty files can't be mapped, but they're still valid
+	MappedFile file(filename);
+	std::error_code error;
+	if (!file.IsOpen() && std::filesystem::file_size(filename, error) != 0) {
+		// If our file fails to open, we will throw an error
 		throw std::runtime_error("Failed to open file");
 	}
 
-	std::string line;
-	
-	// TODO: Load data from file
+	const char* begin = reinterpret_cast<const char*>(file.GetData());
+	const char* end = begin + file.GetSize();
+
+	// Guess how much room our lists need from the size of the file, so they rarely have to grow. Most lines in our
+	// files are between 20 and 40 bytes long, and about half of them are faces that add three or more indices
+	const size_t lineEstimate = file.GetSize() / 32 + 16;
+
 	std::vector<glm::vec3> positions;
 	std::vector<glm::vec2> uvs;
 	std::vector<glm::vec3> nrml;
-	std::vector<glm::vec3> vertecies;
+	positions.reserve(lineEstimate / 3);
+	uvs.reserve(lineEstimate / 3);
+	nrml.reserve(lineEstimate / 3);
 
-	glm::vec3 vecData;
-	glm::ivec3 vertexIndicies;
+	// Every unique (position, uv, normal) combination becomes one vertex, and faces reference them by index
+	std::vector<VertexPosNormTexCol>& vertexData = result.Vertices;
+	std::vector<uint32_t>& indices = result.Indices;
+	vertexData.clear();
+	indices.clear();
+	vertexData.reserve(lineEstimate / 3);
+	indices.reserve(lineEstimate * 2);
 
-	//read abd process whole file 
-	while (file.peek() != EOF)
-	{
-		std::string command;
-		file >> command;
+	// To find corners we've already emitted, we keep a chain of vertices for each position (plus one for corners with
+	// no position). Each vertex remembers the attribute indices it was built from, and the next vertex in its chain.
+	// Positions are rarely shared by more than a few vertices, so the chains stay very short
+	const uint32_t NO_VERTEX = UINT32_MAX;
+	std::vector<uint32_t> firstVertex;
+	uint32_t firstUnpositioned = NO_VERTEX;
+	std::vector<uint32_t> nextVertex;
+	std::vector<glm::ivec3> vertexKeys;
+	firstVertex.reserve(lineEstimate / 3);
+	nextVertex.reserve(lineEstimate / 3);
+	vertexKeys.reserve(lineEstimate / 3);
 
-		if (command == "#")
-		{
-			std::getline(file, line);
-		}
-		else if (command == "vt")
-		{
-			glm::vec2 temp;
+	// Stores the vertex indices for the corners of the face we are currently reading, so we can triangulate quads and n-gons
+	std::vector<uint32_t> corners;
+	corners.reserve(8);
 
-			file >> temp.x >> temp.y;
-			uvs.push_back(temp);
-		}
-		else if (command == "vn")
-		{
-			file >> vecData.x >> vecData.y >> vecData.z;
-			nrml.push_back(vecData);
-		}
-		else if (command == "v")
+	//read and process whole file
+	const char* cursor = begin;
+	while (cursor < end)
+	{
+		SkipBlanks(cursor, end);
+		if (cursor >= end) break;
+
+		if (cursor[0] == 'v' && cursor + 1 < end)
 		{
-			file >> vecData.x >> vecData.y >> vecData.z;
-			positions.push_back(vecData);
+			if (IsBlank(cursor[1]))
+			{
+				cursor += 2;
+				glm::vec3 vecData;
+				vecData.x = ParseFloat(cursor, end);
+				vecData.y = ParseFloat(cursor, end);
+				vecData.z = ParseFloat(cursor, end);
+				positions.push_back(vecData);
+				firstVertex.push_back(NO_VERTEX);
+			}
+			else if (cursor[1] == 't')
+			{
+				cursor += 2;
+				glm::vec2 temp;
+				temp.x = ParseFloat(cursor, end);
+				temp.y = ParseFloat(cursor, end);
+				uvs.push_back(temp);
+			}
+			else if (cursor[1] == 'n')
+			{
+				cursor += 2;
+				glm::vec3 vecData;
+				vecData.x = ParseFloat(cursor, end);
+				vecData.y = ParseFloat(cursor, end);
+				vecData.z = ParseFloat(cursor, end);
+				nrml.push_back(vecData);
+			}
 		}
-		else if (command == "f")
+		else if (cursor[0] == 'f' && cursor + 1 < end && IsBlank(cursor[1]))
 		{
-			std::getline(file, line);
-			trim(line);
-			std::stringstream stream = std::stringstream(line);
+			cursor += 2;
+			corners.clear();
 
-			for (int i = 0; i < 3; i++)
+			// Read every v, v/vt, v//vn or v/vt/vn corner until the end of the line
+			while (true)
 			{
-				char separator;
-				stream >> vertexIndicies.x >> separator >> vertexIndicies.y >> separator >> vertexIndicies.z;
+				SkipBlanks(cursor, end);
 
-				vertexIndicies -= glm::ivec3(1);
+				int value = 0;
+				if (!ParseInt(cursor, end, value)) break;
 
-				vertecies.push_back(vertexIndicies);
+				// We store as (position, uv, normal), with -1 marking a missing attribute
+				glm::ivec3 vertexIndicies = glm::ivec3(ResolveIndex(value, positions.size()), -1, -1);
+				if (cursor < end && *cursor == '/') {
+					cursor++;
+					if (ParseInt(cursor, end, value)) {
+						vertexIndicies.y = ResolveIndex(value, uvs.size());
+					}
+					if (cursor < end && *cursor == '/') {
+						cursor++;
+						if (ParseInt(cursor, end, value)) {
+							vertexIndicies.z = ResolveIndex(value, nrml.size());
+						}
+					}
+				}
+
+				// Re-use the vertex if we've seen this combination before, otherwise add it to the mesh
+				uint32_t& bucket = vertexIndicies.x >= 0 ? firstVertex[vertexIndicies.x] : firstUnpositioned;
+				uint32_t existing = bucket;
+				while (existing != NO_VERTEX && vertexKeys[existing] != vertexIndicies) {
+					existing = nextVertex[existing];
+				}
+
+				if (existing != NO_VERTEX) {
+					corners.push_back(existing);
+				} else {
+					// Extract attributes from lists (except color)
+					glm::vec3 position = vertexIndicies.x >= 0 ? positions[vertexIndicies.x] : glm::vec3(0.0f);
+					glm::vec3 normal = vertexIndicies.z >= 0 ? nrml[vertexIndicies.z] : glm::vec3(0.0f);
+					glm::vec2 uv = vertexIndicies.y >= 0 ? uvs[vertexIndicies.y] : glm::vec2(0.0f);
+					glm::vec4 color = glm::vec4(1.0f);
+
+					uint32_t index = static_cast<uint32_t>(vertexData.size());
+					vertexData.emplace_back(position, normal, uv, color);
+					vertexKeys.push_back(vertexIndicies);
+					nextVertex.push_back(bucket);
+					bucket = index;
+					corners.push_back(index);
+				}
+			}
+
+			// Triangulate the face as a fan around the first corner
+			for (size_t i = 2; i < corners.size(); i++)
+			{
+				indices.push_back(corners[0]);
+				indices.push_back(corners[i - 1]);
+				indices.push_back(corners[i]);
 			}
 		}
+
+		// Anything else (comments, o, s, usemtl, mtllib) is ignored
+		SkipLine(cursor, end);
 	}
 
-	// TODO: Generate mesh from the data we loaded
-	std::vector<VertexPosNormTexCol> vertexData;
+	// Calculate the bounds of the mesh
+	Bounds bounds = Bounds::FromVertices(vertexData);
+	result.BoundsMin = bounds.Min;
+	result.BoundsMax = bounds.Max;
+	result.BoundsRadius = bounds.Radius;
 
-	for (int i = 0; i < vertecies.size(); i++)
-	{
-		glm::ivec3 attribs = vertecies[i];
-		
-		// Extract attributes from lists (except color)
-		glm::vec3 position = positions[attribs.x];
-		glm::vec3 normal = nrml[attribs.z];
-		glm::vec2 uv = uvs[attribs.y];
-		glm::vec4 color = glm::vec4(1.0f);
-		
-		// Add the vertex to the mesh    
-		vertexData.push_back(VertexPosNormTexCol(position, normal, uv, color));
-	}
+	// Report how much we saved compared to emitting a vertex for every face corner
+	LOG_INFO("Loaded \"{}\": {} -> {} vertices, {} KB -> {} KB", filename, indices.size(), vertexData.size(),
+		(indices.size() * sizeof(VertexPosNormTexCol)) / 1024,
+		(vertexData.size() * sizeof(VertexPosNormTexCol) + indices.size() * (vertexData.size() <= UINT16_MAX ? 2 : 4)) / 1024);
+}
 
+VertexArrayObject::Sptr ObjLoader::CreateVao(const MeshData& data)
+{
 	// Create a vertex buffer and load all our vertex data
 	VertexBuffer::Sptr vertexBuffer = VertexBuffer::Create();
-	vertexBuffer->LoadData(vertexData.data(), vertexData.size());
-	
-	// Create the VAO, and add the vertices
+	vertexBuffer->LoadData(data.Vertices.data(), data.Vertices.size());
+
+	// Use 16 bit indices when we can address every vertex with them, it halves the size of the index buffer
+	IndexBuffer::Sptr indexBuffer = IndexBuffer::Create();
+	if (data.Vertices.size() <= UINT16_MAX) {
+		std::vector<uint16_t> shortIndices(data.Indices.begin(), data.Indices.end());
+		indexBuffer->LoadData(shortIndices.data(), shortIndices.size());
+	} else {
+		indexBuffer->LoadData(data.Indices.data(), data.Indices.size());
+	}
+
+	// Create the VAO, and add the vertices and indices
 	VertexArrayObject::Sptr result = VertexArrayObject::Create();
 	result->AddVertexBuffer(vertexBuffer, VertexPosNormTexCol::V_DECL);
+	result->SetIndexBuffer(indexBuffer);
+	result->SetBounds(Bounds(data.BoundsMin, data.BoundsMax, data.BoundsRadius));
 
 	return result;
-	//return VertexArrayObject::Create();
+}
+
+bool ObjLoader::BakeFile(const std::string& filename)
+{
+	MeshData data;
+	ParseFile(filename, data);
+	return BakedMesh::Write(BakedMesh::GetBakedPath(filename), filename, data.Vertices, data.Indices, data.BoundsMin, data.BoundsMax, data.BoundsRadius);
 }
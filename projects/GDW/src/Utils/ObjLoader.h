@@ -2,13 +2,53 @@
 
 #include "MeshBuilder.h"
 #include "MeshFactory.h"
+#include "VertexTypes.h"
 
 class ObjLoader
 {
 public:
+	/// <summary>
+	/// The CPU side data for a mesh loaded from an OBJ file, before it has been uploaded to OpenGL
+	/// </summary>
+	struct MeshData
+	{
+		// One vertex for every unique (position, uv, normal) combination in the file
+		std::vector<VertexPosNormTexCol> Vertices;
+		// Three indices into Vertices per triangle
+		std::vector<uint32_t> Indices;
+		// The object space bounds of all the vertices
+		glm::vec3 BoundsMin = glm::vec3(0.0f);
+		glm::vec3 BoundsMax = glm::vec3(0.0f);
+		// The radius of the bounding sphere around the center of the bounds, negative if the mesh is empty
+		float BoundsRadius = -1.0f;
+	};
+
+	/// <summary>
+	/// Loads a mesh from an OBJ file. If a baked copy of the file exists (see BakedMesh) and is up to date, that will be
+	/// loaded instead, otherwise the OBJ is parsed and a baked copy is written next to it for next time
+	/// </summary>
+	/// <param name="filename">The path to the OBJ file to load</param>
 	static VertexArrayObject::Sptr LoadFromFile(const std::string& filename);
 
+	/// <summary>
+	/// Parses an OBJ file into CPU side mesh data, without touching OpenGL
+	/// </summary>
+	/// <param name="filename">The path to the OBJ file to load</param>
+	/// <param name="result">The mesh data to fill in</param>
+	static void ParseFile(const std::string& filename, MeshData& result);
+
+	/// <summary>
+	/// Uploads parsed mesh data into a new VAO with an index buffer
+	/// </summary>
+	static VertexArrayObject::Sptr CreateVao(const MeshData& data);
+
+	/// <summary>
+	/// Parses an OBJ file and writes its baked copy, without creating any OpenGL objects
+	/// </summary>
+	/// <returns>True if the baked file was written</returns>
+	static bool BakeFile(const std::string& filename);
+
 protected:
 	ObjLoader() = default;
 	~ObjLoader() = default;
-};
\ No newline at end of file
+};
@@ -0,0 +1,86 @@
+#include "ShapeCache.h"
+
+std::map<ShapeCache::ShapeKey, btCollisionShape*> ShapeCache::__primitives;
+std::unordered_map<std::string, std::unique_ptr<ShapeCache::MeshEntry>> ShapeCache::__meshes;
+ShapeCache::Stats ShapeCache::__stats = ShapeCache::Stats();
+
+// The first value of a primitive's key, so that ex: a sphere and a capsule with the same radius don't collide
+static const float BOX_KEY = 0.0f;
+static const float SPHERE_KEY = 1.0f;
+static const float CAPSULE_KEY = 2.0f;
+
+btCollisionShape* ShapeCache::GetBox(const glm::vec3& halfExtents)
+{
+	btCollisionShape*& shape = __primitives[{ BOX_KEY, halfExtents.x, halfExtents.y, halfExtents.z }];
+	if (shape != nullptr) {
+		__stats.Hits++;
+		return shape;
+	}
+
+	__stats.Misses++;
+	shape = new btBoxShape(btVector3(halfExtents.x, halfExtents.y, halfExtents.z));
+	return shape;
+}
+
+btCollisionShape* ShapeCache::GetSphere(float radius)
+{
+	btCollisionShape*& shape = __primitives[{ SPHERE_KEY, radius, 0.0f, 0.0f }];
+	if (shape != nullptr) {
+		__stats.Hits++;
+		return shape;
+	}
+
+	__stats.Misses++;
+	shape = new btSphereShape(radius);
+	return shape;
+}
+
+btCollisionShape* ShapeCache::GetCapsule(float radius, float height)
+{
+	btCollisionShape*& shape = __primitives[{ CAPSULE_KEY, radius, height, 0.0f }];
+	if (shape != nullptr) {
+		__stats.Hits++;
+		return shape;
+	}
+
+	__stats.Misses++;
+	shape = new btCapsuleShape(radius, height);
+	return shape;
+}
+
+void ShapeCache::Clear()
+{
+	for (auto& kvp : __primitives) {
+		delete kvp.second;
+	}
+	__primitives.clear();
+
+	for (auto& kvp : __meshes) {
+		MeshEntry& entry = *kvp.second;
+		for (auto& hull : entry.Hulls) {
+			delete hull.second;
+		}
+		for (auto& mesh : entry.Meshes) {
+			if (mesh.second != entry.TriangleShape) {
+				delete mesh.second;
+			}
+		}
+		delete entry.TriangleShape;
+
+		// A BVH loaded from disk lives inside our buffer, so the shape doesn't own it
+		if (entry.BvhBuffer != nullptr) {
+			static_cast<btOptimizedBvh*>(entry.BvhBuffer)->~btOptimizedBvh();
+			btAlignedFree(entry.BvhBuffer);
+		}
+	}
+	__meshes.clear();
+}
+
+size_t ShapeCache::GetSize()
+{
+	size_t result = __primitives.size();
+	for (auto& kvp : __meshes) {
+		result += kvp.second->Hulls.size() + kvp.second->Meshes.size();
+	}
+	return result;
+}
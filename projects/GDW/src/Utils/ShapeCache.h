@@ -0,0 +1,137 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <GLM/glm.hpp>
+#include "btBulletDynamicsCommon.h"
+
+/// <summary>
+/// Hands out Bullet collision shapes, making sure that bodies with identical shapes share one instead of each getting
+/// their own copy. Primitives are keyed by their exact dimensions, and shapes built from meshes by the canonical path
+/// of their OBJ file (ignoring case, the same as MeshCache) and their scale.
+///
+/// Triangle meshes need a BVH over their triangles, which is slow to build for big meshes. Once built it is saved next
+/// to the OBJ (ex: Models/level.obj -> Models/level.bbvh) and loaded straight back into memory on the next launch, as
+/// long as the OBJ has not changed since.
+///
+/// The cache owns every shape it hands out, they stay alive until Clear is called, so bodies must not delete them
+/// </summary>
+class ShapeCache
+{
+public:
+	/// <summary>
+	/// Identifies a baked BVH file, "BBVH"
+	/// </summary>
+	static const uint32_t BVH_MAGIC = 0x48564242;
+	/// <summary>
+	/// Bump this whenever the layout of the file changes, older files will be rebuilt
+	/// </summary>
+	static const uint32_t BVH_VERSION = 2;
+
+	/// <summary>
+	/// Counters for how the cache has been used
+	/// </summary>
+	struct Stats {
+		uint32_t Hits;
+		uint32_t Misses;
+		// The number of triangle BVHs that were loaded from disk, and that had to be built from scratch
+		uint32_t BvhLoads;
+		uint32_t BvhBuilds;
+	};
+
+	/// <summary>
+	/// Gets a box shape with the given half extents
+	/// </summary>
+	static btCollisionShape* GetBox(const glm::vec3& halfExtents);
+	/// <summary>
+	/// Gets a sphere shape with the given radius
+	/// </summary>
+	static btCollisionShape* GetSphere(float radius);
+	/// <summary>
+	/// Gets a capsule shape along the Y axis
+	/// </summary>
+	/// <param name="radius">The radius of the capsule</param>
+	/// <param name="height">The distance between the centers of the two end caps</param>
+	static btCollisionShape* GetCapsule(float radius, float height);
+
+	/// <summary>
+	/// Gets a convex hull around the vertices of a mesh. Works for dynamic bodies, but any dents in the mesh are filled in
+	/// </summary>
+	/// <param name="filename">The path to the OBJ file to build the hull from</param>
+	/// <param name="scale">The scale to apply to the mesh</param>
+	/// <param name="simplify">If true, the hull is reduced to a few dozen points, which is much faster to collide with and
+	/// close enough for most meshes</param>
+	static btCollisionShape* GetConvexHull(const std::string& filename, const glm::vec3& scale = glm::vec3(1.0f), bool simplify = true);
+	/// <summary>
+	/// Gets a shape made of the exact triangles of a mesh. Bullet can only use these on static and kinematic bodies.
+	/// Every scale of the same mesh shares its triangles and BVH
+	/// </summary>
+	/// <param name="filename">The path to the OBJ file to build the shape from</param>
+	/// <param name="scale">The scale to apply to the mesh</param>
+	static btCollisionShape* GetTriangleMesh(const std::string& filename, const glm::vec3& scale = glm::vec3(1.0f));
+
+	/// <summary>
+	/// Gets the path that the baked BVH of a mesh should live at (ex: Models/level.obj -> Models/level.bbvh)
+	/// </summary>
+	static std::string GetBvhPath(const std::string& sourcePath);
+
+	/// <summary>
+	/// Deletes every shape in the cache, this must only be called once no bodies are using them
+	/// </summary>
+	static void Clear();
+
+	/// <summary>
+	/// Gets the number of shapes currently in the cache
+	/// </summary>
+	static size_t GetSize();
+	/// <summary>
+	/// Gets the hit, miss and BVH counters for the cache
+	/// </summary>
+	static const Stats& GetStats() { return __stats; }
+	/// <summary>
+	/// Resets the counters to zero
+	/// </summary>
+	static void ResetStats() { __stats = Stats(); }
+
+protected:
+	ShapeCache() = default;
+	~ShapeCache() = default;
+
+private:
+	// Identifies a primitive by its type and dimensions, or a scaled mesh shape by its scale
+	typedef std::array<float, 4> ShapeKey;
+
+	/// <summary>
+	/// Everything we keep around for a mesh file. Bullet reads the triangles straight out of Positions and Indices, so
+	/// an entry must not move once shapes have been made from it
+	/// </summary>
+	struct MeshEntry {
+		std::vector<glm::vec3> Positions;
+		std::vector<uint32_t>  Indices;
+		// The points of the full and simplified convex hulls, each is empty until it is asked for
+		std::vector<btVector3> HullPoints;
+		std::vector<btVector3> SimpleHullPoints;
+		std::unique_ptr<btTriangleIndexVertexArray> Triangles;
+		// The unscaled triangle shape, and the buffer its BVH was loaded into (if it came from disk)
+		btBvhTriangleMeshShape* TriangleShape = nullptr;
+		void* BvhBuffer = nullptr;
+		std::map<ShapeKey, btCollisionShape*> Hulls;
+		std::map<ShapeKey, btCollisionShape*> Meshes;
+	};
+
+	static std::map<ShapeKey, btCollisionShape*> __primitives;
+	static std::unordered_map<std::string, std::unique_ptr<MeshEntry>> __meshes;
+	static Stats __stats;
+
+	// Finds or creates the entry for a mesh, loading its vertices. Returns nullptr if the mesh has no triangles
+	static MeshEntry* __GetMesh(const std::string& filename);
+	// Works out the points of a mesh entry's convex hull
+	static void __BuildHull(MeshEntry& entry, bool simplify);
+	// Builds the BVH for a mesh entry's triangle shape, loading it from disk if there is an up to date copy
+	static void __BuildTriangleShape(const std::string& filename, MeshEntry& entry);
+	static bool __LoadBvh(const std::string& bvhPath, const std::string& sourcePath, MeshEntry& entry);
+	static bool __SaveBvh(const std::string& bvhPath, const std::string& sourcePath, const MeshEntry& entry);
+};
@@ -0,0 +1,276 @@
+// The shapes the ShapeCache builds from meshes. They live apart from the primitives in ShapeCache.cpp, since loading
+// meshes brings in the OBJ loader and baked meshes, which code that only needs boxes and spheres can do without
+#include "ShapeCache.h"
+#include "ObjLoader.h"
+#include "BakedMesh.h"
+#include "FileUtils.h"
+#include "Logging.h"
+
+#include <fstream>
+#include <cstring>
+#include <filesystem>
+#include "BulletCollision/CollisionShapes/btShapeHull.h"
+
+// The header at the start of every baked BVH file, the serialized btOptimizedBvh follows at DataOffset
+struct BvhHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+	// The size and content hash of the source file when it was baked, used to detect stale files
+	uint64_t SourceSize;
+	uint64_t SourceHash;
+	// The mesh the BVH was built over, the BVH refers to triangles by index so these must match exactly
+	uint32_t VertexCount;
+	uint32_t IndexCount;
+	uint32_t DataSize;
+	uint32_t DataOffset;
+};
+
+// Rounds an offset up to the next multiple of 16, Bullet needs the serialized BVH to start on an aligned address
+static inline uint32_t Align16(uint32_t offset) {
+	return (offset + 15) & ~static_cast<uint32_t>(15);
+}
+
+// Reads the vertex positions and triangle indices of a mesh, straight out of its baked copy if that is up to date
+static void LoadGeometry(const std::string& filename, std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices) {
+	std::string bakedPath = BakedMesh::GetBakedPath(filename);
+	std::unique_ptr<MappedFile> file = BakedMesh::IsUpToDate(bakedPath, filename) ? BakedMesh::Open(bakedPath) : nullptr;
+	if (file != nullptr) {
+		const uint8_t* data = file->GetData();
+		const BakedMesh::Header& header = *reinterpret_cast<const BakedMesh::Header*>(data);
+		const BakedMesh::Attribute* attributes = reinterpret_cast<const BakedMesh::Attribute*>(data + header.AttributeOffset);
+		for (uint32_t ix = 0; ix < header.AttributeCount; ix++) {
+			if (attributes[ix].Usage != static_cast<uint32_t>(AttribUsage::Position)) {
+				continue;
+			}
+
+			const uint8_t* vertex = data + header.VertexOffset + attributes[ix].Offset;
+			positions.resize(header.VertexCount);
+			for (uint32_t vx = 0; vx < header.VertexCount; vx++, vertex += header.VertexStride) {
+				memcpy(&positions[vx], vertex, sizeof(glm::vec3));
+			}
+
+			indices.resize(header.IndexSize == 0 ? header.VertexCount : header.IndexCount);
+			for (uint32_t jx = 0; jx < indices.size(); jx++) {
+				if (header.IndexSize == sizeof(uint16_t)) {
+					indices[jx] = reinterpret_cast<const uint16_t*>(data + header.IndexOffset)[jx];
+				} else if (header.IndexSize == sizeof(uint32_t)) {
+					indices[jx] = reinterpret_cast<const uint32_t*>(data + header.IndexOffset)[jx];
+				} else {
+					indices[jx] = jx;
+				}
+			}
+			return;
+		}
+	}
+
+	ObjLoader::MeshData mesh;
+	ObjLoader::ParseFile(filename, mesh);
+	positions.resize(mesh.Vertices.size());
+	for (size_t ix = 0; ix < mesh.Vertices.size(); ix++) {
+		positions[ix] = mesh.Vertices[ix].Position;
+	}
+	indices = std::move(mesh.Indices);
+}
+
+btCollisionShape* ShapeCache::GetConvexHull(const std::string& filename, const glm::vec3& scale, bool simplify)
+{
+	MeshEntry* entry = __GetMesh(filename);
+	if (entry == nullptr) {
+		LOG_WARN("Mesh \"{}\" has no triangles, using a box instead of a convex hull", filename);
+		return GetBox(scale * 0.5f);
+	}
+
+	btCollisionShape*& shape = entry->Hulls[{ scale.x, scale.y, scale.z, simplify ? 1.0f : 0.0f }];
+	if (shape != nullptr) {
+		__stats.Hits++;
+		return shape;
+	}
+
+	__stats.Misses++;
+	__BuildHull(*entry, simplify);
+	const std::vector<btVector3>& points = simplify ? entry->SimpleHullPoints : entry->HullPoints;
+	btConvexHullShape* hull = new btConvexHullShape(reinterpret_cast<const btScalar*>(points.data()), static_cast<int>(points.size()));
+	hull->setLocalScaling(btVector3(scale.x, scale.y, scale.z));
+	shape = hull;
+	return shape;
+}
+
+btCollisionShape* ShapeCache::GetTriangleMesh(const std::string& filename, const glm::vec3& scale)
+{
+	MeshEntry* entry = __GetMesh(filename);
+	if (entry == nullptr) {
+		LOG_WARN("Mesh \"{}\" has no triangles, using a box instead of a triangle mesh", filename);
+		return GetBox(scale * 0.5f);
+	}
+
+	btCollisionShape*& shape = entry->Meshes[{ scale.x, scale.y, scale.z, 0.0f }];
+	if (shape != nullptr) {
+		__stats.Hits++;
+		return shape;
+	}
+
+	__stats.Misses++;
+	if (entry->TriangleShape == nullptr) {
+		__BuildTriangleShape(filename, *entry);
+	}
+
+	// Scaling a BVH shape directly would change it for everyone using it, so scaled copies wrap the shared one instead
+	if (scale == glm::vec3(1.0f)) {
+		shape = entry->TriangleShape;
+	} else {
+		shape = new btScaledBvhTriangleMeshShape(entry->TriangleShape, btVector3(scale.x, scale.y, scale.z));
+	}
+	return shape;
+}
+
+std::string ShapeCache::GetBvhPath(const std::string& sourcePath)
+{
+	return std::filesystem::path(sourcePath).replace_extension(".bbvh").string();
+}
+
+ShapeCache::MeshEntry* ShapeCache::__GetMesh(const std::string& filename)
+{
+	std::unique_ptr<MeshEntry>& entry = __meshes[FileUtils::GetPathKey(filename)];
+	if (entry == nullptr) {
+		entry = std::make_unique<MeshEntry>();
+		LoadGeometry(filename, entry->Positions, entry->Indices);
+	}
+	return entry->Indices.size() >= 3 ? entry.get() : nullptr;
+}
+
+void ShapeCache::__BuildHull(MeshEntry& entry, bool simplify)
+{
+	std::vector<btVector3>& points = simplify ? entry.SimpleHullPoints : entry.HullPoints;
+	if (!points.empty()) {
+		return;
+	}
+
+	// Throw away every vertex that isn't on the hull, this alone removes most of a typical mesh
+	btConvexHullShape full(reinterpret_cast<const btScalar*>(entry.Positions.data()), static_cast<int>(entry.Positions.size()), sizeof(glm::vec3));
+	full.optimizeConvexHull();
+
+	if (simplify) {
+		// The shape's margin is added on when the hull is built, and again by the simplified shape, so leave it off here
+		full.setMargin(0.0f);
+		btShapeHull hull(&full);
+		hull.buildHull(0.0f);
+		points.assign(hull.getVertexPointer(), hull.getVertexPointer() + hull.numVertices());
+	} else {
+		points.assign(full.getUnscaledPoints(), full.getUnscaledPoints() + full.getNumPoints());
+	}
+}
+
+void ShapeCache::__BuildTriangleShape(const std::string& filename, MeshEntry& entry)
+{
+	btIndexedMesh mesh;
+	mesh.m_numTriangles = static_cast<int>(entry.Indices.size() / 3);
+	mesh.m_triangleIndexBase = reinterpret_cast<const unsigned char*>(entry.Indices.data());
+	mesh.m_triangleIndexStride = 3 * sizeof(uint32_t);
+	mesh.m_numVertices = static_cast<int>(entry.Positions.size());
+	mesh.m_vertexBase = reinterpret_cast<const unsigned char*>(entry.Positions.data());
+	mesh.m_vertexStride = sizeof(glm::vec3);
+	mesh.m_indexType = PHY_INTEGER;
+	mesh.m_vertexType = PHY_FLOAT;
+
+	entry.Triangles = std::make_unique<btTriangleIndexVertexArray>();
+	entry.Triangles->addIndexedMesh(mesh, PHY_INTEGER);
+
+	// The BVH is left out here, so that we can hand it one from disk instead
+	entry.TriangleShape = new btBvhTriangleMeshShape(entry.Triangles.get(), true, false);
+
+	std::string bvhPath = GetBvhPath(filename);
+	if (__LoadBvh(bvhPath, filename, entry)) {
+		__stats.BvhLoads++;
+		return;
+	}
+
+	__stats.BvhBuilds++;
+	entry.TriangleShape->buildOptimizedBvh();
+	if (__SaveBvh(bvhPath, filename, entry)) {
+		LOG_INFO("Baked BVH for \"{}\" ({} triangles) to \"{}\"", filename, mesh.m_numTriangles, bvhPath);
+	}
+}
+
+bool ShapeCache::__LoadBvh(const std::string& bvhPath, const std::string& sourcePath, MeshEntry& entry)
+{
+	std::ifstream file(bvhPath, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+
+	BvhHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(BvhHeader))) {
+		return false;
+	}
+
+	if (header.Magic != BVH_MAGIC || header.Version != BVH_VERSION ||
+		header.VertexCount != entry.Positions.size() || header.IndexCount != entry.Indices.size()) {
+		return false;
+	}
+
+	// A BVH that got cut short would have Bullet reading off the end of its buffer
+	std::error_code error;
+	uint64_t fileSize = static_cast<uint64_t>(std::filesystem::file_size(bvhPath, error));
+	if (error || fileSize != static_cast<uint64_t>(header.DataOffset) + header.DataSize) {
+		return false;
+	}
+
+	uint64_t sourceSize = 0;
+	uint64_t sourceHash = 0;
+	if (!FileUtils::HashFile(sourcePath, sourceSize, sourceHash) || header.SourceSize != sourceSize || header.SourceHash != sourceHash) {
+		return false;
+	}
+
+	// Bullet fixes up the BVH's pointers in place, so it needs a writable buffer that stays alive as long as the shape
+	void* buffer = btAlignedAlloc(header.DataSize, 16);
+	file.seekg(header.DataOffset);
+	btOptimizedBvh* bvh = nullptr;
+	if (file.read(static_cast<char*>(buffer), header.DataSize)) {
+		bvh = btOptimizedBvh::deSerializeInPlace(buffer, header.DataSize, false);
+	}
+	if (bvh == nullptr) {
+		LOG_WARN("Baked BVH \"{}\" is invalid or truncated", bvhPath);
+		btAlignedFree(buffer);
+		return false;
+	}
+
+	entry.TriangleShape->setOptimizedBvh(bvh);
+	entry.BvhBuffer = buffer;
+	return true;
+}
+
+bool ShapeCache::__SaveBvh(const std::string& bvhPath, const std::string& sourcePath, const MeshEntry& entry)
+{
+	const btOptimizedBvh* bvh = entry.TriangleShape->getOptimizedBvh();
+
+	BvhHeader header = BvhHeader();
+	header.Magic = BVH_MAGIC;
+	header.Version = BVH_VERSION;
+	if (!FileUtils::HashFile(sourcePath, header.SourceSize, header.SourceHash)) {
+		return false;
+	}
+	header.VertexCount = static_cast<uint32_t>(entry.Positions.size());
+	header.IndexCount = static_cast<uint32_t>(entry.Indices.size());
+	header.DataSize = bvh->calculateSerializeBufferSize();
+	header.DataOffset = Align16(sizeof(BvhHeader));
+
+	void* buffer = btAlignedAlloc(header.DataSize, 16);
+	bool result = bvh->serializeInPlace(buffer, header.DataSize, false);
+	if (result) {
+		// Written under a name of our own and then moved into place, so a crash or another thread baking the same
+		// file never leaves a half written BVH where the next load would find it
+		result = FileUtils::WriteAtomic(bvhPath, [&](std::ofstream& file) {
+			const char padding[16] = { 0 };
+			file.write(reinterpret_cast<const char*>(&header), sizeof(BvhHeader));
+			file.write(padding, header.DataOffset - sizeof(BvhHeader));
+			file.write(static_cast<const char*>(buffer), header.DataSize);
+		});
+	}
+	btAlignedFree(buffer);
+
+	if (!result) {
+		LOG_WARN("Could not write baked BVH \"{}\"", bvhPath);
+	}
+	return result;
+}
@@ -0,0 +1,159 @@
+#include "TextureCache.h"
+#include "FileUtils.h"
+#include "Logging.h"
+
+#include <vector>
+#include <algorithm>
+
+std::unordered_map<std::string, Texture2D::Sptr> TextureCache::__textures;
+std::unordered_map<std::string, AssetLoader::Handle<Texture2D::Sptr>> TextureCache::__pending;
+TextureCache::Stats TextureCache::__stats = TextureCache::Stats();
+size_t TextureCache::__budget = 0;
+uint64_t TextureCache::__lastEnforceBind = 0;
+
+Texture2D::Sptr TextureCache::Load(const std::string& filename, const Texture2DDescription& description)
+{
+	std::string key = __GetKey(filename, description);
+
+	auto it = __textures.find(key);
+	if (it != __textures.end()) {
+		__stats.Hits++;
+		return it->second;
+	}
+
+	__stats.Misses++;
+	Texture2D::Sptr result = nullptr;
+
+	auto pending = __pending.find(key);
+	if (pending != __pending.end()) {
+		AssetLoader::Handle<Texture2D::Sptr> handle = pending->second;
+		__pending.erase(pending);
+		result = AssetLoader::Wait(handle);
+	} else {
+		result = Texture2D::LoadFromFile(filename, description);
+	}
+
+	__textures[key] = result;
+	return result;
+}
+
+void TextureCache::Prefetch(const std::string& filename, const Texture2DDescription& description)
+{
+	std::string key = __GetKey(filename, description);
+	if (__textures.find(key) == __textures.end() && __pending.find(key) == __pending.end()) {
+		__pending[key] = AssetLoader::LoadTexture(filename, description);
+	}
+}
+
+bool TextureCache::Evict(const std::string& filename, const Texture2DDescription& description)
+{
+	if (__textures.erase(__GetKey(filename, description)) > 0) {
+		__stats.Evictions++;
+		return true;
+	}
+	return false;
+}
+
+size_t TextureCache::EvictUnused()
+{
+	size_t count = 0;
+	for (auto it = __textures.begin(); it != __textures.end(); ) {
+		// If the cache holds the only reference, no material is using this texture anymore
+		if (it->second.use_count() == 1) {
+			it = __textures.erase(it);
+			count++;
+		} else {
+			it++;
+		}
+	}
+	__stats.Evictions += static_cast<uint32_t>(count);
+	return count;
+}
+
+void TextureCache::Clear()
+{
+	__stats.Evictions += static_cast<uint32_t>(__textures.size());
+	__textures.clear();
+}
+
+size_t TextureCache::GetResidentBytes()
+{
+	size_t bytes = 0;
+	for (const auto& kvp : __textures) {
+		bytes += kvp.second->GetGpuBytes();
+	}
+	return bytes;
+}
+
+size_t TextureCache::EnforceBudget()
+{
+	uint64_t frameStart = __lastEnforceBind;
+	__lastEnforceBind = ITexture::GetBindCounter();
+
+	// The scene reloads what it's about to draw before drawing, but anything bound some other way while it was unloaded
+	// came out blank this frame. Bring those back now instead of ever loading in the middle of a draw
+	for (auto& kvp : __textures) {
+		if (kvp.second->GetLastBind() > frameStart && kvp.second->MakeResident()) {
+			__stats.Reloads++;
+		}
+	}
+
+	if (__budget == 0) {
+		return 0;
+	}
+
+	size_t resident = GetResidentBytes();
+	if (resident <= __budget) {
+		return 0;
+	}
+
+	// Gather everything that could be unloaded, oldest binds first
+	std::vector<std::unordered_map<std::string, Texture2D::Sptr>::iterator> candidates;
+	for (auto it = __textures.begin(); it != __textures.end(); it++) {
+		if (it->second->IsResident() && it->second->GetLastBind() <= frameStart) {
+			candidates.push_back(it);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+		return a->second->GetLastBind() < b->second->GetLastBind();
+	});
+
+	size_t count = 0;
+	for (auto& it : candidates) {
+		if (resident <= __budget) {
+			break;
+		}
+
+		resident -= it->second->GetGpuBytes();
+		count++;
+
+		// If nothing else is using the texture we can drop it completely, otherwise we just free its memory and let
+		// it be reloaded the next time something is about to draw with it
+		if (it->second.use_count() == 1) {
+			__textures.erase(it);
+			__stats.Evictions++;
+		} else {
+			it->second->Unload();
+			__stats.Unloads++;
+		}
+	}
+
+	if (resident > __budget) {
+		LOG_WARN("Textures in use this frame need {} KB, which is over the texture budget of {} KB", resident / 1024, __budget / 1024);
+	}
+	return count;
+}
+
+std::string TextureCache::__GetKey(const std::string& filename, const Texture2DDescription& description)
+{
+	// Size and format come from the image itself, so only the settings we actually pass through are part of the key
+	std::string key = FileUtils::GetPathKey(filename);
+	key += '|' + std::to_string((GLint)description.HorizontalWrap);
+	key += '|' + std::to_string((GLint)description.VerticalWrap);
+	key += '|' + std::to_string((GLint)description.MinificationFilter);
+	key += '|' + std::to_string((GLint)description.MagnificationFilter);
+	key += '|' + std::to_string(description.MaxAnisotropic);
+	key += '|' + std::to_string(description.GenerateMipMaps ? 1 : 0);
+	key += '|' + std::to_string((GLint)description.FormatHint);
+	return key;
+}
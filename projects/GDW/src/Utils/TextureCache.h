@@ -0,0 +1,110 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include "Texture2D.h"
+#include "AssetLoader.h"
+
+/// <summary>
+/// Keeps track of every texture we've loaded from disk, so that each image is only decoded and uploaded once no matter
+/// how many materials use it. Textures are keyed by their canonical path (ignoring case) and the sampler settings in
+/// their description, so the same image with different wrap or filter modes gets its own texture.
+///
+/// The cache can also be given a budget for how much GPU memory its textures may use. When the budget is exceeded,
+/// the textures that were bound least recently are unloaded. Unloaded textures are reloaded from disk once per frame,
+/// before drawing (see SMI_Material::makeTexturesResident) or by EnforceBudget, never while binding
+/// </summary>
+class TextureCache
+{
+public:
+	/// <summary>
+	/// Counters for how the cache has been used
+	/// </summary>
+	struct Stats {
+		uint32_t Hits;
+		uint32_t Misses;
+		// Textures that were removed from the cache entirely
+		uint32_t Evictions;
+		// Textures that had their GPU memory freed to stay within the budget
+		uint32_t Unloads;
+		// Unloaded textures that EnforceBudget reloaded because they were bound anyway
+		uint32_t Reloads;
+	};
+
+	/// <summary>
+	/// Gets the texture for the given file, loading it if it has not been loaded yet
+	/// </summary>
+	/// <param name="filename">The path to the image to load</param>
+	/// <param name="description">The sampler settings for the texture, the size and format are filled in from the image</param>
+	/// <returns>The shared texture for the file</returns>
+	static Texture2D::Sptr Load(const std::string& filename, const Texture2DDescription& description = Texture2DDescription());
+	/// <summary>
+	/// Starts loading a texture in the background with the AssetLoader, so that a later call to Load only has to wait
+	/// for it instead of decoding the image itself. Does nothing if the texture is already loaded or loading
+	/// </summary>
+	/// <param name="filename">The path to the image to load</param>
+	/// <param name="description">The sampler settings for the texture</param>
+	static void Prefetch(const std::string& filename, const Texture2DDescription& description = Texture2DDescription());
+
+	/// <summary>
+	/// Removes a texture from the cache. Any materials still using it will keep it alive until they are done with it
+	/// </summary>
+	/// <returns>True if the texture was in the cache</returns>
+	static bool Evict(const std::string& filename, const Texture2DDescription& description = Texture2DDescription());
+	/// <summary>
+	/// Removes all textures that are only being kept alive by the cache
+	/// </summary>
+	/// <returns>The number of textures that were removed</returns>
+	static size_t EvictUnused();
+	/// <summary>
+	/// Removes all textures from the cache
+	/// </summary>
+	static void Clear();
+
+	/// <summary>
+	/// Sets the amount of GPU memory that cached textures may use, in bytes. A budget of 0 means there is no limit
+	/// </summary>
+	static void SetBudget(size_t bytes) { __budget = bytes; }
+	/// <summary>
+	/// Gets the amount of GPU memory that cached textures may use, in bytes, or 0 if there is no limit
+	/// </summary>
+	static size_t GetBudget() { return __budget; }
+	/// <summary>
+	/// Gets an estimate of the GPU memory currently used by the cached textures, in bytes
+	/// </summary>
+	static size_t GetResidentBytes();
+	/// <summary>
+	/// Unloads the least recently bound textures until we are back within our budget. Textures that have been bound
+	/// since the last call are never unloaded, and are reloaded if they were bound while unloaded, so this should be
+	/// called once per frame after rendering
+	/// </summary>
+	/// <returns>The number of textures that were unloaded or removed</returns>
+	static size_t EnforceBudget();
+
+	/// <summary>
+	/// Gets the number of textures currently in the cache
+	/// </summary>
+	static size_t GetSize() { return __textures.size(); }
+	/// <summary>
+	/// Gets the usage counters for the cache
+	/// </summary>
+	static const Stats& GetStats() { return __stats; }
+	/// <summary>
+	/// Resets the usage counters to zero
+	/// </summary>
+	static void ResetStats() { __stats = Stats(); }
+
+protected:
+	TextureCache() = default;
+	~TextureCache() = default;
+
+private:
+	static std::unordered_map<std::string, Texture2D::Sptr> __textures;
+	// Textures that have been prefetched but not yet asked for
+	static std::unordered_map<std::string, AssetLoader::Handle<Texture2D::Sptr>> __pending;
+	static Stats __stats;
+	static size_t __budget;
+	// The bind counter the last time EnforceBudget ran, anything bound after this is in use this frame
+	static uint64_t __lastEnforceBind;
+
+	static std::string __GetKey(const std::string& filename, const Texture2DDescription& description);
+};
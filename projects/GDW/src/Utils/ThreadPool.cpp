@@ -0,0 +1,87 @@
+#include "ThreadPool.h"
+#include "Logging.h"
+
+ThreadPool::ThreadPool(uint32_t numThreads) :
+	_running(0),
+	_stopping(false)
+{
+	if (numThreads == 0) {
+		// Leave a core free for the thread that created us (usually the one that owns the GL context)
+		uint32_t cores = std::thread::hardware_concurrency();
+		numThreads = cores > 1 ? cores - 1 : 1;
+	}
+
+	_threads.reserve(numThreads);
+	for (uint32_t ix = 0; ix < numThreads; ix++) {
+		_threads.emplace_back(&ThreadPool::_WorkerMain, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_jobAvailable.notify_all();
+
+	for (std::thread& thread : _threads) {
+		thread.join();
+	}
+}
+
+void ThreadPool::Enqueue(Job job)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_jobs.push_back(std::move(job));
+	}
+	_jobAvailable.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_idle.wait(lock, [this]() { return _jobs.empty() && _running == 0; });
+}
+
+size_t ThreadPool::GetPendingCount() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _jobs.size() + _running;
+}
+
+void ThreadPool::_WorkerMain()
+{
+	while (true) {
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_jobAvailable.wait(lock, [this]() { return _stopping || !_jobs.empty(); });
+
+			// We only stop once the queue has been drained, so that nobody is left waiting on a job that never ran
+			if (_jobs.empty()) {
+				return;
+			}
+
+			job = std::move(_jobs.front());
+			_jobs.pop_front();
+			_running++;
+		}
+
+		try {
+			job();
+		}
+		catch (const std::exception& e) {
+			LOG_ERROR("Unhandled exception in worker thread: {}", e.what());
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_running--;
+			if (_running == 0 && _jobs.empty()) {
+				_idle.notify_all();
+			}
+		}
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "Macros.h"
+
+/// <summary>
+/// A fixed set of worker threads that pull jobs off of a shared queue. Jobs are run in the order they were queued, but
+/// may finish in any order, so anything a job touches must either be owned by that job or be thread safe
+/// </summary>
+class ThreadPool
+{
+public:
+	typedef std::shared_ptr<ThreadPool> Sptr;
+	typedef std::function<void()> Job;
+
+	NO_COPY(ThreadPool);
+	NO_MOVE(ThreadPool);
+
+	/// <summary>
+	/// Creates a new thread pool
+	/// </summary>
+	/// <param name="numThreads">The number of worker threads to start, or 0 to use one less than the number of cores</param>
+	static inline Sptr Create(uint32_t numThreads = 0) {
+		return std::make_shared<ThreadPool>(numThreads);
+	}
+
+	ThreadPool(uint32_t numThreads = 0);
+	/// <summary>
+	/// Finishes any queued jobs and joins all the worker threads
+	/// </summary>
+	~ThreadPool();
+
+	/// <summary>
+	/// Adds a job to the back of the queue, it will be run by the next free worker
+	/// </summary>
+	void Enqueue(Job job);
+
+	/// <summary>
+	/// Blocks until the queue is empty and no workers are running a job
+	/// </summary>
+	void Wait();
+
+	/// <summary>
+	/// Gets the number of worker threads in the pool
+	/// </summary>
+	uint32_t GetThreadCount() const { return static_cast<uint32_t>(_threads.size()); }
+	/// <summary>
+	/// Gets the number of jobs that are queued or running
+	/// </summary>
+	size_t GetPendingCount() const;
+
+protected:
+	std::vector<std::thread> _threads;
+	std::deque<Job> _jobs;
+
+	mutable std::mutex _mutex;
+	// Signalled when a job is queued or when we are shutting down
+	std::condition_variable _jobAvailable;
+	// Signalled when the last running job finishes and the queue is empty
+	std::condition_variable _idle;
+
+	uint32_t _running;
+	bool _stopping;
+
+	void _WorkerMain();
+};
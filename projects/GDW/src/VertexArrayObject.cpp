@@ -7,7 +7,8 @@ VertexArrayObject::VertexArrayObject() :
 	_indexBuffer(nullptr),
 	_handle(0),
 	_vertexCount(0),
-	_vertexBuffers(std::vector<VertexBufferBinding>())
+	_vertexBuffers(std::vector<VertexBufferBinding>()),
+	_instanceBuffer(VertexBufferBinding())
 {
 	glCreateVertexArrays(1, &_handle);
 }
@@ -53,14 +54,55 @@ void VertexArrayObject::AddVertexBuffer(const VertexBuffer::Sptr& buffer, const
 	Unbind();
 }
 
+void VertexArrayObject::SetInstanceBuffer(const VertexBuffer::Sptr& buffer, const std::vector<BufferAttribute>& attributes)
+{
+	if (_instanceBuffer.Buffer == buffer) {
+		return;
+	}
+
+	_instanceBuffer.Buffer = buffer;
+	_instanceBuffer.Attributes = attributes;
+
+	Bind();
+	buffer->Bind();
+	for (const BufferAttribute& attrib : attributes) {
+		glEnableVertexArrayAttrib(_handle, attrib.Slot);
+		glVertexAttribPointer(attrib.Slot, attrib.Size, (GLenum)attrib.Type, attrib.Normalized, attrib.Stride,
+							  (void*)attrib.Offset);
+		// Advance this attribute once per instance instead of once per vertex
+		glVertexAttribDivisor(attrib.Slot, 1);
+	}
+	Unbind();
+}
+
 void VertexArrayObject::Draw(DrawMode mode) {
 	Bind();
+	DrawBound(mode);
+	Unbind();
+}
+
+void VertexArrayObject::DrawInstanced(uint32_t instanceCount, uint32_t baseInstance, DrawMode mode) {
+	Bind();
+	DrawInstancedBound(instanceCount, baseInstance, mode);
+	Unbind();
+}
+
+void VertexArrayObject::DrawBound(DrawMode mode) {
 	if (_indexBuffer == nullptr) {
 		glDrawArrays((GLenum)mode, 0, _vertexCount);
 	} else {
 		glDrawElements((GLenum)mode, _indexBuffer->GetElementCount(), (GLenum)_indexBuffer->GetElementType(), nullptr);
 	}
-	Unbind();
+}
+
+void VertexArrayObject::DrawInstancedBound(uint32_t instanceCount, uint32_t baseInstance, DrawMode mode) {
+	// The base instance offsets where the per-instance attributes start reading, so many batches can share one buffer
+	if (_indexBuffer == nullptr) {
+		glDrawArraysInstancedBaseInstance((GLenum)mode, 0, _vertexCount, instanceCount, baseInstance);
+	} else {
+		glDrawElementsInstancedBaseInstance((GLenum)mode, _indexBuffer->GetElementCount(), (GLenum)_indexBuffer->GetElementType(), nullptr,
+			instanceCount, baseInstance);
+	}
 }
 
 void VertexArrayObject::Bind() {
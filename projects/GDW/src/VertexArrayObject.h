@@ -7,6 +7,7 @@
 // We can declare the classes for IndexBuffer and VertexBuffer here, since we don't need their full definitions in the .h file
 #include "VertexBuffer.h"
 #include "IndexBuffer.h"
+#include "Bounds.h"
 
 #include <memory>
 
@@ -142,7 +143,32 @@ public:
 	/// <param name="attributes">A list of vertex attributes that will be fed by this buffer</param>
 	void AddVertexBuffer(const VertexBuffer::Sptr& buffer, const std::vector<BufferAttribute>& attributes);
 
+	/// <summary>
+	/// Sets the buffer that per-instance attributes are read from, these attributes advance once per instance instead of
+	/// once per vertex. Does nothing if the buffer is already this VAO's instance buffer
+	/// </summary>
+	/// <param name="buffer">The buffer holding the per-instance data</param>
+	/// <param name="attributes">A list of per-instance attributes that will be fed by this buffer</param>
+	void SetInstanceBuffer(const VertexBuffer::Sptr& buffer, const std::vector<BufferAttribute>& attributes);
+
 	void Draw(DrawMode mode = DrawMode::TriangleList);
+	/// <summary>
+	/// Draws multiple instances of this VAO in a single draw call, reading per-instance attributes from the instance buffer
+	/// </summary>
+	/// <param name="instanceCount">The number of instances to draw</param>
+	/// <param name="baseInstance">The index of the first instance to read from the instance buffer</param>
+	/// <param name="mode">The primitive type to draw</param>
+	void DrawInstanced(uint32_t instanceCount, uint32_t baseInstance = 0, DrawMode mode = DrawMode::TriangleList);
+	/// <summary>
+	/// Draws this VAO without binding or unbinding it, for when the caller has already bound it (ex: the render queue
+	/// drawing several objects with the same mesh in a row)
+	/// </summary>
+	/// <param name="mode">The primitive type to draw</param>
+	void DrawBound(DrawMode mode = DrawMode::TriangleList);
+	/// <summary>
+	/// Draws multiple instances of this VAO without binding or unbinding it, see DrawInstanced and DrawBound
+	/// </summary>
+	void DrawInstancedBound(uint32_t instanceCount, uint32_t baseInstance = 0, DrawMode mode = DrawMode::TriangleList);
 
 	/// <summary>
 	/// Binds this VAO as the source of data for draw operations
@@ -158,6 +184,15 @@ public:
 	/// Returns the underlying OpenGL handle that this class is wrapping around
 	/// </summary>
 	GLuint GetHandle() const { return _handle; }
+
+	/// <summary>
+	/// Sets the object space bounds of the mesh, used for culling
+	/// </summary>
+	void SetBounds(const Bounds& bounds) { _bounds = bounds; }
+	/// <summary>
+	/// Gets the object space bounds of the mesh, these are invalid if the mesh was built without them
+	/// </summary>
+	const Bounds& GetBounds() const { return _bounds; }
 	
 protected:
 	// Helper structure to store a buffer and the attributes
@@ -171,8 +206,12 @@ protected:
 	IndexBuffer::Sptr _indexBuffer;
 	// The vertex buffers bound to this VAO
 	std::vector<VertexBufferBinding> _vertexBuffers;
+	// The buffer and attributes for per-instance data, if any
+	VertexBufferBinding _instanceBuffer;
 
 	uint32_t _vertexCount;
+	// The object space bounds of the vertices
+	Bounds _bounds;
 
 	// The underlying OpenGL handle that this class is wrapping around
 	GLuint _handle;
@@ -13,12 +13,18 @@
 #include "Player.h"
 #include "Physics.h"
 #include "Scene.h"
+#include "UniformBlocks.h"
 #include "Texture2D.h"
 #include "TextureCube.h"
 
 #include "Utils/MeshBuilder.h"
 #include "Utils/MeshFactory.h"
+#include "Utils/MeshCache.h"
+#include "Utils/TextureCache.h"
+#include "Utils/AssetLoader.h"
 #include "Utils/ObjLoader.h"
+#include "Utils/AssetBaker.h"
+#include "Utils/ShapeCache.h"
 #include "VertexTypes.h"
 
 #include <memory>
@@ -171,14 +177,50 @@ bool loadShaders()
 	return true;
 }
 
-template <typename T>
-//templated LERP to be used for bullets
-T Lerp(T a, T b, float t)
+
+// Every model and texture used by our scenes, these are handed to the asset loader before the scenes are built so that
+// they can be loaded in parallel instead of one at a time as each entity is created
+static const std::vector<std::string> sceneMeshes = {
+	"Models/character.obj", "Models/window1.obj", "Models/wi1.obj", "Models/barrel1.obj",
+	"Models/3barrel.obj", "Models/nba1.obj", "Models/floor3.obj", "Models/Crates1.obj",
+	"Models/warehousedoor.obj", "Models/wdoorway.obj", "Models/btab.obj", "Models/bar_area.obj",
+	"Models/bardoorway.obj", "Models/bardoor.obj", "Models/barbutton.obj", "Models/button.obj",
+	"Models/doortop.obj", "Models/doorwall.obj", "Models/floor1.obj", "Models/bag1.obj",
+	"Models/bag2.obj", "Models/barrelset.obj", "Models/shelf12.obj", "Models/blockedbardoor.obj",
+	"Models/building1.obj", "Models/build4.obj", "Models/car.obj", "Models/floor2.obj",
+	"Models/plank.obj", "Models/Cfan1.obj", "Models/elevator.obj", "Models/railing.obj",
+	"Models/concretepillar.obj", "Models/smallerpillar.obj", "Models/winwalls.obj", "Models/winwalls1.obj",
+	"Models/wood.obj", "Models/inside.obj", "Models/winwalls3.obj",
+	"Models/enemy.obj", "Models/denemy.obj", "Models/bullet.obj", "Models/splank.obj",
+	"Models/plankhold.obj", "Models/spike.obj", "Models/SCrate.obj", "Models/Gdoor.obj",
+	"Models/lasercircle.obj", "Models/Cfan12.obj", "Models/Door2.obj", "Models/wi11.obj",
+	"Models/menu2.obj"
+};
+static const std::vector<std::string> sceneTextures = {
+	"Textures/character1.png", "Textures/brown1.png", "Textures/back.png", "Textures/Barrel.png",
+	"Textures/Untitled.1001.png", "Textures/box32.png", "Textures/doortex.png", "Textures/bricktex.png",
+	"Textures/bartabtex.png", "Textures/tabletex1.png", "Textures/bardoor.png", "Textures/buttontex.png",
+	"Textures/buttontexactivate.png", "Textures/cement.png", "Textures/bag.png", "Textures/shelf.png",
+	"Textures/build.png", "Textures/2build.png", "Textures/car_Tex.png", "Textures/gravel.png",
+	"Textures/spike.png", "Textures/2build texture.png", "Textures/fan.png", "Textures/elevator.png",
+	"Textures/platform.png", "Textures/railing.png", "Textures/inside.png", "Textures/brick1.png",
+	"Textures/lounge.png", "Textures/enemy.png", "Textures/rough.png", "Textures/laserred.png",
+	"Textures/levcleared.png", "Textures/Main_Menu.png", "Textures/Pause_Screen.png"
+};
+
+/// <summary>
+/// Starts loading all of our scene assets on the asset loader's worker threads
+/// </summary>
+void prefetchAssets()
 {
-	return(1.0f - t) * a + b * t;
+	for (const std::string& mesh : sceneMeshes) {
+		MeshCache::Prefetch(mesh);
+	}
+	for (const std::string& texture : sceneTextures) {
+		TextureCache::Prefetch(texture);
+	}
 }
 
-
 class GameScene1 : public SMI_Scene
 {
 public:
@@ -198,6 +240,13 @@ public:
 		shader->LoadShaderPartFromFile("shaders/frag_shader.glsl", ShaderPartType::Fragment);
 		shader->Link();
 
+		// The same shader, but taking the model matrix per instance so the scene can batch objects that share a mesh
+		Shader::Sptr instancedShader = Shader::Create();
+		instancedShader->LoadShaderPartFromFile("shaders/vertex_shader_instanced.glsl", ShaderPartType::Vertex);
+		instancedShader->LoadShaderPartFromFile("shaders/frag_shader.glsl", ShaderPartType::Fragment);
+		instancedShader->Link();
+		shader->SetInstancedVariant(instancedShader);
+
 		// GL states, we'll enable depth testing and backface fulling
 		glEnable(GL_DEPTH_TEST);
 		glEnable(GL_CULL_FACE);
@@ -215,12 +264,12 @@ public:
 		setCamera(camera);
 
 		//create the player character
-		VertexArrayObject::Sptr chara = ObjLoader::LoadFromFile("Models/character.obj");
+		VertexArrayObject::Sptr chara = MeshCache::Load("Models/character.obj");
 		{
 			character = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr CharacterTex = Texture2D::Create("Textures/character1.png");
+			Texture2D::Sptr CharacterTex = TextureCache::Load("Textures/character1.png");
 			//create material
 			SMI_Material::Sptr CharacterMat = SMI_Material::Create();
 			CharacterMat->setShader(shader);
@@ -239,18 +288,20 @@ public:
 
 			SMI_Physics CharaPhys = SMI_Physics(glm::vec3(4, 7.0, 2.3), glm::vec3(90, 0, -90), glm::vec3(2, 1, 1), character, SMI_PhysicsBodyType::DYNAMIC, 1.0f);
 			CharaPhys.setHasGravity(true);
-			CharaPhys.setIdentity(1);
+			CharaPhys.setCollisionLayer(LAYER_PLAYER);
+			//transforms follow their body's rotation, so stop the player from tipping over
+			CharaPhys.getRigidBody()->setAngularFactor(btVector3(0.f, 0.f, 0.f));
 			AttachCopy(character, CharaPhys);
 		}
 
 		//creates object
 		//Bar
-		VertexArrayObject::Sptr vao4 = ObjLoader::LoadFromFile("Models/window1.obj");
+		VertexArrayObject::Sptr vao4 = MeshCache::Load("Models/window1.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr window1Texture = Texture2D::Create("Textures/brown1.png");
+			Texture2D::Sptr window1Texture = TextureCache::Load("Textures/brown1.png");
 			//material
 			SMI_Material::Sptr BarrelMat = SMI_Material::Create();
 			BarrelMat->setShader(shader);
@@ -269,12 +320,12 @@ public:
 			AttachCopy(barrel, BarrelTrans);
 		}
 		//creates object
-		VertexArrayObject::Sptr firstwin = ObjLoader::LoadFromFile("Models/window1.obj");
+		VertexArrayObject::Sptr firstwin = MeshCache::Load("Models/window1.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr firstTexture1 = Texture2D::Create("Textures/brown1.png");
+			Texture2D::Sptr firstTexture1 = TextureCache::Load("Textures/brown1.png");
 			//material
 			SMI_Material::Sptr firstMat = SMI_Material::Create();
 			firstMat->setShader(shader);
@@ -294,12 +345,12 @@ public:
 		}
 		//creates object
       /*
-		VertexArrayObject::Sptr back = ObjLoader::LoadFromFile("Models/wi1.obj");
+		VertexArrayObject::Sptr back = MeshCache::Load("Models/wi1.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr backTexture = Texture2D::Create("Textures/back.png");
+			Texture2D::Sptr backTexture = TextureCache::Load("Textures/back.png");
 			//material
 			SMI_Material::Sptr backMat = SMI_Material::Create();
 			backMat->setShader(shader);
@@ -319,12 +370,12 @@ public:
 		}
 		*/
 		//creates object
-		VertexArrayObject::Sptr window2 = ObjLoader::LoadFromFile("Models/window1.obj");
+		VertexArrayObject::Sptr window2 = MeshCache::Load("Models/window1.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr window2Texture = Texture2D::Create("Textures/brown1.png");
+			Texture2D::Sptr window2Texture = TextureCache::Load("Textures/brown1.png");
 			//material
 			SMI_Material::Sptr window2Mat = SMI_Material::Create();
 			window2Mat->setShader(shader);
@@ -344,13 +395,13 @@ public:
 		}
 
 
-		VertexArrayObject::Sptr vao5 = ObjLoader::LoadFromFile("Models/barrel1.obj");
+		VertexArrayObject::Sptr vao5 = MeshCache::Load("Models/barrel1.obj");
 		{
 
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr BarrelTexture = Texture2D::Create("Textures/Barrel.png");
+			Texture2D::Sptr BarrelTexture = TextureCache::Load("Textures/Barrel.png");
 
 			//material
 			SMI_Material::Sptr BarrelMat1 = SMI_Material::Create();
@@ -370,16 +421,16 @@ public:
 
 			SMI_Physics BarrelPhys = SMI_Physics(glm::vec3(-0.6, 6.2, 2.7), glm::vec3(0, 90, 0), glm::vec3(1.67, 2.59, 2.12), barrel, SMI_PhysicsBodyType::DYNAMIC, 1.0f);
 			BarrelPhys.setHasGravity(true);
-			BarrelPhys.setIdentity(2);
+			BarrelPhys.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, BarrelPhys);
 		}
-		VertexArrayObject::Sptr vao512 = ObjLoader::LoadFromFile("Models/3barrel.obj");
+		VertexArrayObject::Sptr vao512 = MeshCache::Load("Models/3barrel.obj");
 		{
 
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr BarrelTexture12 = Texture2D::Create("Textures/Barrel.png");
+			Texture2D::Sptr BarrelTexture12 = TextureCache::Load("Textures/Barrel.png");
 
 			//material
 			SMI_Material::Sptr BarrelMat112 = SMI_Material::Create();
@@ -401,19 +452,19 @@ public:
 
 			SMI_Physics BarrelPhys = SMI_Physics(glm::vec3(-9.0, 6.0, 3.7), glm::vec3(0, 90, 0), glm::vec3(3, 6, 2), barrel, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
 			BarrelPhys.setHasGravity(true);
-			BarrelPhys.setIdentity(2);
+			BarrelPhys.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, BarrelPhys);
 		}
 
 
 
 
-		VertexArrayObject::Sptr vao7 = ObjLoader::LoadFromFile("Models/nba1.obj");
+		VertexArrayObject::Sptr vao7 = MeshCache::Load("Models/nba1.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr floor1Texture = Texture2D::Create("Textures/Untitled.1001.png");
+			Texture2D::Sptr floor1Texture = TextureCache::Load("Textures/Untitled.1001.png");
 			//material
 			SMI_Material::Sptr BarrelMat3 = SMI_Material::Create();
 			BarrelMat3->setShader(shader);
@@ -432,15 +483,15 @@ public:
 			AttachCopy(barrel, BarrelTrans3);
 
 			SMI_Physics GroundPhys = SMI_Physics(glm::vec3(-0.85, 0, 0.8), glm::vec3(90, 0, 90), glm::vec3(15.3, 3.32, 11.8), barrel, SMI_PhysicsBodyType::KINEMATIC, 0.0f);
-			GroundPhys.setIdentity(2);
+			GroundPhys.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, GroundPhys);
 		}
-		VertexArrayObject::Sptr onevao7 = ObjLoader::LoadFromFile("Models/nba1.obj");
+		VertexArrayObject::Sptr onevao7 = MeshCache::Load("Models/nba1.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr onefloor1Texture = Texture2D::Create("Textures/Untitled.1001.png");
+			Texture2D::Sptr onefloor1Texture = TextureCache::Load("Textures/Untitled.1001.png");
 			//material
 			SMI_Material::Sptr oneBarrelMat3 = SMI_Material::Create();
 			oneBarrelMat3->setShader(shader);
@@ -459,15 +510,15 @@ public:
 			AttachCopy(barrel, oneBarrelTrans3);
 
 			SMI_Physics GroundPhys = SMI_Physics(glm::vec3(-0.85, 15.3, 0.8), glm::vec3(90, 0, 90), glm::vec3(15.3, 3.32, 11.8), barrel, SMI_PhysicsBodyType::KINEMATIC, 0.0f);
-			GroundPhys.setIdentity(2);
+			GroundPhys.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, GroundPhys);
 		}
-		VertexArrayObject::Sptr vao8 = ObjLoader::LoadFromFile("Models/nba1.obj");
+		VertexArrayObject::Sptr vao8 = MeshCache::Load("Models/nba1.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr window10Texture = Texture2D::Create("Textures/Untitled.1001.png");
+			Texture2D::Sptr window10Texture = TextureCache::Load("Textures/Untitled.1001.png");
 			//material
 			SMI_Material::Sptr BarrelMat4 = SMI_Material::Create();
 			BarrelMat4->setShader(shader);
@@ -486,15 +537,15 @@ public:
 			AttachCopy(barrel, BarrelTrans4);
 
 			SMI_Physics GroundPhys = SMI_Physics(glm::vec3(-12.8, 0, 0.8), glm::vec3(90, 0, 90), glm::vec3(15.3, 3.32, 11.8), barrel, SMI_PhysicsBodyType::KINEMATIC, 0.0f);
-			GroundPhys.setIdentity(2);
+			GroundPhys.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, GroundPhys);
 		}
-		VertexArrayObject::Sptr twovao8 = ObjLoader::LoadFromFile("Models/nba1.obj");
+		VertexArrayObject::Sptr twovao8 = MeshCache::Load("Models/nba1.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr window10Texture = Texture2D::Create("Textures/Untitled.1001.png");
+			Texture2D::Sptr window10Texture = TextureCache::Load("Textures/Untitled.1001.png");
 			//material
 			SMI_Material::Sptr BarrelMat4 = SMI_Material::Create();
 			BarrelMat4->setShader(shader);
@@ -513,15 +564,15 @@ public:
 			AttachCopy(barrel, BarrelTrans4);
 
 			SMI_Physics GroundPhys = SMI_Physics(glm::vec3(-12.8, 15.3, 0.8), glm::vec3(90, 0, 90), glm::vec3(15.3, 3.32, 11.8), barrel, SMI_PhysicsBodyType::KINEMATIC, 0.0f);
-			GroundPhys.setIdentity(2);
+			GroundPhys.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, GroundPhys);
 		}
-		VertexArrayObject::Sptr wall4 = ObjLoader::LoadFromFile("Models/nba1.obj");
+		VertexArrayObject::Sptr wall4 = MeshCache::Load("Models/nba1.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr window90Texture = Texture2D::Create("Textures/Untitled.1001.png");
+			Texture2D::Sptr window90Texture = TextureCache::Load("Textures/Untitled.1001.png");
 			//material
 			SMI_Material::Sptr WallMat1 = SMI_Material::Create();
 			WallMat1->setShader(shader);
@@ -540,15 +591,15 @@ public:
 			AttachCopy(barrel, WallTrans1);
 
 			SMI_Physics GroundPhys = SMI_Physics(glm::vec3(-24.7, 0, 0.8), glm::vec3(90, 0, 90), glm::vec3(15.3, 3.32, 11.8), barrel, SMI_PhysicsBodyType::KINEMATIC, 0.0f);
-			GroundPhys.setIdentity(2);
+			GroundPhys.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, GroundPhys);
 		}
-		VertexArrayObject::Sptr barground = ObjLoader::LoadFromFile("Models/nba1.obj");
+		VertexArrayObject::Sptr barground = MeshCache::Load("Models/nba1.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr window90Texture = Texture2D::Create("Textures/Untitled.1001.png");
+			Texture2D::Sptr window90Texture = TextureCache::Load("Textures/Untitled.1001.png");
 			//material
 			SMI_Material::Sptr WallMat1 = SMI_Material::Create();
 			WallMat1->setShader(shader);
@@ -567,15 +618,15 @@ public:
 			AttachCopy(barrel, WallTrans1);
 
 			SMI_Physics GroundPhys = SMI_Physics(glm::vec3(-24.7, 15.3, 0.8), glm::vec3(90, 0, 90), glm::vec3(15.3, 3.32, 11.8), barrel, SMI_PhysicsBodyType::KINEMATIC, 0.0f);
-			GroundPhys.setIdentity(2);
+			GroundPhys.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, GroundPhys);
 		}
-		VertexArrayObject::Sptr barground1 = ObjLoader::LoadFromFile("Models/floor3.obj");
+		VertexArrayObject::Sptr barground1 = MeshCache::Load("Models/floor3.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr twindow90Texture = Texture2D::Create("Textures/Untitled.1001.png");
+			Texture2D::Sptr twindow90Texture = TextureCache::Load("Textures/Untitled.1001.png");
 			//material
 			SMI_Material::Sptr tWallMat1 = SMI_Material::Create();
 			tWallMat1->setShader(shader);
@@ -595,16 +646,16 @@ public:
 			AttachCopy(barrel, tWallTrans1);
 
 			SMI_Physics tGroundPhys = SMI_Physics(glm::vec3(-38.3, 6.3, 0.8), glm::vec3(90, 0, 90), glm::vec3(15.3, 3.32, 16.8), barrel, SMI_PhysicsBodyType::KINEMATIC, 0.0f);
-			tGroundPhys.setIdentity(2);
+			tGroundPhys.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, tGroundPhys);
 		}
 
-		VertexArrayObject::Sptr crate = ObjLoader::LoadFromFile("Models/Crates1.obj");
+		VertexArrayObject::Sptr crate = MeshCache::Load("Models/Crates1.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr crateTex = Texture2D::Create("Textures/box32.png");
+			Texture2D::Sptr crateTex = TextureCache::Load("Textures/box32.png");
 			//material
 			SMI_Material::Sptr BarrelMat5 = SMI_Material::Create();
 			BarrelMat5->setShader(shader);
@@ -623,17 +674,17 @@ public:
 			AttachCopy(barrel, BarrelTrans5);
 
 			SMI_Physics cratephys20111 = SMI_Physics(glm::vec3(-22.0, 7.0, 4.5), glm::vec3(90, 0, 90), glm::vec3(2.15, 1.97, 3.2), barrel, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			cratephys20111.setIdentity(2);
+			cratephys20111.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, cratephys20111);
 		}
 		
 		
-		VertexArrayObject::Sptr crate3 = ObjLoader::LoadFromFile("Models/Crates1.obj");
+		VertexArrayObject::Sptr crate3 = MeshCache::Load("Models/Crates1.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr crateTex3 = Texture2D::Create("Textures/box32.png");
+			Texture2D::Sptr crateTex3 = TextureCache::Load("Textures/box32.png");
 			//material
 			SMI_Material::Sptr BarrelMat53 = SMI_Material::Create();
 			BarrelMat53->setShader(shader);
@@ -652,17 +703,17 @@ public:
 			AttachCopy(barrel, BarrelTrans53);
 
 			SMI_Physics cratephys2011 = SMI_Physics(glm::vec3(-22.0, 7.0, 6.2), glm::vec3(90, 0, 90), glm::vec3(2.15, 1.97, 3.2), barrel, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			cratephys2011.setIdentity(4);
+			cratephys2011.setCollisionLayer(LAYER_CRATE);
 			AttachCopy(barrel, cratephys2011);
 			
 		}
 		
-		VertexArrayObject::Sptr crate31 = ObjLoader::LoadFromFile("Models/Crates1.obj");
+		VertexArrayObject::Sptr crate31 = MeshCache::Load("Models/Crates1.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr crateTex331 = Texture2D::Create("Textures/box32.png");
+			Texture2D::Sptr crateTex331 = TextureCache::Load("Textures/box32.png");
 			//material
 			SMI_Material::Sptr BarrelMat5331 = SMI_Material::Create();
 			BarrelMat5331->setShader(shader);
@@ -681,16 +732,16 @@ public:
 			AttachCopy(barrel, BarrelTrans5331);
 
 			SMI_Physics cratephys201131 = SMI_Physics(glm::vec3(-22.0, 7.0, 7.8), glm::vec3(90, 0, 90), glm::vec3(2.15, 1.97, 3.2), barrel, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			cratephys201131.setIdentity(4);
+			cratephys201131.setCollisionLayer(LAYER_CRATE);
 			AttachCopy(barrel, cratephys201131);
 
 		}
-		VertexArrayObject::Sptr crate4 = ObjLoader::LoadFromFile("Models/Crates1.obj");
+		VertexArrayObject::Sptr crate4 = MeshCache::Load("Models/Crates1.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr crateTex4 = Texture2D::Create("Textures/box32.png");
+			Texture2D::Sptr crateTex4 = TextureCache::Load("Textures/box32.png");
 			//material
 			SMI_Material::Sptr BarrelMat534 = SMI_Material::Create();
 			BarrelMat534->setShader(shader);
@@ -707,15 +758,15 @@ public:
 			AttachCopy(barrel, BarrelTrans534);
 
 			SMI_Physics cratephys552 = SMI_Physics(glm::vec3(-17.0, 7.0, 2.5), glm::vec3(90, 0, 90), glm::vec3(2.15, 1.97, 3.2), barrel, SMI_PhysicsBodyType::DYNAMIC, 1.0f);
-			cratephys552.setIdentity(2);
+			cratephys552.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, cratephys552);
 		}
-		VertexArrayObject::Sptr door = ObjLoader::LoadFromFile("Models/warehousedoor.obj");
+		VertexArrayObject::Sptr door = MeshCache::Load("Models/warehousedoor.obj");
 		{
 
 			door1 = CreateEntity();
 
-			Texture2D::Sptr doorTexture = Texture2D::Create("Textures/doortex.png");
+			Texture2D::Sptr doorTexture = TextureCache::Load("Textures/doortex.png");
 			//material
 			SMI_Material::Sptr BarrelMat6 = SMI_Material::Create();
 			BarrelMat6->setShader(shader);
@@ -734,14 +785,19 @@ public:
 			AttachCopy(door1, BarrelTrans6);
 			
 			SMI_Physics dphys201131 = SMI_Physics(glm::vec3(-46.0, 9.5, 2), glm::vec3(90, 0, -90), glm::vec3(4.02, 10.298, 0.13), door1, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			dphys201131.setIdentity(8);
+			dphys201131.setCollisionLayer(LAYER_CRUSHING_DOOR);
 			AttachCopy(door1, dphys201131);
+
+			SMI_KinematicController doorMove = SMI_KinematicController();
+			doorMove.addKeyframe(0.f, glm::vec3(-46.0, 9.5, 15));
+			doorMove.addKeyframe(max, glm::vec3(-46.0, 9.5, 2));
+			AttachCopy(door1, doorMove);
 		}
-		VertexArrayObject::Sptr dw1 = ObjLoader::LoadFromFile("Models/wdoorway.obj");
+		VertexArrayObject::Sptr dw1 = MeshCache::Load("Models/wdoorway.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr dwTexture80 = Texture2D::Create("Textures/bricktex.png");
+			Texture2D::Sptr dwTexture80 = TextureCache::Load("Textures/bricktex.png");
 			//material
 			SMI_Material::Sptr dwMa80 = SMI_Material::Create();
 
@@ -762,12 +818,12 @@ public:
 			AttachCopy(barrel, dwTrans1801);
 		}
 
-		VertexArrayObject::Sptr crate1 = ObjLoader::LoadFromFile("Models/Crates1.obj");
+		VertexArrayObject::Sptr crate1 = MeshCache::Load("Models/Crates1.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr crate1Texture = Texture2D::Create("Textures/box32.png");
+			Texture2D::Sptr crate1Texture = TextureCache::Load("Textures/box32.png");
 			//material
 			SMI_Material::Sptr BarrelMat5 = SMI_Material::Create();
 			BarrelMat5->setShader(shader);
@@ -786,15 +842,15 @@ public:
 			AttachCopy(barrel, BarrelTrans5);
 
 			SMI_Physics cratephys20 = SMI_Physics(glm::vec3(-22.0, 7.0, 2.7), glm::vec3(90, 0, 90), glm::vec3(2.15, 1.97, 3.2), barrel, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			cratephys20.setIdentity(2);
+			cratephys20.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, cratephys20);
 		}
 
-		VertexArrayObject::Sptr bar = ObjLoader::LoadFromFile("Models/btab.obj");
+		VertexArrayObject::Sptr bar = MeshCache::Load("Models/btab.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr WinTexture80 = Texture2D::Create("Textures/bartabtex.png");
+			Texture2D::Sptr WinTexture80 = TextureCache::Load("Textures/bartabtex.png");
 			//material
 			SMI_Material::Sptr BarrelMa80 = SMI_Material::Create();
 
@@ -814,11 +870,11 @@ public:
 			winTrans180.SetDegree(glm::vec3(90, 0, -180));
 			AttachCopy(barrel, winTrans180);
 		}
-		VertexArrayObject::Sptr bararea = ObjLoader::LoadFromFile("Models/bar_area.obj");
+		VertexArrayObject::Sptr bararea = MeshCache::Load("Models/bar_area.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr bararea80 = Texture2D::Create("Textures/tabletex1.png");
+			Texture2D::Sptr bararea80 = TextureCache::Load("Textures/tabletex1.png");
 			//material
 			SMI_Material::Sptr barareaMa80 = SMI_Material::Create();
 
@@ -838,11 +894,11 @@ public:
 			barareaTrans180.SetDegree(glm::vec3(90, 0, 90));
 			AttachCopy(barrel, barareaTrans180);
 		}
-		VertexArrayObject::Sptr garbage1 = ObjLoader::LoadFromFile("Models/bardoorway.obj");
+		VertexArrayObject::Sptr garbage1 = MeshCache::Load("Models/bardoorway.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr gTexture80 = Texture2D::Create("Textures/bricktex.png");
+			Texture2D::Sptr gTexture80 = TextureCache::Load("Textures/bricktex.png");
 			//material
 			SMI_Material::Sptr gMa80 = SMI_Material::Create();
 
@@ -862,11 +918,11 @@ public:
 			winTrans1801.SetDegree(glm::vec3(90, 0, 90));
 			AttachCopy(barrel, winTrans1801);
 		}
-		VertexArrayObject::Sptr barway = ObjLoader::LoadFromFile("Models/bardoorway.obj");
+		VertexArrayObject::Sptr barway = MeshCache::Load("Models/bardoorway.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr barwayTexture80 = Texture2D::Create("Textures/bricktex.png");
+			Texture2D::Sptr barwayTexture80 = TextureCache::Load("Textures/bricktex.png");
 			//material
 			SMI_Material::Sptr barwayMa80 = SMI_Material::Create();
 
@@ -886,11 +942,11 @@ public:
 			barwaywinTrans1801.SetDegree(glm::vec3(90, 0, 90));
 			AttachCopy(barrel, barwaywinTrans1801);
 		}
-		VertexArrayObject::Sptr garbage11 = ObjLoader::LoadFromFile("Models/bardoor.obj");
+		VertexArrayObject::Sptr garbage11 = MeshCache::Load("Models/bardoor.obj");
 		{
 			door4 = CreateEntity();
 			//create texture
-			Texture2D::Sptr gTexture8017 = Texture2D::Create("Textures/bardoor.png");
+			Texture2D::Sptr gTexture8017 = TextureCache::Load("Textures/bardoor.png");
 			//material
 			SMI_Material::Sptr gMa8017 = SMI_Material::Create();
 
@@ -911,15 +967,18 @@ public:
 			AttachCopy(door4, winTrans180117);
 
 			SMI_Physics bardoorphys = SMI_Physics(glm::vec3 (-12.5, 9.2, 2.0), glm::vec3(90, 0, -90), glm::vec3(14.3917, 10.56, 0.472), door4, SMI_PhysicsBodyType::KINEMATIC, 0.0f);
-			bardoorphys.setIdentity(2);
+			bardoorphys.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(door4, bardoorphys);
+
+			//slides back out of the way when the bar button is pressed
+			AttachCopy(door4, SlideTrack(glm::vec3(-12.5, 9.2, 2.0), glm::vec3(-12.5, -9.2, 2.0)));
 		}
-		VertexArrayObject::Sptr button149 = ObjLoader::LoadFromFile("Models/barbutton.obj");
+		VertexArrayObject::Sptr button149 = MeshCache::Load("Models/barbutton.obj");
 		{
 			button6 = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr buttonTexture8059 = Texture2D::Create("Textures/buttontex.png");
+			Texture2D::Sptr buttonTexture8059 = TextureCache::Load("Textures/buttontex.png");
 			//material
 			SMI_Material::Sptr buttongMa8059 = SMI_Material::Create();
 
@@ -938,15 +997,18 @@ public:
 			AttachCopy(button6, buttonTrans180159);
 
 			SMI_Physics buttonphys59 = SMI_Physics(glm::vec3(-12.5, 7.7, 15.1), glm::vec3(90, 0, -90), glm::vec3(0.75, 3.05, 0.226), button6, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			buttonphys59.setIdentity(6);
+			buttonphys59.setCollisionLayer(LAYER_BAR_BUTTON);
 			AttachCopy(button6, buttonphys59);
+
+			//swaps places with the pressed bar button
+			AttachCopy(button6, SlideTrack(glm::vec3(-12.5, 7.7, 15.1), glm::vec3(-12.5, -87.7, 15.1)));
 		}
-		VertexArrayObject::Sptr button149act = ObjLoader::LoadFromFile("Models/barbutton.obj");
+		VertexArrayObject::Sptr button149act = MeshCache::Load("Models/barbutton.obj");
 		{
 			button7 = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr buttonTexture8059act = Texture2D::Create("Textures/buttontexactivate.png");
+			Texture2D::Sptr buttonTexture8059act = TextureCache::Load("Textures/buttontexactivate.png");
 			//material
 			SMI_Material::Sptr buttongMa8059act = SMI_Material::Create();
 
@@ -965,16 +1027,17 @@ public:
 			AttachCopy(button7, buttonTrans180159act);
 
 			SMI_Physics buttonphys159 = SMI_Physics(glm::vec3(-12.5, -87.7, 15.1), glm::vec3(90, 0, -90), glm::vec3(0.75, 3.05, 0.226), button7, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			buttonphys159.setIdentity(6);
+			buttonphys159.setCollisionLayer(LAYER_BAR_BUTTON);
 			AttachCopy(button7, buttonphys159);
+			AttachCopy(button7, SlideTrack(glm::vec3(-12.5, -87.7, 15.1), glm::vec3(-12.5, 7.7, 15.1)));
 
 		}
-		/*VertexArrayObject::Sptr button1234 = ObjLoader::LoadFromFile("Models/button.obj");
+		/*VertexArrayObject::Sptr button1234 = MeshCache::Load("Models/button.obj");
 		{
 			button8 = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr buttonTexture805134 = Texture2D::Create("Textures/buttontexactivate.png");
+			Texture2D::Sptr buttonTexture805134 = TextureCache::Load("Textures/buttontexactivate.png");
 			//material
 			SMI_Material::Sptr buttongMa805134 = SMI_Material::Create();
 
@@ -993,15 +1056,15 @@ public:
 			AttachCopy(button8, buttonTrans18015134);
 
 			SMI_Physics buttonphys5134 = SMI_Physics(glm::vec3(-28, 6.7, 3.1), glm::vec3(90, 0, -90), glm::vec3(0.75, 0.02, 0.226), button8, SMI_PhysicsBodyType::KINEMATIC, 0.0f);
-			buttonphys5134.setIdentity(7);
+			buttonphys5134.setCollisionLayer(LAYER_HAZARD);
 			AttachCopy(button8, buttonphys5134);
 		}
 		*/
-		VertexArrayObject::Sptr garbage115 = ObjLoader::LoadFromFile("Models/doortop.obj");
+		VertexArrayObject::Sptr garbage115 = MeshCache::Load("Models/doortop.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr gTexture80175 = Texture2D::Create("Textures/bricktex.png");
+			Texture2D::Sptr gTexture80175 = TextureCache::Load("Textures/bricktex.png");
 			//material
 			SMI_Material::Sptr gMa80175 = SMI_Material::Create();
 
@@ -1023,14 +1086,14 @@ public:
 
 
 			SMI_Physics doortop159 = SMI_Physics(glm::vec3(-12.5, 9.2, 10.0), glm::vec3(90, 0, -90), glm::vec3(14.6505, 10.0617, 0.112798), barrel, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			doortop159.setIdentity(2);
+			doortop159.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, doortop159);
 		}
-		VertexArrayObject::Sptr door115 = ObjLoader::LoadFromFile("Models/doortop.obj");
+		VertexArrayObject::Sptr door115 = MeshCache::Load("Models/doortop.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr doorgTexture80175 = Texture2D::Create("Textures/bricktex.png");
+			Texture2D::Sptr doorgTexture80175 = TextureCache::Load("Textures/bricktex.png");
 			//material
 			SMI_Material::Sptr doorgMa80175 = SMI_Material::Create();
 
@@ -1052,14 +1115,14 @@ public:
 
 
 			SMI_Physics doortop1591 = SMI_Physics(glm::vec3(-24.5, 9.2, 2.0), glm::vec3(90, 0, -90), glm::vec3(14.6505, 16.0617, 0.112798), barrel, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			doortop1591.setIdentity(2);
+			doortop1591.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, doortop1591);
 		}
-		VertexArrayObject::Sptr garbage2 = ObjLoader::LoadFromFile("Models/doorwall.obj");
+		VertexArrayObject::Sptr garbage2 = MeshCache::Load("Models/doorwall.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr gTexture801 = Texture2D::Create("Textures/brown1.png");
+			Texture2D::Sptr gTexture801 = TextureCache::Load("Textures/brown1.png");
 			//material
 			SMI_Material::Sptr gMa801 = SMI_Material::Create();
 
@@ -1080,12 +1143,12 @@ public:
 			AttachCopy(barrel, winTrans18011);
 		}
 		//Warehouse
-		VertexArrayObject::Sptr wall41 = ObjLoader::LoadFromFile("Models/floor1.obj");
+		VertexArrayObject::Sptr wall41 = MeshCache::Load("Models/floor1.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr window90Texture1 = Texture2D::Create("Textures/cement.png");
+			Texture2D::Sptr window90Texture1 = TextureCache::Load("Textures/cement.png");
 			//material
 			SMI_Material::Sptr WallMat11 = SMI_Material::Create();
 			WallMat11->setShader(shader);
@@ -1104,16 +1167,16 @@ public:
 			AttachCopy(barrel, WallTrans11);
 
 			SMI_Physics Ground1Phys = SMI_Physics(glm::vec3(-75.6, 7, 0.8), glm::vec3(90, 0, 90), glm::vec3(20.8, 3.32, 57.8), barrel, SMI_PhysicsBodyType::STATIC, 0.0f);
-			Ground1Phys.setIdentity(2);
+			Ground1Phys.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, Ground1Phys);
 		}
 
-		VertexArrayObject::Sptr bag = ObjLoader::LoadFromFile("Models/bag1.obj");
+		VertexArrayObject::Sptr bag = MeshCache::Load("Models/bag1.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr bagTexture1 = Texture2D::Create("Textures/bag.png");
+			Texture2D::Sptr bagTexture1 = TextureCache::Load("Textures/bag.png");
 			//material
 			SMI_Material::Sptr bagMat11 = SMI_Material::Create();
 			bagMat11->setShader(shader);
@@ -1132,16 +1195,16 @@ public:
 			AttachCopy(barrel, bagTrans11);
 
 			SMI_Physics bagphys1 = SMI_Physics(glm::vec3(-54.7, 7.0, 2.1), glm::vec3(90, 0, 90), glm::vec3(5.48, 13.67, 1.8), barrel, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			bagphys1.setIdentity(2);
+			bagphys1.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, bagphys1);
 		}
 
-		VertexArrayObject::Sptr bag2 = ObjLoader::LoadFromFile("Models/bag2.obj");
+		VertexArrayObject::Sptr bag2 = MeshCache::Load("Models/bag2.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr bagTexture12 = Texture2D::Create("Textures/bag.png");
+			Texture2D::Sptr bagTexture12 = TextureCache::Load("Textures/bag.png");
 			//material
 			SMI_Material::Sptr bagMat112 = SMI_Material::Create();
 			bagMat112->setShader(shader);
@@ -1160,15 +1223,15 @@ public:
 			AttachCopy(barrel, bagTrans112);
 
 			SMI_Physics bagphys12 = SMI_Physics(glm::vec3(-50.7, 7.0, 2.1), glm::vec3(90, 0, 90), glm::vec3(4.52, 4.62, 1.8), barrel, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			bagphys12.setIdentity(2);
+			bagphys12.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, bagphys12);
 		}
-		VertexArrayObject::Sptr bag22 = ObjLoader::LoadFromFile("Models/barrelset.obj");
+		VertexArrayObject::Sptr bag22 = MeshCache::Load("Models/barrelset.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr bagTexture122 = Texture2D::Create("Textures/Barrel.png");
+			Texture2D::Sptr bagTexture122 = TextureCache::Load("Textures/Barrel.png");
 			//material
 			SMI_Material::Sptr bagMat1122 = SMI_Material::Create();
 			bagMat1122->setShader(shader);
@@ -1187,12 +1250,12 @@ public:
 			AttachCopy(barrel, bagTrans1122);
 
 		}
-		VertexArrayObject::Sptr bag223 = ObjLoader::LoadFromFile("Models/barrelset.obj");
+		VertexArrayObject::Sptr bag223 = MeshCache::Load("Models/barrelset.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr bagTexture1223 = Texture2D::Create("Textures/Barrel.png");
+			Texture2D::Sptr bagTexture1223 = TextureCache::Load("Textures/Barrel.png");
 			//material
 			SMI_Material::Sptr bagMat11223 = SMI_Material::Create();
 			bagMat11223->setShader(shader);
@@ -1211,12 +1274,12 @@ public:
 			AttachCopy(barrel, bagTrans11223);
 
 		}
-		VertexArrayObject::Sptr shelf = ObjLoader::LoadFromFile("Models/shelf12.obj");
+		VertexArrayObject::Sptr shelf = MeshCache::Load("Models/shelf12.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr shelfTexture1 = Texture2D::Create("Textures/shelf.png");
+			Texture2D::Sptr shelfTexture1 = TextureCache::Load("Textures/shelf.png");
 			//material
 			SMI_Material::Sptr shelfMat11 = SMI_Material::Create();
 			shelfMat11->setShader(shader);
@@ -1234,12 +1297,12 @@ public:
 			shelfTrans11.SetDegree(glm::vec3(90, 0, 90));
 			AttachCopy(barrel, shelfTrans11);
 		}
-		VertexArrayObject::Sptr window231 = ObjLoader::LoadFromFile("Models/window1.obj");
+		VertexArrayObject::Sptr window231 = MeshCache::Load("Models/window1.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr window2Texture31 = Texture2D::Create("Textures/brown1.png");
+			Texture2D::Sptr window2Texture31 = TextureCache::Load("Textures/brown1.png");
 			//material
 			SMI_Material::Sptr window2Mat31 = SMI_Material::Create();
 			window2Mat31->setShader(shader);
@@ -1257,11 +1320,11 @@ public:
 			window2Trans31.SetDegree(glm::vec3(90, 0, 90));
 			AttachCopy(barrel, window2Trans31);
 		}
-		VertexArrayObject::Sptr doorw2 = ObjLoader::LoadFromFile("Models/bardoorway.obj");
+		VertexArrayObject::Sptr doorw2 = MeshCache::Load("Models/bardoorway.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr doorw2801Tex = Texture2D::Create("Textures/bricktex.png");
+			Texture2D::Sptr doorw2801Tex = TextureCache::Load("Textures/bricktex.png");
 			//material
 			SMI_Material::Sptr doorw280Mat1 = SMI_Material::Create();
 
@@ -1281,11 +1344,11 @@ public:
 			doorw2Trans18011.SetDegree(glm::vec3(90, 0, -90));
 			AttachCopy(barrel, doorw2Trans18011);
 		}
-		VertexArrayObject::Sptr door1w2 = ObjLoader::LoadFromFile("Models/blockedbardoor.obj");
+		VertexArrayObject::Sptr door1w2 = MeshCache::Load("Models/blockedbardoor.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr doorw2801Tex1 = Texture2D::Create("Textures/bricktex.png");
+			Texture2D::Sptr doorw2801Tex1 = TextureCache::Load("Textures/bricktex.png");
 			//material
 			SMI_Material::Sptr doorw280Mat11 = SMI_Material::Create();
 
@@ -1307,14 +1370,14 @@ public:
 
 
 			SMI_Physics bbardoorphys1 = SMI_Physics(glm::vec3(-92.8, 9.8, 3.0), glm::vec3(90, 0, -90), glm::vec3(14.3917, 16.56, 0.472), barrel, SMI_PhysicsBodyType::KINEMATIC, 0.0f);
-			bbardoorphys1.setIdentity(2);
+			bbardoorphys1.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, bbardoorphys1);
 		}
-		VertexArrayObject::Sptr building = ObjLoader::LoadFromFile("Models/building1.obj");
+		VertexArrayObject::Sptr building = MeshCache::Load("Models/building1.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr build2801Tex = Texture2D::Create("Textures/build.png");
+			Texture2D::Sptr build2801Tex = TextureCache::Load("Textures/build.png");
 			//material
 			SMI_Material::Sptr build280Mat1 = SMI_Material::Create();
 
@@ -1334,11 +1397,11 @@ public:
 			build2Trans18011.SetDegree(glm::vec3(90, 0, -90));
 			AttachCopy(barrel, build2Trans18011);
 		}
-		VertexArrayObject::Sptr building2 = ObjLoader::LoadFromFile("Models/build4.obj");
+		VertexArrayObject::Sptr building2 = MeshCache::Load("Models/build4.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr build2801Tex2 = Texture2D::Create("Textures/2build.png");
+			Texture2D::Sptr build2801Tex2 = TextureCache::Load("Textures/2build.png");
 			//material
 			SMI_Material::Sptr build280Mat12 = SMI_Material::Create();
 
@@ -1358,12 +1421,12 @@ public:
 			build2Trans180112.SetDegree(glm::vec3(90, 0, -90));
 			AttachCopy(barrel, build2Trans180112);
 		}
-		VertexArrayObject::Sptr window2311 = ObjLoader::LoadFromFile("Models/window1.obj");
+		VertexArrayObject::Sptr window2311 = MeshCache::Load("Models/window1.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr window2Texture311 = Texture2D::Create("Textures/brown1.png");
+			Texture2D::Sptr window2Texture311 = TextureCache::Load("Textures/brown1.png");
 			//material
 			SMI_Material::Sptr window2Mat311 = SMI_Material::Create();
 			window2Mat311->setShader(shader);
@@ -1381,12 +1444,12 @@ public:
 			window2Trans311.SetDegree(glm::vec3(90, 0, 90));
 			AttachCopy(barrel, window2Trans311);
 		}
-		VertexArrayObject::Sptr car = ObjLoader::LoadFromFile("Models/car.obj");
+		VertexArrayObject::Sptr car = MeshCache::Load("Models/car.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr carTexture80 = Texture2D::Create("Textures/car_Tex.png");
+			Texture2D::Sptr carTexture80 = TextureCache::Load("Textures/car_Tex.png");
 			//material
 			SMI_Material::Sptr cargMa80 = SMI_Material::Create();
 
@@ -1406,12 +1469,12 @@ public:
 			carTrans1801.SetDegree(glm::vec3(90, 0, -90));
 			AttachCopy(barrel, carTrans1801);
 		}
-		VertexArrayObject::Sptr car1 = ObjLoader::LoadFromFile("Models/car.obj");
+		VertexArrayObject::Sptr car1 = MeshCache::Load("Models/car.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr carTexture801 = Texture2D::Create("Textures/car_Tex.png");
+			Texture2D::Sptr carTexture801 = TextureCache::Load("Textures/car_Tex.png");
 			//material
 			SMI_Material::Sptr cargMa801 = SMI_Material::Create();
 
@@ -1432,15 +1495,15 @@ public:
 			AttachCopy(barrel, carTrans18011);
 
 			SMI_Physics carphys = SMI_Physics(glm::vec3(-118.5, 6.8, 2.7), glm::vec3(90, 0, 90), glm::vec3(3.17, 5.15, 10.6), barrel, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			carphys.setIdentity(2);
+			carphys.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, carphys);
 		}
-		VertexArrayObject::Sptr car3 = ObjLoader::LoadFromFile("Models/car.obj");
+		VertexArrayObject::Sptr car3 = MeshCache::Load("Models/car.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr carTexture8013 = Texture2D::Create("Textures/car_Tex.png");
+			Texture2D::Sptr carTexture8013 = TextureCache::Load("Textures/car_Tex.png");
 			//material
 			SMI_Material::Sptr cargMa8013 = SMI_Material::Create();
 
@@ -1461,15 +1524,15 @@ public:
 			AttachCopy(barrel, carTrans180113);
 
 			SMI_Physics carphys2 = SMI_Physics(glm::vec3(-130.5, 6.8, 2.7), glm::vec3(90, 0, -120), glm::vec3(3.17, 5.15, 10.6), barrel, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			carphys2.setIdentity(2);
+			carphys2.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, carphys2);
 		}
-		VertexArrayObject::Sptr ashphalt = ObjLoader::LoadFromFile("Models/floor2.obj");
+		VertexArrayObject::Sptr ashphalt = MeshCache::Load("Models/floor2.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr ashphaltTexture80 = Texture2D::Create("Textures/gravel.png");
+			Texture2D::Sptr ashphaltTexture80 = TextureCache::Load("Textures/gravel.png");
 			//material
 			SMI_Material::Sptr ashphaltgMa80 = SMI_Material::Create();
 
@@ -1488,15 +1551,15 @@ public:
 			AttachCopy(barrel, ashphaltTrans1801);
 
 			SMI_Physics gravelphys = SMI_Physics(glm::vec3(-112.5, 3, -0.8), glm::vec3(90, 0, -90), glm::vec3(20.8154, 4.62269, 77.7581), barrel, SMI_PhysicsBodyType::STATIC, 0.0f);
-			gravelphys.setIdentity(2);
+			gravelphys.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, gravelphys);
 		}
-		VertexArrayObject::Sptr plank = ObjLoader::LoadFromFile("Models/plank.obj");
+		VertexArrayObject::Sptr plank = MeshCache::Load("Models/plank.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr plankTexture80 = Texture2D::Create("Textures/spike.png");
+			Texture2D::Sptr plankTexture80 = TextureCache::Load("Textures/spike.png");
 			//material
 			SMI_Material::Sptr plankgMa80 = SMI_Material::Create();
 
@@ -1517,14 +1580,14 @@ public:
 			AttachCopy(barrel, plankTrans1801);
 
 			SMI_Physics plankphys = SMI_Physics(glm::vec3(-122.5, 6.5, 8.8), glm::vec3(90, 0, -90), glm::vec3(4.42609, 2.172688, 9.0021), barrel, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			plankphys.setIdentity(2);
+			plankphys.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, plankphys);
 		}
-		VertexArrayObject::Sptr building6 = ObjLoader::LoadFromFile("Models/build4.obj");
+		VertexArrayObject::Sptr building6 = MeshCache::Load("Models/build4.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr tbuild2801Tex2 = Texture2D::Create("Textures/2build texture.png");
+			Texture2D::Sptr tbuild2801Tex2 = TextureCache::Load("Textures/2build texture.png");
 			//material
 			SMI_Material::Sptr tbuild280Mat12 = SMI_Material::Create();
 
@@ -1544,11 +1607,11 @@ public:
 			tbuild2Trans180112.SetDegree(glm::vec3(90, 0, -90));
 			AttachCopy(barrel, tbuild2Trans180112);
 		}
-		VertexArrayObject::Sptr fan1 = ObjLoader::LoadFromFile("Models/Cfan1.obj");
+		VertexArrayObject::Sptr fan1 = MeshCache::Load("Models/Cfan1.obj");
 		{
 			fan = CreateEntity();
 			//create texture
-			Texture2D::Sptr twbuild2801Tex2 = Texture2D::Create("Textures/fan.png");
+			Texture2D::Sptr twbuild2801Tex2 = TextureCache::Load("Textures/fan.png");
 			//material
 			SMI_Material::Sptr twbuild280Mat12 = SMI_Material::Create();
 
@@ -1569,14 +1632,14 @@ public:
 			AttachCopy(fan, twbuild2Trans180112);
 
 			SMI_Physics fanPhys = SMI_Physics(glm::vec3(-61.0, 4.1, 3.8), glm::vec3(90, 0, 90), glm::vec3(5.05, 5.62, 0),fan, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			fanPhys.setIdentity(7);
+			fanPhys.setCollisionLayer(LAYER_HAZARD);
 			AttachCopy(fan, fanPhys);
 		}
-		VertexArrayObject::Sptr fan22 = ObjLoader::LoadFromFile("Models/Cfan1.obj");
+		VertexArrayObject::Sptr fan22 = MeshCache::Load("Models/Cfan1.obj");
 		{
 			fan2 = CreateEntity();
 			//create texture
-			Texture2D::Sptr twbuild2801Tex22 = Texture2D::Create("Textures/fan.png");
+			Texture2D::Sptr twbuild2801Tex22 = TextureCache::Load("Textures/fan.png");
 			//material
 			SMI_Material::Sptr twbuild280Mat122 = SMI_Material::Create();
 
@@ -1597,14 +1660,14 @@ public:
 			AttachCopy(fan2, twbuild2Trans1801122);
 
 			SMI_Physics fanPhys2 = SMI_Physics(glm::vec3(-67.0, 4.1, 3.8), glm::vec3(90, 0, 90), glm::vec3(5.05, 5.62, 0), fan2, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			fanPhys2.setIdentity(7);
+			fanPhys2.setCollisionLayer(LAYER_HAZARD);
 			AttachCopy(fan2, fanPhys2);
 		}
-		VertexArrayObject::Sptr elevator1 = ObjLoader::LoadFromFile("Models/elevator.obj");
+		VertexArrayObject::Sptr elevator1 = MeshCache::Load("Models/elevator.obj");
 		{
 			elevator = CreateEntity();
 			//create texture
-			Texture2D::Sptr twbuild2801Tex21 = Texture2D::Create("Textures/elevator.png");
+			Texture2D::Sptr twbuild2801Tex21 = TextureCache::Load("Textures/elevator.png");
 			//material
 			SMI_Material::Sptr twbuild280Mat121 = SMI_Material::Create();
 
@@ -1625,14 +1688,20 @@ public:
 			AttachCopy(elevator, twbuild2Trans1801121);
 
 			SMI_Physics elevator1Phys = SMI_Physics(glm::vec3(-75.0, 7.0, -1.8), glm::vec3(90, 0, -90), glm::vec3(1.14, 4.05, 5.55), elevator, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			elevator1Phys.setIdentity(2);
+			elevator1Phys.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(elevator, elevator1Phys);
+
+			//rides up, then drops back to the bottom and starts again
+			SMI_KinematicController elevatorMove = SMI_KinematicController();
+			elevatorMove.addKeyframe(0.f, glm::vec3(-75.0, 7.0, 1.8));
+			elevatorMove.addKeyframe(max, glm::vec3(-75.0, 7.0, 8.8));
+			AttachCopy(elevator, elevatorMove);
 		}
-		VertexArrayObject::Sptr warehouseplank = ObjLoader::LoadFromFile("Models/plank.obj");
+		VertexArrayObject::Sptr warehouseplank = MeshCache::Load("Models/plank.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr warehousewallTex21 = Texture2D::Create("Textures/platform.png");
+			Texture2D::Sptr warehousewallTex21 = TextureCache::Load("Textures/platform.png");
 			//material
 			SMI_Material::Sptr warehousewall121 = SMI_Material::Create();
 
@@ -1651,15 +1720,15 @@ public:
 			AttachCopy(barrel, warehousewallTrans1801121);
 
 			SMI_Physics plankphys1 = SMI_Physics(glm::vec3(-82.0, 7.0, 10.8), glm::vec3(90, 0, -90), glm::vec3(10.3, 1.82, 8.8), barrel, SMI_PhysicsBodyType::STATIC, 0.0f);
-			plankphys1.setIdentity(2);
+			plankphys1.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, plankphys1);
 
 		}
-		VertexArrayObject::Sptr warehouseplank1 = ObjLoader::LoadFromFile("Models/plank.obj");
+		VertexArrayObject::Sptr warehouseplank1 = MeshCache::Load("Models/plank.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr warehousewallTex211 = Texture2D::Create("Textures/platform.png");
+			Texture2D::Sptr warehousewallTex211 = TextureCache::Load("Textures/platform.png");
 			//material
 			SMI_Material::Sptr warehousewall1211 = SMI_Material::Create();
 
@@ -1678,15 +1747,15 @@ public:
 			AttachCopy(barrel, warehousewallTrans18011211);
 
 			SMI_Physics plankphys11 = SMI_Physics(glm::vec3(-89.0, 7.0, 10.8), glm::vec3(90, 0, -90), glm::vec3(10.3, 1.82, 8.8), barrel, SMI_PhysicsBodyType::STATIC, 0.0f);
-			plankphys11.setIdentity(2);
+			plankphys11.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, plankphys11);
 
 		}
-		VertexArrayObject::Sptr railing = ObjLoader::LoadFromFile("Models/railing.obj");
+		VertexArrayObject::Sptr railing = MeshCache::Load("Models/railing.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr railingTex21 = Texture2D::Create("Textures/railing.png");
+			Texture2D::Sptr railingTex21 = TextureCache::Load("Textures/railing.png");
 			//material
 			SMI_Material::Sptr railing121 = SMI_Material::Create();
 
@@ -1707,11 +1776,11 @@ public:
 			AttachCopy(barrel, railingTrans1801121);
 
 		}
-		VertexArrayObject::Sptr pillar = ObjLoader::LoadFromFile("Models/concretepillar.obj");
+		VertexArrayObject::Sptr pillar = MeshCache::Load("Models/concretepillar.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr pillarTex21 = Texture2D::Create("Textures/shelf.png");
+			Texture2D::Sptr pillarTex21 = TextureCache::Load("Textures/shelf.png");
 			//material
 			SMI_Material::Sptr pillar121 = SMI_Material::Create();
 
@@ -1732,11 +1801,11 @@ public:
 			AttachCopy(barrel, pillarTrans1801121);
 
 		}
-		VertexArrayObject::Sptr pillar1 = ObjLoader::LoadFromFile("Models/smallerpillar.obj");
+		VertexArrayObject::Sptr pillar1 = MeshCache::Load("Models/smallerpillar.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr pillarTex211 = Texture2D::Create("Textures/shelf.png");
+			Texture2D::Sptr pillarTex211 = TextureCache::Load("Textures/shelf.png");
 			//material
 			SMI_Material::Sptr pillar1211 = SMI_Material::Create();
 
@@ -1757,11 +1826,11 @@ public:
 			AttachCopy(barrel, pillarTrans18011211);
 
 		}
-		VertexArrayObject::Sptr winwall = ObjLoader::LoadFromFile("Models/winwalls.obj");
+		VertexArrayObject::Sptr winwall = MeshCache::Load("Models/winwalls.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr winwallTex21 = Texture2D::Create("Textures/inside.png");
+			Texture2D::Sptr winwallTex21 = TextureCache::Load("Textures/inside.png");
 			//material
 			SMI_Material::Sptr winwall121 = SMI_Material::Create();
 
@@ -1782,11 +1851,11 @@ public:
 			AttachCopy(barrel, winwallTrans1801121);
 
 		}
-		VertexArrayObject::Sptr winwall1 = ObjLoader::LoadFromFile("Models/winwalls1.obj");
+		VertexArrayObject::Sptr winwall1 = MeshCache::Load("Models/winwalls1.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr winwall1Tex211 = Texture2D::Create("Textures/brick1.png");
+			Texture2D::Sptr winwall1Tex211 = TextureCache::Load("Textures/brick1.png");
 			//material
 			SMI_Material::Sptr winwall11211 = SMI_Material::Create();
 
@@ -1806,15 +1875,15 @@ public:
 			AttachCopy(barrel, winwallTrans118011211);
 
 			SMI_Physics windowphys1 = SMI_Physics(glm::vec3(-151.0, 7.0, 15.4), glm::vec3(90, 0, -90), glm::vec3(7.11048, 0.19836, 0.601408), barrel, SMI_PhysicsBodyType::STATIC, 0.0f);
-			windowphys1.setIdentity(2);
+			windowphys1.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, windowphys1);
 
 		}
-		VertexArrayObject::Sptr winwall2 = ObjLoader::LoadFromFile("Models/winwalls1.obj");
+		VertexArrayObject::Sptr winwall2 = MeshCache::Load("Models/winwalls1.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr winwall1Tex2112 = Texture2D::Create("Textures/brick1.png");
+			Texture2D::Sptr winwall1Tex2112 = TextureCache::Load("Textures/brick1.png");
 			//material
 			SMI_Material::Sptr winwall112112 = SMI_Material::Create();
 
@@ -1834,16 +1903,16 @@ public:
 			AttachCopy(barrel, winwallTrans1180112112);
 
 			SMI_Physics windowphys12 = SMI_Physics(glm::vec3(-151.0, 7.0, 10.4), glm::vec3(90, 0, -90), glm::vec3(7.11048, 0.189836, 0.601408), barrel, SMI_PhysicsBodyType::STATIC, 0.0f);
-			windowphys12.setIdentity(2);
+			windowphys12.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, windowphys12);
 
 		}
-		VertexArrayObject::Sptr ashphalt5 = ObjLoader::LoadFromFile("Models/wood.obj");
+		VertexArrayObject::Sptr ashphalt5 = MeshCache::Load("Models/wood.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr ashphaltTexture805 = Texture2D::Create("Textures/lounge.png");
+			Texture2D::Sptr ashphaltTexture805 = TextureCache::Load("Textures/lounge.png");
 			//material
 			SMI_Material::Sptr ashphaltgMa805 = SMI_Material::Create();
 
@@ -1862,15 +1931,15 @@ public:
 			AttachCopy(barrel, ashphaltTrans18015);
 
 			SMI_Physics gravelphys5 = SMI_Physics(glm::vec3(-169.5, 6, -0.8), glm::vec3(90, 0, -90), glm::vec3(20.8154, 4.62269, 77.7581), barrel, SMI_PhysicsBodyType::STATIC, 0.0f);
-			gravelphys5.setIdentity(2);
+			gravelphys5.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, gravelphys5);
 		}
-		VertexArrayObject::Sptr door21 = ObjLoader::LoadFromFile("Models/door2.obj");
+		VertexArrayObject::Sptr door21 = MeshCache::Load("Models/door2.obj");
 		{
 			door2 = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr door2Texture805 = Texture2D::Create("Textures/doortex.png");
+			Texture2D::Sptr door2Texture805 = TextureCache::Load("Textures/doortex.png");
 			//material
 			SMI_Material::Sptr door2gMa805 = SMI_Material::Create();
 
@@ -1889,15 +1958,18 @@ public:
 			AttachCopy(door2, door2Trans18015);
 
 			SMI_Physics door2phys5 = SMI_Physics(glm::vec3(-151.0, 7.0, 2.5), glm::vec3(90, 0, -90), glm::vec3(4.02,16.298,0.13), door2, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			door2phys5.setIdentity(2);
+			door2phys5.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(door2, door2phys5);
+
+			//slides back out of the way when its button is pressed
+			AttachCopy(door2, SlideTrack(glm::vec3(-151.0, 7.0, 2.5), glm::vec3(-151.0, -34.0, 2.5)));
 		}
-		VertexArrayObject::Sptr button14 = ObjLoader::LoadFromFile("Models/button.obj");
+		VertexArrayObject::Sptr button14 = MeshCache::Load("Models/button.obj");
 		{
 			button = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr buttonTexture805 = Texture2D::Create("Textures/buttontex.png");
+			Texture2D::Sptr buttonTexture805 = TextureCache::Load("Textures/buttontex.png");
 			//material
 			SMI_Material::Sptr buttongMa805 = SMI_Material::Create();
 
@@ -1916,15 +1988,18 @@ public:
 			AttachCopy(button, buttonTrans18015);
 
 			SMI_Physics buttonphys5 = SMI_Physics(glm::vec3(-158.0, 6.7, 2.1), glm::vec3(90, 0, -90), glm::vec3(0.75,0.05,0.226), button, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			buttonphys5.setIdentity(3);
+			buttonphys5.setCollisionLayer(LAYER_DOOR2_BUTTON);
 			AttachCopy(button, buttonphys5);
+
+			//swaps places with the pressed button
+			AttachCopy(button, SlideTrack(glm::vec3(-158.0, 6.7, 2.1), glm::vec3(-158.0, -34.7, 2.1)));
 		}
-		VertexArrayObject::Sptr insidewall = ObjLoader::LoadFromFile("Models/inside.obj");
+		VertexArrayObject::Sptr insidewall = MeshCache::Load("Models/inside.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr insideTexture805 = Texture2D::Create("Textures/inside.png");
+			Texture2D::Sptr insideTexture805 = TextureCache::Load("Textures/inside.png");
 			//material
 			SMI_Material::Sptr insidegMa805 = SMI_Material::Create();
 
@@ -1944,12 +2019,12 @@ public:
 			insideTrans18015.SetDegree(glm::vec3(90, 0, 90));
 			AttachCopy(barrel, insideTrans18015);
 		}
-		VertexArrayObject::Sptr insidewall1 = ObjLoader::LoadFromFile("Models/inside.obj");
+		VertexArrayObject::Sptr insidewall1 = MeshCache::Load("Models/inside.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr insideTexture8051 = Texture2D::Create("Textures/inside.png");
+			Texture2D::Sptr insideTexture8051 = TextureCache::Load("Textures/inside.png");
 			//material
 			SMI_Material::Sptr insidegMa8051 = SMI_Material::Create();
 
@@ -1969,12 +2044,12 @@ public:
 			insideTrans180151.SetDegree(glm::vec3(90, 0, 90));
 			AttachCopy(barrel, insideTrans180151);
 		}
-		VertexArrayObject::Sptr button12 = ObjLoader::LoadFromFile("Models/button.obj");
+		VertexArrayObject::Sptr button12 = MeshCache::Load("Models/button.obj");
 		{
 			button1 = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr buttonTexture8051 = Texture2D::Create("Textures/buttontexactivate.png");
+			Texture2D::Sptr buttonTexture8051 = TextureCache::Load("Textures/buttontexactivate.png");
 			//material
 			SMI_Material::Sptr buttongMa8051 = SMI_Material::Create();
 
@@ -1993,14 +2068,15 @@ public:
 			AttachCopy(button1, buttonTrans180151);
 
 			SMI_Physics buttonphys51 = SMI_Physics(glm::vec3(-158.0, -34.7, 2.1), glm::vec3(90, 0, -90), glm::vec3(0.75, -100.05, 0.226), button1, SMI_PhysicsBodyType::KINEMATIC, 0.0f);
-			buttonphys51.setIdentity(3);
+			buttonphys51.setCollisionLayer(LAYER_DOOR2_BUTTON);
 			AttachCopy(button1, buttonphys51);
+			AttachCopy(button1, SlideTrack(glm::vec3(-158.0, -34.7, 2.1), glm::vec3(-158.0, 6.7, 2.1)));
 		}
-		VertexArrayObject::Sptr winwall5 = ObjLoader::LoadFromFile("Models/winwalls3.obj");
+		VertexArrayObject::Sptr winwall5 = MeshCache::Load("Models/winwalls3.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr winwallTex215 = Texture2D::Create("Textures/inside.png");
+			Texture2D::Sptr winwallTex215 = TextureCache::Load("Textures/inside.png");
 			//material
 			SMI_Material::Sptr winwall1215 = SMI_Material::Create();
 
@@ -2021,12 +2097,12 @@ public:
 			AttachCopy(barrel, winwallTrans18011215);
 
 		}
-		VertexArrayObject::Sptr door212 = ObjLoader::LoadFromFile("Models/door2.obj");
+		VertexArrayObject::Sptr door212 = MeshCache::Load("Models/door2.obj");
 		{
 			door3 = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr door2Texture8052 = Texture2D::Create("Textures/doortex.png");
+			Texture2D::Sptr door2Texture8052 = TextureCache::Load("Textures/doortex.png");
 			//material
 			SMI_Material::Sptr door2gMa8052 = SMI_Material::Create();
 
@@ -2045,15 +2121,18 @@ public:
 			AttachCopy(door3, door2Trans180152);
 
 			SMI_Physics door2phys52 = SMI_Physics(glm::vec3(-166.7, 7.0, 2.5), glm::vec3(90, 0, -90), glm::vec3(4.02, 40.298, 0.13), door3, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			door2phys52.setIdentity(2);
+			door2phys52.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(door3, door2phys52);
+
+			//slides out of the way while its plate is held down, and back once a crate is on the ground
+			AttachCopy(door3, SlideTrack(glm::vec3(-166.7, 7.0, 2.5), glm::vec3(-166.7, -34.0, 2.5)));
 		}
-		VertexArrayObject::Sptr crate19 = ObjLoader::LoadFromFile("Models/Crates1.obj");
+		VertexArrayObject::Sptr crate19 = MeshCache::Load("Models/Crates1.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr crateTex19 = Texture2D::Create("Textures/box32.png");
+			Texture2D::Sptr crateTex19 = TextureCache::Load("Textures/box32.png");
 			//material
 			SMI_Material::Sptr BarrelMat519 = SMI_Material::Create();
 			BarrelMat519->setShader(shader);
@@ -2073,15 +2152,15 @@ public:
 
 			SMI_Physics cratephys52 = SMI_Physics(glm::vec3(-122.0, 7.0, 14.4), glm::vec3(90, 0, -90), glm::vec3(2.15, 1.97, 3.2), barrel, SMI_PhysicsBodyType::DYNAMIC, 1.0f);
 			cratephys52.setHasGravity(true);
-			cratephys52.setIdentity(4);
+			cratephys52.setCollisionLayer(LAYER_CRATE);
 			AttachCopy(barrel, cratephys52);
 		}
-		VertexArrayObject::Sptr button123 = ObjLoader::LoadFromFile("Models/button.obj");
+		VertexArrayObject::Sptr button123 = MeshCache::Load("Models/button.obj");
 		{
 			button5 = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr buttonTexture80513 = Texture2D::Create("Textures/buttontexactivate.png");
+			Texture2D::Sptr buttonTexture80513 = TextureCache::Load("Textures/buttontexactivate.png");
 			//material
 			SMI_Material::Sptr buttongMa80513 = SMI_Material::Create();
 
@@ -2100,16 +2179,16 @@ public:
 			AttachCopy(button5, buttonTrans1801513);
 
 			SMI_Physics buttonphys513 = SMI_Physics(glm::vec3(-163.0, 6.7, 2.1), glm::vec3(90, 0, -90), glm::vec3(0.75, 0.02, 0.226), button5, SMI_PhysicsBodyType::KINEMATIC, 0.0f);
-			buttonphys513.setIdentity(5);
+			buttonphys513.setCollisionLayer(LAYER_DOOR3_PLATE);
 			AttachCopy(button5, buttonphys513);
 		}
 
-		VertexArrayObject::Sptr enemy = ObjLoader::LoadFromFile("Models/enemy.obj");
+		VertexArrayObject::Sptr enemy = MeshCache::Load("Models/enemy.obj");
 		{
 			en = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr enemyCharacterTex = Texture2D::Create("Textures/enemy.png");
+			Texture2D::Sptr enemyCharacterTex = TextureCache::Load("Textures/enemy.png");
 			//create material
 			SMI_Material::Sptr enemyCharacterMat = SMI_Material::Create();
 			enemyCharacterMat->setShader(shader);
@@ -2129,16 +2208,16 @@ public:
 
 			SMI_Physics enemyPhys = SMI_Physics(glm::vec3(-181.0, 7.8, 2.2), glm::vec3(90, 0, -90), glm::vec3(2, 3, 1), en, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
 
-			enemyPhys.setIdentity(10);
+			enemyPhys.setCollisionLayer(LAYER_ENEMY);
 			AttachCopy(en, enemyPhys);
 		}
 
-		VertexArrayObject::Sptr enemy1 = ObjLoader::LoadFromFile("Models/denemy.obj");
+		VertexArrayObject::Sptr enemy1 = MeshCache::Load("Models/denemy.obj");
 		{
 			en1 = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr enemyCharacterTex1 = Texture2D::Create("Textures/enemy.png");
+			Texture2D::Sptr enemyCharacterTex1 = TextureCache::Load("Textures/enemy.png");
 			//create material
 			SMI_Material::Sptr enemyCharacterMat1 = SMI_Material::Create();
 			enemyCharacterMat1->setShader(shader);
@@ -2158,15 +2237,15 @@ public:
 
 			SMI_Physics enemyPhys1 = SMI_Physics(glm::vec3(-181.0, 37.8, 2.3), glm::vec3(90, 0, 90), glm::vec3(2, 0.0, 1), en1, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
 
-			enemyPhys1.setIdentity(10);
+			enemyPhys1.setCollisionLayer(LAYER_ENEMY);
 			AttachCopy(en1, enemyPhys1);
 		}
-		VertexArrayObject::Sptr bullet1 = ObjLoader::LoadFromFile("Models/bullet.obj");
+		VertexArrayObject::Sptr bullet1 = MeshCache::Load("Models/bullet.obj");
 		{
 			bullet = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr bulletTexture80513 = Texture2D::Create("Textures/brown1.png");
+			Texture2D::Sptr bulletTexture80513 = TextureCache::Load("Textures/brown1.png");
 			//material
 			SMI_Material::Sptr bulletgMa80513 = SMI_Material::Create();
 
@@ -2185,15 +2264,20 @@ public:
 			AttachCopy(bullet, bulletTrans1801513);
 
 			SMI_Physics bulletphys513 = SMI_Physics(glm::vec3(-179.0, 7.2, -87.9), glm::vec3(90, 0, -90), glm::vec3(0.23, 2.819, 0.23), bullet, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			bulletphys513.setIdentity(9);
+			bulletphys513.setCollisionLayer(LAYER_BULLET);
 			AttachCopy(bullet, bulletphys513);
+
+			SMI_KinematicController bulletMove = SMI_KinematicController();
+			bulletMove.addKeyframe(0.f, glm::vec3(-179.0, 7.2, 3.9));
+			bulletMove.addKeyframe(max, glm::vec3(-168.0, 7.2, 3.9));
+			AttachCopy(bullet, bulletMove);
 		}
-		VertexArrayObject::Sptr end = ObjLoader::LoadFromFile("Models/wi1.obj");
+		VertexArrayObject::Sptr end = MeshCache::Load("Models/wi1.obj");
 		{
 			ed = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr bulletTexture805133 = Texture2D::Create("Textures/rough.png");
+			Texture2D::Sptr bulletTexture805133 = TextureCache::Load("Textures/rough.png");
 			//material
 			SMI_Material::Sptr bulletgMa805133 = SMI_Material::Create();
 
@@ -2212,15 +2296,15 @@ public:
 			AttachCopy(ed, bulletTrans18015133);
 
 			SMI_Physics bulletphys5133 = SMI_Physics(glm::vec3(-879.0, -7.2, -8.9), glm::vec3(90, 0, -90), glm::vec3(0.23, 2.819, 0.23), ed, SMI_PhysicsBodyType::STATIC, 1.0f);
-			bulletphys5133.setIdentity(9);
+			bulletphys5133.setCollisionLayer(LAYER_BULLET);
 			AttachCopy(ed, bulletphys5133);
 		}
-		VertexArrayObject::Sptr crate119 = ObjLoader::LoadFromFile("Models/Crates1.obj");
+		VertexArrayObject::Sptr crate119 = MeshCache::Load("Models/Crates1.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr crateTex19 = Texture2D::Create("Textures/box32.png");
+			Texture2D::Sptr crateTex19 = TextureCache::Load("Textures/box32.png");
 			//material
 			SMI_Material::Sptr BarrelMat519 = SMI_Material::Create();
 			BarrelMat519->setShader(shader);
@@ -2240,15 +2324,15 @@ public:
 
 			SMI_Physics crate1phys52 = SMI_Physics(glm::vec3(-182.0, 8.2, 14.4), glm::vec3(90, 0, -90), glm::vec3(2.15, 1.97, 3.2), barrel, SMI_PhysicsBodyType::DYNAMIC, 1.0f);
 			crate1phys52.setHasGravity(true);
-			crate1phys52.setIdentity(11);
+			crate1phys52.setCollisionLayer(LAYER_ENEMY_CRATE);
 			AttachCopy(barrel, crate1phys52);
 		}
-		VertexArrayObject::Sptr plank5 = ObjLoader::LoadFromFile("Models/splank.obj");
+		VertexArrayObject::Sptr plank5 = MeshCache::Load("Models/splank.obj");
 		{
 			planks = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr plankTexture805 = Texture2D::Create("Textures/platform.png");
+			Texture2D::Sptr plankTexture805 = TextureCache::Load("Textures/platform.png");
 			//material
 			SMI_Material::Sptr plankgMa805 = SMI_Material::Create();
 
@@ -2269,15 +2353,15 @@ public:
 			AttachCopy(planks, plankTrans18015);
 
 			SMI_Physics plankphys5 = SMI_Physics(glm::vec3(-182.5, 6.5, 8.8), glm::vec3(90, 0, -90), glm::vec3(4.42609, 2.173, 4.8), planks, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			plankphys5.setIdentity(2);
+			plankphys5.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(planks, plankphys5);
 		}
-		VertexArrayObject::Sptr button1239 = ObjLoader::LoadFromFile("Models/button.obj");
+		VertexArrayObject::Sptr button1239 = MeshCache::Load("Models/button.obj");
 		{
 			button9 = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr buttonTexture805139 = Texture2D::Create("Textures/buttontexactivate.png");
+			Texture2D::Sptr buttonTexture805139 = TextureCache::Load("Textures/buttontexactivate.png");
 			//material
 			SMI_Material::Sptr buttongMa805139 = SMI_Material::Create();
 
@@ -2296,15 +2380,15 @@ public:
 			AttachCopy(button9, buttonTrans18015139);
 
 			SMI_Physics buttonphys5139 = SMI_Physics(glm::vec3(-175.0, 6.7, 2.1), glm::vec3(90, 0, -90), glm::vec3(0.75, 0.02, 0.226), button9, SMI_PhysicsBodyType::KINEMATIC, 0.0f);
-			buttonphys5139.setIdentity(12);
+			buttonphys5139.setCollisionLayer(LAYER_PLANK_BUTTON);
 			AttachCopy(button9, buttonphys5139);
 		}
-		VertexArrayObject::Sptr insidewall2 = ObjLoader::LoadFromFile("Models/inside.obj");
+		VertexArrayObject::Sptr insidewall2 = MeshCache::Load("Models/inside.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr insideTexture8052 = Texture2D::Create("Textures/inside.png");
+			Texture2D::Sptr insideTexture8052 = TextureCache::Load("Textures/inside.png");
 			//material
 			SMI_Material::Sptr insidegMa8052 = SMI_Material::Create();
 
@@ -2324,11 +2408,11 @@ public:
 			insideTrans180152.SetDegree(glm::vec3(90, 0, 90));
 			AttachCopy(barrel, insideTrans180152);
 		}
-		VertexArrayObject::Sptr winwall7 = ObjLoader::LoadFromFile("Models/winwalls3.obj");
+		VertexArrayObject::Sptr winwall7 = MeshCache::Load("Models/winwalls3.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr winwallTex21511 = Texture2D::Create("Textures/inside.png");
+			Texture2D::Sptr winwallTex21511 = TextureCache::Load("Textures/inside.png");
 			//material
 			SMI_Material::Sptr winwall121511 = SMI_Material::Create();
 
@@ -2350,12 +2434,12 @@ public:
 
 		}
 
-		VertexArrayObject::Sptr plank5hold = ObjLoader::LoadFromFile("Models/plankhold.obj");
+		VertexArrayObject::Sptr plank5hold = MeshCache::Load("Models/plankhold.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr plankTexture805hold = Texture2D::Create("Textures/spike.png");
+			Texture2D::Sptr plankTexture805hold = TextureCache::Load("Textures/spike.png");
 			//material
 			SMI_Material::Sptr plankgMa80hold5 = SMI_Material::Create();
 
@@ -2376,12 +2460,12 @@ public:
 			AttachCopy(barrel, plankTrans18015hold);
 		}
 	
-		VertexArrayObject::Sptr button12391 = ObjLoader::LoadFromFile("Models/button.obj");
+		VertexArrayObject::Sptr button12391 = MeshCache::Load("Models/button.obj");
 		{
 			button10 = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr buttonTexture8051391 = Texture2D::Create("Textures/buttontexactivate.png");
+			Texture2D::Sptr buttonTexture8051391 = TextureCache::Load("Textures/buttontexactivate.png");
 			//material
 			SMI_Material::Sptr buttongMa8051391 = SMI_Material::Create();
 
@@ -2400,15 +2484,15 @@ public:
 			AttachCopy(button10, buttonTrans180151391);
 
 			SMI_Physics buttonphys51391 = SMI_Physics(glm::vec3(-214.0, 6.7, 2.1), glm::vec3(90, 0, -90), glm::vec3(0.75, 0.02, 0.226), button10, SMI_PhysicsBodyType::KINEMATIC, 0.0f);
-			buttonphys51391.setIdentity(13);
+			buttonphys51391.setCollisionLayer(LAYER_DOOR8_BUTTON);
 			AttachCopy(button10, buttonphys51391);
 		}
 		
-		VertexArrayObject::Sptr spike = ObjLoader::LoadFromFile("Models/spike.obj");
+		VertexArrayObject::Sptr spike = MeshCache::Load("Models/spike.obj");
 		{
 			glide = CreateEntity();
 			//create texture
-			Texture2D::Sptr spiketex = Texture2D::Create("Textures/spike.png");
+			Texture2D::Sptr spiketex = TextureCache::Load("Textures/spike.png");
 			//material
 			SMI_Material::Sptr spikemat = SMI_Material::Create();
 
@@ -2429,16 +2513,21 @@ public:
 			AttachCopy(glide, spikeTrans1801121511);
 
 			SMI_Physics glidephys51391 = SMI_Physics(glm::vec3(-198.7, 7.0, 2.3), glm::vec3(90, 0, -90), glm::vec3(4.1, 3.62, 14.000), glide, SMI_PhysicsBodyType::KINEMATIC, 0.0f);
-			glidephys51391.setIdentity(14);
+			glidephys51391.setCollisionLayer(LAYER_GLIDER);
 			AttachCopy(glide, glidephys51391);
 
+			SMI_KinematicController glideMove = SMI_KinematicController();
+			glideMove.addKeyframe(0.f, glm::vec3(-198.7, 7.0, 2.3));
+			glideMove.addKeyframe(max, glm::vec3(-198.7, 7.0, -6.3));
+			AttachCopy(glide, glideMove);
+
 		}
 	
-		VertexArrayObject::Sptr winwall78 = ObjLoader::LoadFromFile("Models/winwalls.obj");
+		VertexArrayObject::Sptr winwall78 = MeshCache::Load("Models/winwalls.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr winwallTex2151178 = Texture2D::Create("Textures/inside.png");
+			Texture2D::Sptr winwallTex2151178 = TextureCache::Load("Textures/inside.png");
 			//material
 			SMI_Material::Sptr winwall12151178 = SMI_Material::Create();
 
@@ -2460,12 +2549,12 @@ public:
 
 		}
 
-		VertexArrayObject::Sptr insidewall234 = ObjLoader::LoadFromFile("Models/inside.obj");
+		VertexArrayObject::Sptr insidewall234 = MeshCache::Load("Models/inside.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr insideTexture805234 = Texture2D::Create("Textures/inside.png");
+			Texture2D::Sptr insideTexture805234 = TextureCache::Load("Textures/inside.png");
 			//material
 			SMI_Material::Sptr insidegMa805234 = SMI_Material::Create();
 
@@ -2485,12 +2574,12 @@ public:
 			insideTrans18015234.SetDegree(glm::vec3(90, 0, 90));
 			AttachCopy(barrel, insideTrans18015234);
 		}
-		VertexArrayObject::Sptr insidewall2342 = ObjLoader::LoadFromFile("Models/inside.obj");
+		VertexArrayObject::Sptr insidewall2342 = MeshCache::Load("Models/inside.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr insideTexture8052342 = Texture2D::Create("Textures/inside.png");
+			Texture2D::Sptr insideTexture8052342 = TextureCache::Load("Textures/inside.png");
 			//material
 			SMI_Material::Sptr insidegMa8052342 = SMI_Material::Create();
 
@@ -2511,12 +2600,12 @@ public:
 			AttachCopy(barrel, insideTrans180152342);
 		}
 
-		VertexArrayObject::Sptr plank5hold1 = ObjLoader::LoadFromFile("Models/plankhold.obj");
+		VertexArrayObject::Sptr plank5hold1 = MeshCache::Load("Models/plankhold.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr plankTexture805hold1 = Texture2D::Create("Textures/spike.png");
+			Texture2D::Sptr plankTexture805hold1 = TextureCache::Load("Textures/spike.png");
 			//material
 			SMI_Material::Sptr plankgMa80hold51 = SMI_Material::Create();
 
@@ -2537,12 +2626,12 @@ public:
 			AttachCopy(barrel, plankTrans18015hold1);
 		}
 
-		VertexArrayObject::Sptr plank51 = ObjLoader::LoadFromFile("Models/splank.obj");
+		VertexArrayObject::Sptr plank51 = MeshCache::Load("Models/splank.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr plankTexture8051 = Texture2D::Create("Textures/platform.png");
+			Texture2D::Sptr plankTexture8051 = TextureCache::Load("Textures/platform.png");
 			//material
 			SMI_Material::Sptr plankgMa8051 = SMI_Material::Create();
 
@@ -2563,16 +2652,16 @@ public:
 			AttachCopy(barrel, plankTrans180151);
 
 			SMI_Physics plankphys51 = SMI_Physics(glm::vec3(-198.5, 7.5, 4.8), glm::vec3(90, 0, -90), glm::vec3(4.42609, 2.173, 4.8), barrel, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			plankphys51.setIdentity(2);
+			plankphys51.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, plankphys51);
 		}
 
-		VertexArrayObject::Sptr crate1191 = ObjLoader::LoadFromFile("Models/SCrate.obj");
+		VertexArrayObject::Sptr crate1191 = MeshCache::Load("Models/SCrate.obj");
 		{
 
 			barrel = CreateEntity();
 
-			Texture2D::Sptr crateTex199 = Texture2D::Create("Textures/box32.png");
+			Texture2D::Sptr crateTex199 = TextureCache::Load("Textures/box32.png");
 			//material
 			SMI_Material::Sptr BarrelMat5199 = SMI_Material::Create();
 			BarrelMat5199->setShader(shader);
@@ -2592,16 +2681,16 @@ public:
 
 			SMI_Physics crate1phys5299 = SMI_Physics(glm::vec3(-198.5, 7.5, 7.8), glm::vec3(90, 0, -90), glm::vec3(2.15, 1.85, 1.67), barrel, SMI_PhysicsBodyType::DYNAMIC, 1.0f);
 			crate1phys5299.setHasGravity(true);
-			crate1phys5299.setIdentity(15);
+			crate1phys5299.setCollisionLayer(LAYER_FAN_CRATE);
 			AttachCopy(barrel, crate1phys5299);
 		}
 
-		VertexArrayObject::Sptr door2123 = ObjLoader::LoadFromFile("Models/Gdoor.obj");
+		VertexArrayObject::Sptr door2123 = MeshCache::Load("Models/Gdoor.obj");
 		{
 			door8 = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr door215Texture8052 = Texture2D::Create("Textures/doortex.png");
+			Texture2D::Sptr door215Texture8052 = TextureCache::Load("Textures/doortex.png");
 			//material
 			SMI_Material::Sptr door215gMa8052 = SMI_Material::Create();
 
@@ -2620,16 +2709,16 @@ public:
 			AttachCopy(door8, door215Trans180152);
 
 			SMI_Physics door215door2phys5 = SMI_Physics(glm::vec3(-209.0, 7.0, 2.5), glm::vec3(90, 0, -90), glm::vec3(4.02, 16.298, 0.13), door8, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			door215door2phys5.setIdentity(2);
+			door215door2phys5.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(door8, door215door2phys5);
 		}
 
-		VertexArrayObject::Sptr ashphalt51 = ObjLoader::LoadFromFile("Models/wood.obj");
+		VertexArrayObject::Sptr ashphalt51 = MeshCache::Load("Models/wood.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr ashphaltTexture80511 = Texture2D::Create("Textures/lounge.png");
+			Texture2D::Sptr ashphaltTexture80511 = TextureCache::Load("Textures/lounge.png");
 			//material
 			SMI_Material::Sptr ashphaltgMa80511 = SMI_Material::Create();
 
@@ -2648,16 +2737,16 @@ public:
 			AttachCopy(barrel, ashphaltTrans1801511);
 
 			SMI_Physics gravelphys511 = SMI_Physics(glm::vec3(-227.5, 6, -0.8), glm::vec3(90, 0, -90), glm::vec3(20.8154, 4.62269, 77.7581), barrel, SMI_PhysicsBodyType::STATIC, 0.0f);
-			gravelphys511.setIdentity(2);
+			gravelphys511.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(barrel, gravelphys511);
 		}
 
-		VertexArrayObject::Sptr Laser1 = ObjLoader::LoadFromFile("Models/lasercircle.obj");
+		VertexArrayObject::Sptr Laser1 = MeshCache::Load("Models/lasercircle.obj");
 		{
 			barrel = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr  Laser1Texture80511 = Texture2D::Create("Textures/laserred.png");
+			Texture2D::Sptr  Laser1Texture80511 = TextureCache::Load("Textures/laserred.png");
 			//material
 			SMI_Material::Sptr  Laser1gMa80511 = SMI_Material::Create();
 
@@ -2676,16 +2765,16 @@ public:
 			AttachCopy(barrel, Laser1Trans1801511);
 
 			SMI_Physics Laser1phys511 = SMI_Physics(glm::vec3(-228.5, 6, -1.3), glm::vec3(90, 0, -90), glm::vec3(0.56,80.0106,0.56), barrel, SMI_PhysicsBodyType::KINEMATIC, 0.0f);
-			Laser1phys511.setIdentity(16);
+			Laser1phys511.setCollisionLayer(LAYER_LEVEL_END);
 			AttachCopy(barrel, Laser1phys511);
 		}
 
-		VertexArrayObject::Sptr plank5t = ObjLoader::LoadFromFile("Models/Cfan12.obj");
+		VertexArrayObject::Sptr plank5t = MeshCache::Load("Models/Cfan12.obj");
 		{
 			fan3 = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr plankTexture805t = Texture2D::Create("Textures/fan.png");
+			Texture2D::Sptr plankTexture805t = TextureCache::Load("Textures/fan.png");
 			//material
 			SMI_Material::Sptr plankgMa805t = SMI_Material::Create();
 
@@ -2706,15 +2795,15 @@ public:
 			AttachCopy(fan3, plankTrans18015t);
 
 			SMI_Physics plankphys5t = SMI_Physics(glm::vec3(-223.5, 7.2, 8.8), glm::vec3(90, 0, -90), glm::vec3(14.5157, 103.9552, 0.687242), fan3, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			plankphys5t.setIdentity(2);
+			plankphys5t.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(fan3, plankphys5t);
 		}
 
-		VertexArrayObject::Sptr winwall783 = ObjLoader::LoadFromFile("Models/winwalls.obj");
+		VertexArrayObject::Sptr winwall783 = MeshCache::Load("Models/winwalls.obj");
 		{
 			barrel = CreateEntity();
 			//create texture
-			Texture2D::Sptr winwallTex21511783 = Texture2D::Create("Textures/inside.png");
+			Texture2D::Sptr winwallTex21511783 = TextureCache::Load("Textures/inside.png");
 			//material
 			SMI_Material::Sptr winwall121511783 = SMI_Material::Create();
 
@@ -2736,12 +2825,12 @@ public:
 
 		}
 
-		VertexArrayObject::Sptr edoor = ObjLoader::LoadFromFile("Models/Door2.obj");
+		VertexArrayObject::Sptr edoor = MeshCache::Load("Models/Door2.obj");
 		{
 			door7 = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr edoor215Texture8052 = Texture2D::Create("Textures/doortex.png");
+			Texture2D::Sptr edoor215Texture8052 = TextureCache::Load("Textures/doortex.png");
 			//material
 			SMI_Material::Sptr edoor215gMa8052 = SMI_Material::Create();
 
@@ -2760,16 +2849,16 @@ public:
 			AttachCopy(door7, edoor215Trans180152);
 
 			SMI_Physics edoor215door2phys5 = SMI_Physics(glm::vec3(-185.7, 6.7, 2.5), glm::vec3(90, 0, -90), glm::vec3(4.02, 16.298, 0.13), door7, SMI_PhysicsBodyType::KINEMATIC, 1.0f);
-			edoor215door2phys5.setIdentity(2);
+			edoor215door2phys5.setCollisionLayer(LAYER_GROUND);
 			AttachCopy(door7, edoor215door2phys5);
 		}
 
-		VertexArrayObject::Sptr clear = ObjLoader::LoadFromFile("Models/wi11.obj");
+		VertexArrayObject::Sptr clear = MeshCache::Load("Models/wi11.obj");
 		{
 			ed1 = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr clearTexture805133 = Texture2D::Create("Textures/levcleared.png");
+			Texture2D::Sptr clearTexture805133 = TextureCache::Load("Textures/levcleared.png");
 			//material
 			SMI_Material::Sptr cleargMa805133 = SMI_Material::Create();
 
@@ -2788,464 +2877,229 @@ public:
 			AttachCopy(ed1, clearTrans18015133);
 
 			SMI_Physics clearphys5133 = SMI_Physics(glm::vec3(432.0, -4.2, -7.0), glm::vec3(90, 0, -90), glm::vec3(0.23, 2.819, 0.23), ed1, SMI_PhysicsBodyType::STATIC, 1.0f);
-			clearphys5133.setIdentity(9);
+			clearphys5133.setCollisionLayer(LAYER_BULLET);
 			AttachCopy(ed1, clearphys5133);
 		}
+
+		RegisterCollisions();
 	}
 	
 	void Update(float deltaTime)
 	{
-
-		//increment times
-		current += deltaTime;
-		c += deltaTime;
-		if (current > max)
-		{
-			current = max;
-		}
-		if (c > max)
-		{
-			c = 0;
-
-		}
-		float t = current / max;
-		float time = c / max;
-		
-		//reference to player physics body
-		SMI_Physics& PlayerPhys = GetComponent<SMI_Physics>(character);
-		glm::vec3 NewCamPos = glm::vec3(PlayerPhys.GetPosition().x, camera->GetPosition().y, camera->GetPosition().z);
+		//follow the player's transform rather than its body, since that's what gets drawn (blended between physics steps)
+		glm::vec3 NewCamPos = glm::vec3(GetComponent<SMI_Transform>(character).getPos().x, camera->GetPosition().y, camera->GetPosition().z);
 		camera->SetPosition(NewCamPos);
 
-
-		//keyboard input
-		//move left
-		if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-		{
-			PlayerPhys.AddForce(glm::vec3(5.0, 0, 0));
-		}
-		//move right
-		if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+		//jump presses are caught every frame, and used up by the next physics step
+		if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS && JumpState == GLFW_RELEASE)
 		{
-			PlayerPhys.AddForce(glm::vec3(-5, 0, 0));
-		}
-		
-
-		//jump
-		if ((glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS) && JumpState == GLFW_RELEASE && (grounded || CurrentMidAirJump < MidAirJump))
-		{
-			PlayerPhys.AddImpulse(glm::vec3(0, 0, 6));
-
-			//allows for one mid air jump
-			if (!grounded)
-			{
-				CurrentMidAirJump++;
-			}
+			JumpPressed = true;
 		}
 		JumpState = glfwGetKey(window, GLFW_KEY_SPACE);
 
-
-
-		// LERP example
-
-
 		GetComponent<SMI_Transform>(fan).FixedRotate(glm::vec3(30, 0, 0) * deltaTime * 50.0f);
-
 		GetComponent<SMI_Transform>(fan2).FixedRotate(glm::vec3(30, 0, 0) * deltaTime * 50.0f);
-
 		GetComponent<SMI_Transform>(fan3).FixedRotate(glm::vec3(30, 0, 0) * deltaTime * 50.0f);
 
-		
-
-
-		SMI_Physics& elevator1Phys = GetComponent<SMI_Physics>(elevator);
-		elevator1Phys.SetPosition(Lerp(glm::vec3(-75.0, 7.0, 1.8), glm::vec3(-75.0, 7.0, 8.8), time));
-
-		SMI_Physics& dphys201131 = GetComponent<SMI_Physics>(door1);
-		dphys201131.SetPosition(Lerp(glm::vec3(-46.0, 9.5, 15), glm::vec3(-46.0, 9.5, 2), time));
-
-		SMI_Physics bulletphys513 = GetComponent<SMI_Physics>(bullet);
-		bulletphys513.SetPosition(Lerp(glm::vec3(-179.0, 7.2, 3.9), glm::vec3(-168.0, 7.2, 3.9), time));
-
-		SMI_Physics glidephys51391 = GetComponent<SMI_Physics>(glide);
-		glidephys51391.SetPosition(Lerp(glm::vec3(-198.7, 7.0, 2.3), glm::vec3(-198.7, 7.0, -6.3), time));
-		
-		
+		//the elevator, doors, buttons, bullet and glide all follow the tracks set up in InitScene
 
-		
-		
-		
-
-
-		for (int i = 0; i < Collisions.size(); i++)
+		//once the player reaches an ending, hold the camera on that screen and stop the game
+		if (endScreen != entt::null)
 		{
-			entt::entity Ent1 = Collisions[i]->getB1();
-			entt::entity Ent2 = Collisions[i]->getB2();
+			SMI_Physics& endPhys = GetComponent<SMI_Physics>(endScreen);
+			glm::vec3 EndCamPos = glm::vec3(endPhys.GetPosition().x, camera->GetPosition().y, camera->GetPosition().z);
+			camera->SetPosition(EndCamPos);
 
-			if (GetRegistry().valid(Ent1) && GetRegistry().valid(Ent2))
-			{
-				bool cont = true;
+			deltaTime = 0.0;
 
-				SMI_Physics Phys1 = GetComponent<SMI_Physics>(Ent1);
-				SMI_Physics Phys2 = GetComponent<SMI_Physics>(Ent2);
-				if ((cont && ((Phys1.getIdentity() == 1 && Phys2.getIdentity() == 3))))
-				{
-
-					
-					SMI_Physics& door2phys5 = GetComponent<SMI_Physics>(door2);
-					door2phys5.SetPosition(Lerp(glm::vec3(-151.0, 7.0, 2.5), glm::vec3(151.0, 7.0, 6.5), t));
-
-					SMI_Physics& buttonphys5 = GetComponent<SMI_Physics>(button);
-					buttonphys5.SetPosition(Lerp(glm::vec3(-158.0, 6.7, 2.1), glm::vec3(-158.0, -34.7, 2.1), t));
-
-					SMI_Physics& buttonphys51 = GetComponent<SMI_Physics>(button1);
-					buttonphys51.SetPosition(Lerp(glm::vec3(-158.0, -34.7, 2.1), glm::vec3(-158.0, 6.7, 2.1), t));
-				}
-			}
-		}
-		for (int i = 0; i < Collisions.size(); i++)
-		{
-			entt::entity Ent1 = Collisions[i]->getB1();
-			entt::entity Ent2 = Collisions[i]->getB2();
-
-			if (GetRegistry().valid(Ent1) && GetRegistry().valid(Ent2))
+			if (glfwGetKey(window, GLFW_KEY_E))
 			{
-				bool cont = true;
-
-				SMI_Physics Phys1 = GetComponent<SMI_Physics>(Ent1);
-				SMI_Physics Phys2 = GetComponent<SMI_Physics>(Ent2);
-				if ((cont && ((Phys1.getIdentity() == 4 && Phys2.getIdentity() == 5|| Phys1.getIdentity() == 1 && Phys2.getIdentity() == 5))))
-				{
-					
-					SMI_Physics& door2phys52 = GetComponent<SMI_Physics>(door3);
-					door2phys52.SetPosition(Lerp(glm::vec3(-166.7, 7.0, 2.5), glm::vec3(-166.7, -34.0, 2.5), t));
-				}
-				
-				else if((cont && ((Phys1.getIdentity() == 2 && Phys2.getIdentity() == 4))))
-				{
-
-						SMI_Physics& door2phys52 = GetComponent<SMI_Physics>(door3);
-						door2phys52.SetPosition(Lerp(glm::vec3(-166.7, 7.0, 2.5), glm::vec3(-166.7, 7.0, 2.5), t));
-				}
-
-				
+				exit(1);
 			}
 		}
-		for (int i = 0; i < Collisions.size(); i++)
-		{
-			
-			
-			entt::entity Ent1 = Collisions[i]->getB1();
-			entt::entity Ent2 = Collisions[i]->getB2();
-
-			if (GetRegistry().valid(Ent1) && GetRegistry().valid(Ent2))
-			{
-				
-				bool cont = true;
-
-				SMI_Physics Phys1 = GetComponent<SMI_Physics>(Ent1);
-				SMI_Physics Phys2 = GetComponent<SMI_Physics>(Ent2);
-				if ((cont && ((Phys1.getIdentity() == 1 && Phys2.getIdentity() == 6))))
-				{
-
-					
-					
-					GetComponent<SMI_Transform>(door4).setPos(Lerp(glm::vec3(-12.5, 9.2, 2.0), glm::vec3(-12.5, -9.2, 2.0), t));
-					
-					SMI_Physics& bardoorphys = GetComponent<SMI_Physics>(door4);
-					bardoorphys.SetPosition(Lerp(glm::vec3(-12.5, 9.2, 2.0), glm::vec3(-12.5, -9.2, 2.0), t));
-
-					SMI_Physics& buttonphys59 = GetComponent<SMI_Physics>(button6);
-					buttonphys59.SetPosition(Lerp(glm::vec3(-12.5, 7.7, 15.1), glm::vec3(-12.5, -87.7, 15.1), t));
 
-					SMI_Physics& buttonphys159 = GetComponent<SMI_Physics>(button7);
-					buttonphys159.SetPosition(Lerp(glm::vec3(-12.5, -87.7, 15.1), glm::vec3(-12.5, 7.7, 15.1), t));
-					
+		SMI_Scene::Update(deltaTime);
+	}
 
-				}
-			}
-		}
-		for (int i = 0; i < Collisions.size(); i++)
-		{
-			entt::entity Ent1 = Collisions[i]->getB1();
-			entt::entity Ent2 = Collisions[i]->getB2();
+	void FixedUpdate(float fixedTimeStep)
+	{
+		SMI_Physics& PlayerPhys = GetComponent<SMI_Physics>(character);
 
-			if (GetRegistry().valid(Ent1) && GetRegistry().valid(Ent2))
-			{
-				bool cont = true;
-
-				SMI_Physics Phys1 = GetComponent<SMI_Physics>(Ent1);
-				SMI_Physics Phys2 = GetComponent<SMI_Physics>(Ent2);
-				if ((cont && ((Phys1.getIdentity() == 1 && Phys2.getIdentity() == 7 || Phys1.getIdentity() == 7 && Phys2.getIdentity() == 1))))
-				{	
-					
-					SMI_Physics& bulletphys5133 = GetComponent<SMI_Physics>(ed);
-					glm::vec3 NewCamPos = glm::vec3(bulletphys5133.GetPosition().x, camera->GetPosition().y, camera->GetPosition().z);
-					camera->SetPosition(NewCamPos);
-
-					deltaTime = 0.0;
-
-					if (glfwGetKey(window, GLFW_KEY_E))
-					{
-						exit(1);
-					}
-					
-				}
-			}
-		}
-		for (int i = 0; i < Collisions.size(); i++)
+		//keyboard input
+		//move left
+		if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
 		{
-			entt::entity Ent1 = Collisions[i]->getB1();
-			entt::entity Ent2 = Collisions[i]->getB2();
-
-			if (GetRegistry().valid(Ent1) && GetRegistry().valid(Ent2))
-			{
-				bool cont = true;
-
-				SMI_Physics Phys1 = GetComponent<SMI_Physics>(Ent1);
-				SMI_Physics Phys2 = GetComponent<SMI_Physics>(Ent2);
-				if ((cont && ((Phys1.getIdentity() == 1 && Phys2.getIdentity() == 8 || Phys1.getIdentity() == 8 && Phys2.getIdentity() == 1))))
-				{
-					SMI_Physics& bulletphys5133 = GetComponent<SMI_Physics>(ed);
-					glm::vec3 NewCamPos = glm::vec3(bulletphys5133.GetPosition().x, camera->GetPosition().y, camera->GetPosition().z);
-					camera->SetPosition(NewCamPos);
-
-					deltaTime = 0.0;
-
-					if (glfwGetKey(window, GLFW_KEY_E))
-					{
-						exit(1);
-					}
-
-				}
-			}
+			PlayerPhys.AddForce(glm::vec3(5.0, 0, 0));
 		}
-		for (int i = 0; i < Collisions.size(); i++)
+		//move right
+		if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
 		{
-			entt::entity Ent1 = Collisions[i]->getB1();
-			entt::entity Ent2 = Collisions[i]->getB2();
-
-			if (GetRegistry().valid(Ent1) && GetRegistry().valid(Ent2))
-			{
-				bool cont = true;
-
-				SMI_Physics Phys1 = GetComponent<SMI_Physics>(Ent1);
-				SMI_Physics Phys2 = GetComponent<SMI_Physics>(Ent2);
-				if ((cont && ((Phys1.getIdentity() == 1 && Phys2.getIdentity() == 9 || Phys1.getIdentity() == 9 && Phys2.getIdentity() == 1))))
-				{
-
-					SMI_Physics& bulletphys5133 = GetComponent<SMI_Physics>(ed);
-					glm::vec3 NewCamPos = glm::vec3(bulletphys5133.GetPosition().x, camera->GetPosition().y, camera->GetPosition().z);
-					camera->SetPosition(NewCamPos);
-
-					deltaTime = 0.0;
-
-					if (glfwGetKey(window, GLFW_KEY_E))
-					{
-						exit(1);
-					}
-
-				}
-			}
+			PlayerPhys.AddForce(glm::vec3(-5, 0, 0));
 		}
-		for (int i = 0; i < Collisions.size(); i++)
-		{
-			entt::entity Ent1 = Collisions[i]->getB1();
-			entt::entity Ent2 = Collisions[i]->getB2();
-
-			if (GetRegistry().valid(Ent1) && GetRegistry().valid(Ent2))
-			{
-				bool cont = true;
-
-				SMI_Physics Phys1 = GetComponent<SMI_Physics>(Ent1);
-				SMI_Physics Phys2 = GetComponent<SMI_Physics>(Ent2);
-				if ((cont && ((Phys1.getIdentity() == 10 && Phys2.getIdentity() == 11 || Phys1.getIdentity() == 11 && Phys2.getIdentity() == 10))))
-				{
-
-					SMI_Physics bulletphys513 = GetComponent<SMI_Physics>(bullet);
-					bulletphys513.SetPosition(glm::vec3(-168.0, 7.2, 68.9));
 
-
-					SMI_Physics& enemyPhys = GetComponent<SMI_Physics>(en);
-					enemyPhys.SetPosition(glm::vec3(-181.0, 400.8, 2.2));
-
-					SMI_Physics enemyPhys1 = GetComponent<SMI_Physics>(en1);
-					enemyPhys1.SetPosition(glm::vec3(-181.0, 7.2, 2.3));
-
-
-					SMI_Physics& door215door2phys5 = GetComponent<SMI_Physics>(door7);
-					door215door2phys5.SetPosition(glm::vec3(-185.7, -47.0, 2.5));
-
-				}
-			
-			}
-		}
-		for (int i = 0; i < Collisions.size(); i++)
+		//jump, grounded is from the step before this one
+		if (JumpPressed && (grounded || CurrentMidAirJump < MidAirJump))
 		{
-			entt::entity Ent1 = Collisions[i]->getB1();
-			entt::entity Ent2 = Collisions[i]->getB2();
+			PlayerPhys.AddImpulse(glm::vec3(0, 0, 6));
 
-			if (GetRegistry().valid(Ent1) && GetRegistry().valid(Ent2))
+			//allows for one mid air jump
+			if (!grounded)
 			{
-				bool cont = true;
-
-				SMI_Physics Phys1 = GetComponent<SMI_Physics>(Ent1);
-				SMI_Physics Phys2 = GetComponent<SMI_Physics>(Ent2);
-				if ((cont && ((Phys1.getIdentity() == 1 && Phys2.getIdentity() == 12 || Phys1.getIdentity() == 12 && Phys2.getIdentity() == 1))))
-				{
-
-
-					SMI_Physics& plankphys5 = GetComponent<SMI_Physics>(planks);
-					plankphys5.SetPosition(glm::vec3(-182.5, 6.5, -434.8));
-
-
-				}
-			
+				CurrentMidAirJump++;
 			}
 		}
+		JumpPressed = false;
 
-		for (int i = 0; i < Collisions.size(); i++)
-		{
-			entt::entity Ent1 = Collisions[i]->getB1();
-			entt::entity Ent2 = Collisions[i]->getB2();
+		//the collision callbacks set this again after the step if the player is still on the ground
+		grounded = false;
+	}
 
-			if (GetRegistry().valid(Ent1) && GetRegistry().valid(Ent2))
+	//the layers our bodies are put in, RegisterCollisions decides what happens when two of them touch
+	enum CollisionLayer : int
+	{
+		LAYER_PLAYER = 1,
+		//the ground, walls and anything else the player can stand on
+		LAYER_GROUND = 2,
+		LAYER_DOOR2_BUTTON = 3,
+		//crates that hold the plate for the third door down
+		LAYER_CRATE = 4,
+		LAYER_DOOR3_PLATE = 5,
+		LAYER_BAR_BUTTON = 6,
+		//the ceiling fans, touching them is game over
+		LAYER_HAZARD = 7,
+		LAYER_CRUSHING_DOOR = 8,
+		//the enemy's bullet, the game over and level clear screens' bodies are kept in it too
+		LAYER_BULLET = 9,
+		LAYER_ENEMY = 10,
+		//the crate that gets dropped on the enemy
+		LAYER_ENEMY_CRATE = 11,
+		LAYER_PLANK_BUTTON = 12,
+		LAYER_DOOR8_BUTTON = 13,
+		LAYER_GLIDER = 14,
+		//the crate that can hold down the last button to move the fan
+		LAYER_FAN_CRATE = 15,
+		LAYER_LEVEL_END = 16
+	};
+
+	//runs handler every physics step that a body in layerA is touching a body in layerB
+	void WhileTouching(int layerA, int layerB, const std::function<void()>& handler)
+	{
+		RegisterCollisionCallback(layerA, layerB, [handler](entt::entity, entt::entity, SMI_ContactEvent event) {
+			if (event != SMI_ContactEvent::END)
 			{
-				bool cont = true;
-
-				SMI_Physics Phys1 = GetComponent<SMI_Physics>(Ent1);
-				SMI_Physics Phys2 = GetComponent<SMI_Physics>(Ent2);
-				if ((cont && ((Phys1.getIdentity() == 1 && Phys2.getIdentity() == 13 || Phys1.getIdentity() == 13 && Phys2.getIdentity() == 1))))
-				{
-
-					
-					SMI_Physics& door215door2phys5 = GetComponent<SMI_Physics>(door8);
-					door215door2phys5.SetPosition(glm::vec3(-209.0, 327.0, 2.5));
-
-				}
-
+				handler();
 			}
-		}
-		for (int i = 0; i < Collisions.size(); i++)
-		{
-			entt::entity Ent1 = Collisions[i]->getB1();
-			entt::entity Ent2 = Collisions[i]->getB2();
-
-			if (GetRegistry().valid(Ent1) && GetRegistry().valid(Ent2))
-			{
-				bool cont = true;
-
-				SMI_Physics Phys1 = GetComponent<SMI_Physics>(Ent1);
-				SMI_Physics Phys2 = GetComponent<SMI_Physics>(Ent2);
-				if ((cont && ((Phys1.getIdentity() == 1 && Phys2.getIdentity() == 14 || Phys1.getIdentity() == 14 && Phys2.getIdentity() == 1))))
-				{
-
-					SMI_Physics& bulletphys5133 = GetComponent<SMI_Physics>(ed);
-					glm::vec3 NewCamPos = glm::vec3(bulletphys5133.GetPosition().x, camera->GetPosition().y, camera->GetPosition().z);
-					camera->SetPosition(NewCamPos);
-
-					deltaTime = 0.0;
-
-					if (glfwGetKey(window, GLFW_KEY_E))
-					{
-						exit(1);
-					}
-
-				}
+		});
+	}
 
-			}
-		}
+	//a track from one spot to another that takes max seconds, for doors and buttons that wait until something sets
+	//them off. It starts paused at the first spot
+	SMI_KinematicController SlideTrack(const glm::vec3& from, const glm::vec3& to)
+	{
+		SMI_KinematicController track = SMI_KinematicController();
+		track.addKeyframe(0.f, from);
+		track.addKeyframe(max, to);
+		track.setTrackMode(SMI_TrackMode::ONCE);
+		track.Pause();
+		return track;
+	}
 
-		for (int i = 0; i < Collisions.size(); i++)
+	//plays an entity's SlideTrack forwards (speed 1) or backwards (speed -1). The touch callbacks call this every step,
+	//so it leaves the track alone if it's already heading that way or has got there
+	void Slide(entt::entity entity, float speed)
+	{
+		SMI_KinematicController& track = GetComponent<SMI_KinematicController>(entity);
+		bool there = speed > 0.f ? track.getTrackTime() >= track.getTrackLength() : track.getTrackTime() <= 0.f;
+		if (there || (track.isPlaying() && track.getSpeed() == speed))
 		{
-			entt::entity Ent1 = Collisions[i]->getB1();
-			entt::entity Ent2 = Collisions[i]->getB2();
-
-			if (GetRegistry().valid(Ent1) && GetRegistry().valid(Ent2))
-			{
-				bool cont = true;
-
-				SMI_Physics Phys1 = GetComponent<SMI_Physics>(Ent1);
-				SMI_Physics Phys2 = GetComponent<SMI_Physics>(Ent2);
-				if ((cont && ((Phys1.getIdentity() == 15 && Phys2.getIdentity() == 13 || Phys1.getIdentity() == 13 && Phys2.getIdentity() == 15))))
-				{
-
-
-					SMI_Physics& plankphys5t = GetComponent<SMI_Physics>(fan3);
-					plankphys5t.SetPosition(glm::vec3(-223.5, 7.2, 434.8));
-
-					
-				}
-
-			}
+			return;
 		}
-		
-		for (int i = 0; i < Collisions.size(); i++)
-		{
-			entt::entity Ent1 = Collisions[i]->getB1();
-			entt::entity Ent2 = Collisions[i]->getB2();
-
-			if (GetRegistry().valid(Ent1) && GetRegistry().valid(Ent2))
-			{
-				bool cont = true;
 
-				SMI_Physics Phys1 = GetComponent<SMI_Physics>(Ent1);
-				SMI_Physics Phys2 = GetComponent<SMI_Physics>(Ent2);
-				if ((cont && ((Phys1.getIdentity() == 1 && Phys2.getIdentity() == 16 || Phys1.getIdentity() == 16 && Phys2.getIdentity() == 1))))
-				{
-
-
-					SMI_Physics& clearphys5133 = GetComponent<SMI_Physics>(ed1);
-					glm::vec3 NewCamPos = glm::vec3(clearphys5133.GetPosition().x, camera->GetPosition().y, camera->GetPosition().z);
-					camera->SetPosition(NewCamPos);
-
-					deltaTime = 0.0;
-
-					if (glfwGetKey(window, GLFW_KEY_E))
-					{
-						exit(1);
-					}
-
-
-				}
-
-			}
+		track.setSpeed(speed);
+		if (!track.isPlaying())
+		{
+			track.Play();
 		}
-		
-
-		
-		SMI_Scene::Update(deltaTime);
-
-		grounded = false;
-
-		//checks every collision type
-		Collider();
-
-
 	}
 
-	//manages all collisions in the game
-	void Collider()
+	//sets up what happens when things touch, layers are set with setCollisionLayer when each body is made
+	void RegisterCollisions()
 	{
-		for (int i = 0; i < Collisions.size(); i++)
-		{
-			entt::entity Ent1 = Collisions[i]->getB1();
-			entt::entity Ent2 = Collisions[i]->getB2();
-
-			if (GetRegistry().valid(Ent1) && GetRegistry().valid(Ent2))
-			{
-				bool cont = true;
-
-				SMI_Physics Phys1 = GetComponent<SMI_Physics>(Ent1);
-				SMI_Physics Phys2 = GetComponent<SMI_Physics>(Ent2);
-
-				if (cont && ((Phys1.getIdentity() == 1 && Phys2.getIdentity() == 2) || (Phys1.getIdentity() == 2 && Phys2.getIdentity() == 1)))
-				{
-					grounded = true;
-					CurrentMidAirJump = 0;
-				}
-
-			}
-		}
+		//player standing on the ground
+		WhileTouching(LAYER_PLAYER, LAYER_GROUND, [this]() {
+			grounded = true;
+			CurrentMidAirJump = 0;
+		});
+
+		//player pressing the button for the second door
+		WhileTouching(LAYER_PLAYER, LAYER_DOOR2_BUTTON, [this]() {
+			Slide(door2, 1.f);
+			Slide(button, 1.f);
+			Slide(button1, 1.f);
+		});
+
+		//a crate or the player holding down the plate for the third door, which closes again when a crate is on the ground
+		auto openDoor3 = [this]() {
+			Slide(door3, 1.f);
+		};
+		WhileTouching(LAYER_CRATE, LAYER_DOOR3_PLATE, openDoor3);
+		WhileTouching(LAYER_PLAYER, LAYER_DOOR3_PLATE, openDoor3);
+		WhileTouching(LAYER_GROUND, LAYER_CRATE, [this]() {
+			Slide(door3, -1.f);
+		});
+
+		//player pressing the button for the bar door
+		WhileTouching(LAYER_PLAYER, LAYER_BAR_BUTTON, [this]() {
+			Slide(door4, 1.f);
+			Slide(button6, 1.f);
+			Slide(button7, 1.f);
+		});
+
+		//anything that kills the player sends them to the game over screen
+		auto gameOver = [this]() {
+			endScreen = ed;
+		};
+		WhileTouching(LAYER_PLAYER, LAYER_HAZARD, gameOver);
+		WhileTouching(LAYER_PLAYER, LAYER_CRUSHING_DOOR, gameOver);
+		WhileTouching(LAYER_PLAYER, LAYER_BULLET, gameOver);
+		WhileTouching(LAYER_PLAYER, LAYER_GLIDER, gameOver);
+
+		//reaching the end of the level
+		WhileTouching(LAYER_PLAYER, LAYER_LEVEL_END, [this]() {
+			endScreen = ed1;
+		});
+
+		//a crate landing on the enemy
+		WhileTouching(LAYER_ENEMY, LAYER_ENEMY_CRATE, [this]() {
+			//stop the bullet's track first, or it would be pulled straight back
+			GetComponent<SMI_KinematicController>(bullet).Pause();
+			SMI_Physics& bulletphys513 = GetComponent<SMI_Physics>(bullet);
+			bulletphys513.SetPosition(glm::vec3(-168.0, 7.2, 68.9));
+
+			SMI_Physics& enemyPhys = GetComponent<SMI_Physics>(en);
+			enemyPhys.SetPosition(glm::vec3(-181.0, 400.8, 2.2));
+
+			SMI_Physics& enemyPhys1 = GetComponent<SMI_Physics>(en1);
+			enemyPhys1.SetPosition(glm::vec3(-181.0, 7.2, 2.3));
+
+			SMI_Physics& door215door2phys5 = GetComponent<SMI_Physics>(door7);
+			door215door2phys5.SetPosition(glm::vec3(-185.7, -47.0, 2.5));
+		});
+
+		WhileTouching(LAYER_PLAYER, LAYER_PLANK_BUTTON, [this]() {
+			SMI_Physics& plankphys5 = GetComponent<SMI_Physics>(planks);
+			plankphys5.SetPosition(glm::vec3(-182.5, 6.5, -434.8));
+		});
+
+		WhileTouching(LAYER_PLAYER, LAYER_DOOR8_BUTTON, [this]() {
+			SMI_Physics& door215door2phys5 = GetComponent<SMI_Physics>(door8);
+			door215door2phys5.SetPosition(glm::vec3(-209.0, 327.0, 2.5));
+		});
+
+		WhileTouching(LAYER_FAN_CRATE, LAYER_DOOR8_BUTTON, [this]() {
+			SMI_Physics& plankphys5t = GetComponent<SMI_Physics>(fan3);
+			plankphys5t.SetPosition(glm::vec3(-223.5, 7.2, 434.8));
+		});
 	}
 
 	~GameScene1() = default;
@@ -3280,14 +3134,16 @@ private:
 	entt::entity planks;
 	entt::entity glide;
 	float max = 5;
-	float current = 0;
-	float c = 0;
 
 	//variables for jump checks
 	int JumpState = GLFW_RELEASE;
+	bool JumpPressed = false;
 	int MidAirJump = 1;
 	int CurrentMidAirJump = 0;
 	bool grounded = false;
+
+	//set when the player reaches an ending, this is the screen the camera moves to
+	entt::entity endScreen = entt::null;
 };
 
 
@@ -3320,12 +3176,12 @@ public:
 		camera1->SetOrthoVerticalScale(20);
 		setCamera(camera1);
 
-		VertexArrayObject::Sptr menuback = ObjLoader::LoadFromFile("Models/menu2.obj");
+		VertexArrayObject::Sptr menuback = MeshCache::Load("Models/menu2.obj");
 		{
 			menu = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr owindow1Texturet = Texture2D::Create("Textures/Main_Menu.png");
+			Texture2D::Sptr owindow1Texturet = TextureCache::Load("Textures/Main_Menu.png");
 			//material
 			SMI_Material::Sptr oBarrelMatt = SMI_Material::Create();
 			oBarrelMatt->setShader(shader1);
@@ -3391,12 +3247,12 @@ public:
 		camera2->SetOrthoVerticalScale(20);
 		setCamera(camera2);
 
-		VertexArrayObject::Sptr yt1 = ObjLoader::LoadFromFile("Models/menu2.obj");
+		VertexArrayObject::Sptr yt1 = MeshCache::Load("Models/menu2.obj");
 		{
 			rt1 = CreateEntity();
 
 			//create texture
-			Texture2D::Sptr window1Texturet1 = Texture2D::Create("Textures/Pause_Screen.png");
+			Texture2D::Sptr window1Texturet1 = TextureCache::Load("Textures/Pause_Screen.png");
 			//material
 			SMI_Material::Sptr BarrelMatt1 = SMI_Material::Create();
 			BarrelMatt1->setShader(shader1);
@@ -3431,10 +3287,17 @@ private:
 
 
 //main game loop inside here as well as call all needed shaders
-int main()
+int main(int argc, char** argv)
 {
 	Logger::Init(); // We'll borrow the logger from the toolkit, but we need to initialize it
 
+	// Offline mode, bake our models and textures and exit without opening a window
+	if (argc > 1 && std::string(argv[1]) == "--bake") {
+		int failures = AssetBaker::BakeModels("Models") + AssetBaker::BakeTextures("Textures");
+		Logger::Uninitialize();
+		return failures == 0 ? 0 : 1;
+	}
+
 	//Initialize GLFW
 	if (!initGLFW())
 		return 1;
@@ -3448,17 +3311,33 @@ int main()
 	glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
 	glDebugMessageCallback(GlDebugMessage, nullptr);
 
+	// Start our loader threads and queue up everything the scenes will need
+	AssetLoader::Init();
+	// Set up the ring buffer that our per-frame and per-material uniform blocks are written into
+	UniformBlocks::Init();
+	// Decoded textures take a lot more memory than the PNGs on disk, keep them from taking over the GPU
+	TextureCache::SetBudget(256 * 1024 * 1024);
+	prefetchAssets();
+
 
 
 	// Our high-precision timer
 	double lastFrame = glfwGetTime();
 
-	GameScene2 Ma = GameScene2();
-	Ma.InitScene();
-	GameScene1 MainScene = GameScene1();
-	MainScene.InitScene();
-	GameScene3 Pausescreen = GameScene3();
-	Pausescreen.InitScene();
+	// The scenes are destroyed before the shape cache is cleared, since their bodies use its shapes
+	std::unique_ptr<GameScene2> Ma = std::make_unique<GameScene2>();
+	Ma->InitScene();
+	std::unique_ptr<GameScene1> MainScene = std::make_unique<GameScene1>();
+	MainScene->InitScene();
+	std::unique_ptr<GameScene3> Pausescreen = std::make_unique<GameScene3>();
+	Pausescreen->InitScene();
+
+	// Every repeated model in the scenes should have come from the cache
+	LOG_INFO("Mesh cache: {} meshes loaded, {} hits, {} misses", MeshCache::GetSize(), MeshCache::GetStats().Hits, MeshCache::GetStats().Misses);
+	LOG_INFO("Texture cache: {} textures loaded ({} KB), {} hits, {} misses", TextureCache::GetSize(), TextureCache::GetResidentBytes() / 1024,
+		TextureCache::GetStats().Hits, TextureCache::GetStats().Misses);
+	LOG_INFO("Shape cache: {} collision shapes, {} hits, {} misses, {} BVHs loaded, {} built", ShapeCache::GetSize(),
+		ShapeCache::GetStats().Hits, ShapeCache::GetStats().Misses, ShapeCache::GetStats().BvhLoads, ShapeCache::GetStats().BvhBuilds);
 
 	bool isButtonPressed = false;
 	bool it = false;
@@ -3475,6 +3354,8 @@ int main()
 	Sound audio3;
 	
 
+	bool loggedRenderStats = false;
+
 	///// Game loop /////
 	while (!glfwWindowShouldClose(window)) {
 
@@ -3484,6 +3365,12 @@ int main()
 		float dt = static_cast<float>(thisFrame - lastFrame);
 
 
+		// Upload anything that finished loading in the background, without letting it eat up the whole frame
+		AssetLoader::ProcessUploads(0.002f);
+
+		// Move on to the next section of the uniform ring buffer
+		UniformBlocks::BeginFrame(static_cast<float>(thisFrame), dt);
+
 		// Clear the color and depth buffers
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -3517,16 +3404,28 @@ int main()
 
 		if (!notmenu && notpause)
 		{
-			MainScene.Render();
-			MainScene.Update(dt);
+			MainScene->Render();
+			MainScene->Update(dt);
+
+			if (!loggedRenderStats)
+			{
+				const SMI_Scene::RenderStats& stats = MainScene->getRenderStats();
+				LOG_INFO("Main scene: {} objects in {} draw calls ({} instanced draws covering {} objects), {} of {} culled",
+					stats.Objects, stats.DrawCalls, stats.InstancedDraws, stats.InstancedObjects, stats.Culled, stats.CullTested);
+				const RenderQueue::Stats& queueStats = MainScene->getQueueStats();
+				LOG_INFO("Render queue: {} packets, {} shader binds ({} skipped), {} texture binds ({} skipped), {} VAO binds ({} skipped)",
+					queueStats.Packets, queueStats.ShaderBinds, queueStats.ShaderBindsElided, queueStats.TextureBinds,
+					queueStats.TextureBindsElided, queueStats.VaoBinds, queueStats.VaoBindsElided);
+				loggedRenderStats = true;
+			}
 		}
 		if (notmenu)
 		{
-			Ma.Render();
+			Ma->Render();
 		}
 		if (!notmenu && !notpause)
 		{
-			Pausescreen.Render();
+			Pausescreen->Render();
 			if (glfwGetKey(window, GLFW_KEY_E))
 			{
 				exit(1);
@@ -3573,10 +3472,27 @@ int main()
 			*/
 
 			lastFrame = thisFrame;
+			UniformBlocks::EndFrame();
 			glfwSwapBuffers(window);
+
+			// Free up textures that haven't been used in a while if we're over budget
+			TextureCache::EnforceBudget();
 		}
 	}
 
+	const SMI_Scene::PhysicsStats& physicsStats = MainScene->getPhysicsStats();
+	LOG_INFO("Physics: {} fixed steps of {} ms, {:.2f} s of simulation time dropped", physicsStats.TotalSubSteps,
+		MainScene->getFixedTimeStep() * 1000.0f, physicsStats.TotalTimeDropped);
+	LOG_INFO("Physics: {} bodies awake, {} asleep", MainScene->getActiveBodyCount(), MainScene->getSleepingBodyCount());
+
+	Ma.reset();
+	MainScene.reset();
+	Pausescreen.reset();
+	ShapeCache::Clear();
+
+	AssetLoader::Shutdown();
+	UniformBlocks::Shutdown();
+
 	// Clean up the toolkit logger so we don't leak memory
 	Logger::Uninitialize();
 	return 0;
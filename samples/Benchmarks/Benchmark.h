@@ -0,0 +1,22 @@
+// Shared by every benchmark in this folder. Each benchmark is a small console program that builds the parts of the
+// game it measures straight from the game's source (ex: #include "../../../../projects/GDW/src/Physics.cpp") instead
+// of linking the whole game, so it runs exactly the code the game does without needing a window, OpenGL or assets.
+// Include this first, then the game's headers and sources. Run the benchmarks in Release, the numbers from a debug
+// build are meaningless
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::high_resolution_clock;
+
+// The time since start, in milliseconds
+inline double Millis(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
@@ -0,0 +1,184 @@
+// Compares how SMI_Scene used to collect collisions (a shared_ptr per penetrating contact point, then a scan of every
+// collision found so far to throw out repeats) against CollisionTracker, on scenes with thousands of resting contacts.
+// Boxes are stacked in a grid on the ground and left to settle, then both are run on the same manifolds every step.
+// Run it in Release
+#include "../../Benchmark.h"
+
+#include <atomic>
+#include <new>
+
+#include "btBulletDynamicsCommon.h"
+
+// CollisionTracker only needs SMI_Collision from the physics code
+#include "../../../../projects/GDW/src/Physics.cpp"
+#include "../../../../projects/GDW/src/CollisionTracker.cpp"
+#include "../../../../projects/GDW/src/Utils/ShapeCache.cpp"
+
+static const int SETTLE_STEPS = 120;
+static const int STEPS = 200;
+
+// Every allocation bumps this, so we can see how many each way of collecting collisions makes
+static std::atomic<size_t> allocations(0);
+
+void* operator new(size_t size)
+{
+	allocations++;
+	void* result = std::malloc(size == 0 ? 1 : size);
+	if (result == nullptr) {
+		throw std::bad_alloc();
+	}
+	return result;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+static entt::entity GetBodyEntity(const btCollisionObject* body)
+{
+	return static_cast<entt::entity>(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(body->getUserPointer())));
+}
+
+// The old version of SMI_Scene::CollisionManage
+static void LegacyCollisionManage(btDispatcher* dispatcher, std::vector<std::shared_ptr<SMI_Collision>>& collisions)
+{
+	collisions.clear();
+
+	int manifolds = dispatcher->getNumManifolds();
+	for (int i = 0; i < manifolds; i++) {
+		btPersistentManifold* contact = dispatcher->getManifoldByIndexInternal(i);
+		int numcon = contact->getNumContacts();
+		for (int j = 0; j < numcon; j++) {
+			if (contact->getContactPoint(j).getDistance() < 0.f) {
+				std::shared_ptr<SMI_Collision> newCollide = std::make_shared<SMI_Collision>(
+					GetBodyEntity(contact->getBody0()), GetBodyEntity(contact->getBody1()), SMI_ContactEvent::BEGIN);
+
+				bool add = true;
+				for (size_t k = 0; k < collisions.size(); k++) {
+					if (SMI_Collision::Same(*newCollide, *collisions[k])) {
+						add = false;
+						break;
+					}
+				}
+
+				if (add) {
+					collisions.push_back(newCollide);
+				}
+			}
+		}
+	}
+}
+
+static void Run(int width, int height)
+{
+	btDefaultCollisionConfiguration config;
+	btCollisionDispatcher dispatcher(&config);
+	btDbvtBroadphase broadphase;
+	btSequentialImpulseConstraintSolver solver;
+	btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &solver, &config);
+	world.setGravity(btVector3(0.0f, -9.8f, 0.0f));
+
+	std::vector<std::unique_ptr<btCollisionShape>> shapes;
+	std::vector<std::unique_ptr<btDefaultMotionState>> motionStates;
+	std::vector<std::unique_ptr<btRigidBody>> bodies;
+	auto addBody = [&](btCollisionShape* shape, const btVector3& position, float mass) {
+		btVector3 inertia(0.0f, 0.0f, 0.0f);
+		if (mass > 0.0f) {
+			shape->calculateLocalInertia(mass, inertia);
+		}
+		btTransform transform;
+		transform.setIdentity();
+		transform.setOrigin(position);
+		motionStates.emplace_back(new btDefaultMotionState(transform));
+		bodies.emplace_back(new btRigidBody(btRigidBody::btRigidBodyConstructionInfo(mass, motionStates.back().get(), shape, inertia)));
+		bodies.back()->setUserPointer(reinterpret_cast<void*>(static_cast<uintptr_t>(bodies.size() - 1)));
+		// Like the game, bodies never go to sleep, so Bullet keeps every contact up to date
+		bodies.back()->setActivationState(DISABLE_DEACTIVATION);
+		world.addRigidBody(bodies.back().get());
+	};
+
+	float extent = static_cast<float>(width);
+	shapes.emplace_back(new btBoxShape(btVector3(extent, 1.0f, extent)));
+	addBody(shapes.back().get(), btVector3(0.0f, -1.0f, 0.0f), 0.0f);
+
+	// Columns of boxes, with a small gap so neighbouring columns don't lean on each other
+	shapes.emplace_back(new btBoxShape(btVector3(0.5f, 0.5f, 0.5f)));
+	btCollisionShape* box = shapes.back().get();
+	for (int x = 0; x < width; x++) {
+		for (int z = 0; z < width; z++) {
+			for (int y = 0; y < height; y++) {
+				addBody(box, btVector3(x * 1.1f - width * 0.55f, 0.5f + y * 1.0f, z * 1.1f - width * 0.55f), 1.0f);
+			}
+		}
+	}
+
+	for (int step = 0; step < SETTLE_STEPS; step++) {
+		world.stepSimulation(1.0f / 60.0f, 0);
+	}
+
+	CollisionTracker tracker;
+	std::vector<std::shared_ptr<SMI_Collision>> legacy;
+	double legacyTime = 0.0;
+	double trackerTime = 0.0;
+	size_t legacyAllocs = 0;
+	size_t trackerAllocs = 0;
+	size_t pairs = 0;
+	size_t began = 0;
+	size_t ended = 0;
+	size_t mismatches = 0;
+	for (int step = 0; step < STEPS; step++) {
+		world.stepSimulation(1.0f / 60.0f, 0);
+
+		size_t allocs = allocations;
+		Clock::time_point start = Clock::now();
+		LegacyCollisionManage(&dispatcher, legacy);
+		legacyTime += Millis(start);
+		legacyAllocs += allocations - allocs;
+
+		allocs = allocations;
+		start = Clock::now();
+		tracker.Update(&dispatcher);
+		trackerTime += Millis(start);
+		// The first step has to size the buffers, after that there should be nothing
+		if (step > 0) {
+			trackerAllocs += allocations - allocs;
+		}
+
+		pairs += tracker.GetContacts().size();
+		ended += tracker.GetEnded().size();
+		for (const SMI_Collision& contact : tracker.GetContacts()) {
+			began += contact.getEvent() == SMI_ContactEvent::BEGIN ? 1 : 0;
+		}
+		if (legacy.size() != tracker.GetContacts().size()) {
+			mismatches++;
+		}
+	}
+
+	for (auto& body : bodies) {
+		world.removeRigidBody(body.get());
+	}
+
+	printf("%8zu %9d %12.3f %12.3f %8.1fx %14.1f %14.1f %8zu %8zu %10zu\n", bodies.size(), dispatcher.getNumManifolds(),
+		legacyTime / STEPS, trackerTime / STEPS, legacyTime / trackerTime,
+		static_cast<double>(legacyAllocs) / STEPS, static_cast<double>(trackerAllocs) / (STEPS - 1),
+		pairs / STEPS, began + ended, mismatches);
+}
+
+int main()
+{
+	printf("Times and allocations are per step, pairs is the average number touching, events counts every BEGIN and END\n\n");
+	printf("%8s %9s %12s %12s %9s %14s %14s %8s %8s %10s\n", "bodies", "manifolds", "legacy ms", "tracker ms", "speedup",
+		"legacy allocs", "tracker allocs", "pairs", "events", "mismatches");
+
+	const int widths[] = { 16, 32, 48 };
+	for (int width : widths) {
+		Run(width, 2);
+	}
+	return 0;
+}
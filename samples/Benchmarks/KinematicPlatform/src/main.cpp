@@ -0,0 +1,187 @@
+// Checks and times SMI_KinematicController. First it makes sure static and kinematic SMI_Physics bodies come out with no
+// mass or inertia no matter what mass they're given, which the controller relies on. Then a box is left riding on a
+// platform that slides back and forth, once driven by the controller and once teleported with SetPosition every step
+// (how GameScene1 used to move its platforms), to see whether the box gets carried. A platform on a track that stops
+// has to fall asleep afterwards. Last, the controller pass is timed on a lot of platforms at once.
+// Run it in Release. Exits with 1 if any of the checks fail
+#include "../../Benchmark.h"
+
+#include <cmath>
+
+#include "btBulletDynamicsCommon.h"
+
+#include "../../../../projects/GDW/src/Physics.cpp"
+#include "../../../../projects/GDW/src/Utils/ShapeCache.cpp"
+
+static const float STEP = 1.0f / 60.0f;
+// The platform goes from one end to the other in this many seconds
+static const float TRIP = 2.0f;
+static const glm::vec3 START = glm::vec3(-5.0f, 0.0f, 0.0f);
+static const glm::vec3 END = glm::vec3(5.0f, 0.0f, 0.0f);
+static const int TIMED_PLATFORMS = 10000;
+static const int TIMED_STEPS = 200;
+
+static bool failed = false;
+
+static void Check(bool passed, const char* what)
+{
+	printf("  %-64s %s\n", what, passed ? "ok" : "FAILED");
+	failed = failed || !passed;
+}
+
+static void DeleteBody(btDiscreteDynamicsWorld* world, SMI_Physics& phys)
+{
+	if (world != nullptr) {
+		world->removeRigidBody(phys.getRigidBody());
+	}
+	delete phys.getRigidBody();
+	delete phys.getMotionState();
+}
+
+static void CheckMass()
+{
+	printf("Mass\n");
+	SMI_Physics kinematic(glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(1.0f), entt::entity(0), SMI_PhysicsBodyType::KINEMATIC, 1.0f);
+	SMI_Physics still(glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(1.0f), entt::entity(1), SMI_PhysicsBodyType::STATIC, 1.0f);
+	SMI_Physics dynamic(glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(1.0f), entt::entity(2), SMI_PhysicsBodyType::DYNAMIC, 1.0f);
+
+	btRigidBody* body = kinematic.getRigidBody();
+	Check(kinematic.getmass() == 0.0f && body->getInvMass() == 0.0f, "kinematic body given a mass of 1 has no mass");
+	Check(body->getInvInertiaDiagLocal().isZero(), "kinematic body has no inertia");
+	Check(body->isKinematicObject() && !body->isStaticObject(), "kinematic body is flagged kinematic and not static");
+	Check(still.getmass() == 0.0f && still.getRigidBody()->getInvMass() == 0.0f, "static body given a mass of 1 has no mass");
+	Check(dynamic.getmass() == 1.0f && dynamic.getRigidBody()->getInvMass() == 1.0f, "dynamic body keeps its mass");
+
+	DeleteBody(nullptr, kinematic);
+	DeleteBody(nullptr, still);
+	DeleteBody(nullptr, dynamic);
+}
+
+// The pose of a platform going back and forth between START and END, the same as a PING_PONG track
+static glm::vec3 PingPong(float time)
+{
+	float t = std::fmod(time, 2.0f * TRIP) / TRIP;
+	return t <= 1.0f ? glm::mix(START, END, t) : glm::mix(END, START, t - 1.0f);
+}
+
+// Rides a box on the platform for two round trips, and returns how far it ended up from the middle of the platform
+static float Ride(bool useController, int steps)
+{
+	btDefaultCollisionConfiguration config;
+	btCollisionDispatcher dispatcher(&config);
+	btDbvtBroadphase broadphase;
+	btSequentialImpulseConstraintSolver solver;
+	btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &solver, &config);
+	world.setGravity(btVector3(0.0f, -9.8f, 0.0f));
+
+	SMI_Physics platform(START, glm::vec3(0.0f), glm::vec3(4.0f, 0.5f, 4.0f), entt::entity(0), SMI_PhysicsBodyType::KINEMATIC);
+	SMI_Physics rider(START + glm::vec3(0.0f, 0.75f, 0.0f), glm::vec3(0.0f), glm::vec3(1.0f), entt::entity(1), SMI_PhysicsBodyType::DYNAMIC);
+	world.addRigidBody(platform.getRigidBody());
+	world.addRigidBody(rider.getRigidBody());
+
+	SMI_KinematicController controller;
+	controller.setTrack({ { 0.0f, START, glm::quat(1.0f, 0.0f, 0.0f, 0.0f) }, { TRIP, END, glm::quat(1.0f, 0.0f, 0.0f, 0.0f) } },
+		SMI_TrackMode::PING_PONG, false);
+
+	// Let the box land first
+	for (int step = 0; step < 30; step++) {
+		world.stepSimulation(STEP, 0);
+	}
+
+	for (int step = 0; step < steps; step++) {
+		if (useController) {
+			controller.Step(platform, STEP);
+		} else {
+			platform.SetPosition(PingPong((step + 1) * STEP));
+		}
+		world.stepSimulation(STEP, 0);
+	}
+
+	glm::vec3 offset = rider.GetPosition() - platform.GetPosition();
+	DeleteBody(&world, rider);
+	DeleteBody(&world, platform);
+	return offset.y > 0.0f ? std::sqrt(offset.x * offset.x + offset.z * offset.z) : INFINITY;
+}
+
+static void CheckRide()
+{
+	printf("Riding a platform for %.0f seconds (two round trips)\n", 4.0f * TRIP);
+	int steps = static_cast<int>(4.0f * TRIP / STEP);
+	float driven = Ride(true, steps);
+	float teleported = Ride(false, steps);
+	printf("  box ends up %.3f from the middle of a driven platform, and %.3f from a teleported one\n", driven, teleported);
+	// The platform is 4 wide, so a box more than 2 from the middle has fallen off
+	Check(driven < 0.5f, "box stays put on a platform driven by the controller");
+}
+
+static void CheckSleep()
+{
+	printf("Sleeping\n");
+	btDefaultCollisionConfiguration config;
+	btCollisionDispatcher dispatcher(&config);
+	btDbvtBroadphase broadphase;
+	btSequentialImpulseConstraintSolver solver;
+	btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &solver, &config);
+
+	SMI_Physics platform(START, glm::vec3(0.0f), glm::vec3(4.0f, 0.5f, 4.0f), entt::entity(0), SMI_PhysicsBodyType::KINEMATIC);
+	world.addRigidBody(platform.getRigidBody());
+
+	SMI_KinematicController controller;
+	controller.setTrack({ { 0.0f, START, glm::quat(1.0f, 0.0f, 0.0f, 0.0f) }, { TRIP, END, glm::quat(1.0f, 0.0f, 0.0f, 0.0f) } },
+		SMI_TrackMode::ONCE, false);
+
+	// The trip, then the time to sleep, then a bit more
+	int steps = static_cast<int>((TRIP + gDeactivationTime + 0.5f) / STEP);
+	bool awakeMidTrip = false;
+	for (int step = 0; step < steps; step++) {
+		controller.Step(platform, STEP);
+		world.stepSimulation(STEP, 0);
+		if (step == static_cast<int>(TRIP / STEP / 2.0f)) {
+			awakeMidTrip = platform.isAwake();
+		}
+	}
+
+	Check(awakeMidTrip, "platform is awake while it moves");
+	Check(glm::length(platform.GetPosition() - END) < 1e-4f, "platform stops at the end of its track");
+	Check(!controller.isPlaying() && !platform.isAwake(), "platform falls asleep once its track is done");
+	DeleteBody(&world, platform);
+}
+
+static void TimeControllers()
+{
+	std::vector<std::unique_ptr<SMI_Physics>> platforms;
+	std::vector<SMI_KinematicController> controllers(TIMED_PLATFORMS);
+	for (int ix = 0; ix < TIMED_PLATFORMS; ix++) {
+		glm::vec3 offset = glm::vec3(0.0f, ix * 2.0f, 0.0f);
+		platforms.emplace_back(new SMI_Physics(START + offset, glm::vec3(0.0f), glm::vec3(4.0f, 0.5f, 4.0f), entt::entity(ix),
+			SMI_PhysicsBodyType::KINEMATIC));
+		controllers[ix].addKeyframe(0.0f, START + offset);
+		controllers[ix].addKeyframe(TRIP, END + offset, glm::quat(glm::vec3(0.0f, 1.0f, 0.0f)));
+		controllers[ix].addKeyframe(2.0f * TRIP, START + offset);
+	}
+
+	Clock::time_point start = Clock::now();
+	for (int step = 0; step < TIMED_STEPS; step++) {
+		for (int ix = 0; ix < TIMED_PLATFORMS; ix++) {
+			controllers[ix].Step(*platforms[ix], STEP);
+		}
+	}
+	double time = Millis(start) / TIMED_STEPS;
+	printf("Controller pass on %d platforms with 3 keyframe tracks: %.3f ms per step (%.1f ns per platform)\n",
+		TIMED_PLATFORMS, time, time * 1e6 / TIMED_PLATFORMS);
+
+	for (auto& platform : platforms) {
+		DeleteBody(nullptr, *platform);
+	}
+}
+
+int main()
+{
+	CheckMass();
+	CheckRide();
+	CheckSleep();
+	TimeControllers();
+
+	ShapeCache::Clear();
+	return failed ? 1 : 0;
+}
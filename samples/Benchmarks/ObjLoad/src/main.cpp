@@ -0,0 +1,286 @@
+// Times parsing every OBJ in a folder (the game's res/Models by default) with the loader the game started with (an
+// ifstream read with operator>> and a stringstream per face) and with ObjLoader::ParseFile, and checks that both give
+// the same triangles. The new loader shares vertices through an index buffer, so its output is expanded back out to
+// one vertex per face corner before comparing. Files the old loader can't read (quads, n-gons, missing uvs) are checked
+// against a slow but simple reference parser instead. Only the OBJ text is parsed, nothing is baked or uploaded to OpenGL.
+// Run it in Release, from the repository root or with the folder to load as the first argument. Exits with 1 if any
+// model came out different
+#include "../../Benchmark.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+// Nothing here touches OpenGL, the buffers are only built for CreateVao
+#include "../../../../projects/GDW/src/Utils/ObjLoader.cpp"
+#include "../../../../projects/GDW/src/Utils/BakedMesh.cpp"
+#include "../../../../projects/GDW/src/Utils/MappedFile.cpp"
+#include "../../../../projects/GDW/src/Utils/FileUtils.cpp"
+#include "../../../../projects/GDW/src/VertexArrayObject.cpp"
+#include "../../../../projects/GDW/src/IBuffer.cpp"
+#include "../../../../projects/GDW/src/VertexTypes.cpp"
+#include "../../../../projects/GDW/src/Bounds.cpp"
+
+// The number of times each file is loaded, we keep the fastest to cut down on noise from the disk cache
+static const int RUNS = 5;
+
+// The original ObjLoader::LoadFromFile, minus the upload to OpenGL. It only reads the first three corners of a face and
+// needs them in v/vt/vn form, so files it would get wrong (quads, n-gons, missing uvs) are reported instead of compared
+static bool OldLoad(const std::string& filename, std::vector<VertexPosNormTexCol>& vertexData)
+{
+	std::ifstream file;
+	file.open(filename, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+
+	std::string line;
+	std::vector<glm::vec3> positions;
+	std::vector<glm::vec2> uvs;
+	std::vector<glm::vec3> nrml;
+	std::vector<glm::ivec3> vertecies;
+
+	glm::vec3 vecData;
+	glm::ivec3 vertexIndicies;
+
+	while (file.peek() != EOF)
+	{
+		std::string command;
+		file >> command;
+
+		if (command == "#")
+		{
+			std::getline(file, line);
+		}
+		else if (command == "vt")
+		{
+			glm::vec2 temp;
+			file >> temp.x >> temp.y;
+			uvs.push_back(temp);
+		}
+		else if (command == "vn")
+		{
+			file >> vecData.x >> vecData.y >> vecData.z;
+			nrml.push_back(vecData);
+		}
+		else if (command == "v")
+		{
+			file >> vecData.x >> vecData.y >> vecData.z;
+			positions.push_back(vecData);
+		}
+		else if (command == "f")
+		{
+			std::getline(file, line);
+			// trim
+			line.erase(line.begin(), std::find_if(line.begin(), line.end(), [](int ch) { return !std::isspace(ch); }));
+			line.erase(std::find_if(line.rbegin(), line.rend(), [](int ch) { return !std::isspace(ch); }).base(), line.end());
+			std::stringstream stream = std::stringstream(line);
+
+			for (int i = 0; i < 3; i++)
+			{
+				char separator;
+				stream >> vertexIndicies.x >> separator >> vertexIndicies.y >> separator >> vertexIndicies.z;
+				vertexIndicies -= glm::ivec3(1);
+				vertecies.push_back(vertexIndicies);
+			}
+
+			// Anything left on the line is a fourth corner that the old loader would have dropped
+			std::string rest;
+			if (stream >> rest) {
+				return false;
+			}
+		}
+	}
+
+	vertexData.clear();
+	vertexData.reserve(vertecies.size());
+	for (size_t i = 0; i < vertecies.size(); i++)
+	{
+		glm::ivec3 attribs = vertecies[i];
+		if (attribs.x < 0 || attribs.x >= static_cast<int>(positions.size()) ||
+			attribs.y < 0 || attribs.y >= static_cast<int>(uvs.size()) ||
+			attribs.z < 0 || attribs.z >= static_cast<int>(nrml.size())) {
+			return false;
+		}
+		vertexData.push_back(VertexPosNormTexCol(positions[attribs.x], nrml[attribs.z], uvs[attribs.y], glm::vec4(1.0f)));
+	}
+	return true;
+}
+
+// Turns an OBJ index (1 based, or negative to count back from the end) into a list index, or -1 if it's missing or
+// out of range. Mirrors what ParseFile does with bad indices
+static int ReferenceIndex(const char*& cursor, size_t count)
+{
+	char* after = nullptr;
+	long index = strtol(cursor, &after, 10);
+	if (after == cursor) {
+		return -1;
+	}
+	cursor = after;
+	long result = index > 0 ? index - 1 : static_cast<long>(count) + index;
+	return (index != 0 && result >= 0 && result < static_cast<long>(count)) ? static_cast<int>(result) : -1;
+}
+
+// Reads any OBJ the way the format describes it, one line and one stringstream at a time. Faces can have any number of
+// v, v/vt, v//vn or v/vt/vn corners and are split into a fan around their first corner, with missing attributes zeroed.
+// Fills in one vertex per triangle corner, so it can be compared with ParseFile's output once that's been expanded
+static bool ReferenceLoad(const std::string& filename, std::vector<VertexPosNormTexCol>& vertexData)
+{
+	std::ifstream file(filename, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+
+	std::vector<glm::vec3> positions;
+	std::vector<glm::vec2> uvs;
+	std::vector<glm::vec3> nrml;
+	vertexData.clear();
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		std::istringstream stream(line);
+		std::string command;
+		stream >> command;
+
+		if (command == "v")
+		{
+			glm::vec3 position;
+			stream >> position.x >> position.y >> position.z;
+			positions.push_back(position);
+		}
+		else if (command == "vt")
+		{
+			glm::vec2 uv;
+			stream >> uv.x >> uv.y;
+			uvs.push_back(uv);
+		}
+		else if (command == "vn")
+		{
+			glm::vec3 normal;
+			stream >> normal.x >> normal.y >> normal.z;
+			nrml.push_back(normal);
+		}
+		else if (command == "f")
+		{
+			std::vector<VertexPosNormTexCol> corners;
+			std::string token;
+			while (stream >> token)
+			{
+				const char* cursor = token.c_str();
+				int position = ReferenceIndex(cursor, positions.size());
+				int uv = -1;
+				int normal = -1;
+				if (*cursor == '/') {
+					cursor++;
+					uv = ReferenceIndex(cursor, uvs.size());
+					if (*cursor == '/') {
+						cursor++;
+						normal = ReferenceIndex(cursor, nrml.size());
+					}
+				}
+				corners.push_back(VertexPosNormTexCol(
+					position >= 0 ? positions[position] : glm::vec3(0.0f),
+					normal >= 0 ? nrml[normal] : glm::vec3(0.0f),
+					uv >= 0 ? uvs[uv] : glm::vec2(0.0f),
+					glm::vec4(1.0f)));
+			}
+
+			for (size_t i = 2; i < corners.size(); i++)
+			{
+				vertexData.push_back(corners[0]);
+				vertexData.push_back(corners[i - 1]);
+				vertexData.push_back(corners[i]);
+			}
+		}
+	}
+	return true;
+}
+
+static bool SameVertices(const std::vector<VertexPosNormTexCol>& a, const std::vector<VertexPosNormTexCol>& b)
+{
+	return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(VertexPosNormTexCol)) == 0);
+}
+
+int main(int argc, char** argv)
+{
+	Logger::Init();
+	// ParseFile logs every model it loads, which would swamp the results
+	Logger::GetLogger()->set_level(spdlog::level::warn);
+
+	std::string folder = argc > 1 ? argv[1] : "projects/GDW/res/Models";
+	std::vector<std::string> files;
+	std::error_code error;
+	for (const auto& entry : std::filesystem::directory_iterator(folder, error)) {
+		if (entry.is_regular_file() && entry.path().extension() == ".obj") {
+			files.push_back(entry.path().string());
+		}
+	}
+	std::sort(files.begin(), files.end());
+	if (files.empty()) {
+		printf("No OBJ files found in \"%s\", pass the folder to load as the first argument\n", folder.c_str());
+		return 1;
+	}
+
+	printf("Fastest of %d loads per file. Vertices is one per face corner for the old loader, and unique vertices for\n", RUNS);
+	printf("the new one. Same means both loaders gave exactly the same triangles (or, for files the old loader can't read,\n");
+	printf("that the new one matches the reference parser)\n\n");
+	printf("%-28s %10s %10s %10s %10s %8s %6s\n", "file", "corners", "unique", "old ms", "new ms", "speedup", "same");
+
+	double oldTotal = 0.0;
+	double newTotal = 0.0;
+	int different = 0;
+	int skipped = 0;
+	for (const std::string& filename : files) {
+		std::vector<VertexPosNormTexCol> oldVertices;
+		double oldTime = 1e30;
+		bool oldLoaded = true;
+		for (int run = 0; run < RUNS && oldLoaded; run++) {
+			Clock::time_point start = Clock::now();
+			oldLoaded = OldLoad(filename, oldVertices);
+			oldTime = std::min(oldTime, Millis(start));
+		}
+
+		ObjLoader::MeshData data;
+		double newTime = 1e30;
+		for (int run = 0; run < RUNS; run++) {
+			data = ObjLoader::MeshData();
+			Clock::time_point start = Clock::now();
+			ObjLoader::ParseFile(filename, data);
+			newTime = std::min(newTime, Millis(start));
+		}
+
+		std::vector<VertexPosNormTexCol> newVertices;
+		newVertices.reserve(data.Indices.size());
+		for (uint32_t index : data.Indices) {
+			newVertices.push_back(data.Vertices[index]);
+		}
+
+		std::string name = std::filesystem::path(filename).filename().string();
+		if (!oldLoaded) {
+			// Files with quads, n-gons, missing uvs and so on, that only the new loader reads correctly
+			std::vector<VertexPosNormTexCol> referenceVertices;
+			bool same = ReferenceLoad(filename, referenceVertices) && SameVertices(referenceVertices, newVertices);
+			different += same ? 0 : 1;
+			printf("%-28s %10zu %10zu %10s %10.3f %8s %6s\n", name.c_str(), referenceVertices.size(), data.Vertices.size(), "-",
+				newTime, "-", same ? "yes" : "NO");
+			skipped++;
+			continue;
+		}
+
+		bool same = SameVertices(oldVertices, newVertices);
+		different += same ? 0 : 1;
+
+		oldTotal += oldTime;
+		newTotal += newTime;
+		printf("%-28s %10zu %10zu %10.3f %10.3f %7.2fx %6s\n", name.c_str(), oldVertices.size(), data.Vertices.size(),
+			oldTime, newTime, oldTime / newTime, same ? "yes" : "NO");
+	}
+
+	printf("\n%zu files, %d only read correctly by the new loader. Total for the rest: old %.1f ms, new %.1f ms (%.2fx)\n",
+		files.size(), skipped, oldTotal, newTotal, newTotal > 0.0 ? oldTotal / newTotal : 0.0);
+	if (different > 0) {
+		printf("%d files came out different\n", different);
+	}
+	return different > 0 ? 1 : 0;
+}
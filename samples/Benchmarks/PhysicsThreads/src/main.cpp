@@ -0,0 +1,155 @@
+// Steps the same physics scene on the single threaded world and on the multithreaded world with 1 to N threads, each
+// made by SMI_PhysicsWorld from the same settings a scene would be given, and checks that each setup gives exactly the
+// same results every time it is run. The scene has a lot of small islands (columns of boxes falling onto a floor) and
+// one big one (a pyramid), so both the solver pool and the solver for big islands get work.
+// Run it in Release. Exits with 1 if any setup wasn't deterministic, or if Bullet wasn't built with BT_THREADSAFE (in
+// which case the Mt world never calls the scheduler and there is nothing to measure)
+#include "../../Benchmark.h"
+
+#include <thread>
+
+#include "btBulletDynamicsCommon.h"
+
+// SMI_Scene gets its world from SMI_PhysicsWorld, so building that steps exactly the world a scene would. The scene
+// itself needs a window and OpenGL, which we'd only be timing alongside
+#include "../../../../projects/GDW/src/PhysicsWorld.cpp"
+#include "../../../../projects/GDW/src/PhysicsTaskScheduler.cpp"
+#include "../../../../projects/GDW/src/Utils/ThreadPool.cpp"
+
+static const float STEP = 1.0f / 60.0f;
+static const int STEPS = 300;
+static const int COLUMNS = 40;
+static const int COLUMN_HEIGHT = 4;
+static const int PYRAMID_SIZE = 24;
+
+struct Result
+{
+	double StepTime;
+	// The final pose of every body
+	std::vector<btTransform> Poses;
+};
+
+// Runs the scene, threads is 0 for the single threaded world
+static Result Run(int threads, bool parallelCollision)
+{
+	SMI_PhysicsSettings settings;
+	settings.Multithreaded = threads > 0;
+	settings.NumThreads = static_cast<uint32_t>(threads);
+	settings.ParallelCollision = parallelCollision;
+	SMI_PhysicsWorld physics(settings);
+	btDiscreteDynamicsWorld* world = physics.getWorld();
+	world->setGravity(btVector3(0.0f, -9.8f, 0.0f));
+
+	btBoxShape floorShape(btVector3(100.0f, 1.0f, 100.0f));
+	btBoxShape box(btVector3(0.5f, 0.5f, 0.5f));
+	std::vector<std::unique_ptr<btDefaultMotionState>> motionStates;
+	std::vector<std::unique_ptr<btRigidBody>> bodies;
+	auto addBody = [&](btCollisionShape* shape, const btVector3& position, float mass) {
+		btVector3 inertia(0.0f, 0.0f, 0.0f);
+		if (mass > 0.0f) {
+			shape->calculateLocalInertia(mass, inertia);
+		}
+		btTransform transform;
+		transform.setIdentity();
+		transform.setOrigin(position);
+		motionStates.emplace_back(new btDefaultMotionState(transform));
+		bodies.emplace_back(new btRigidBody(btRigidBody::btRigidBodyConstructionInfo(mass, motionStates.back().get(), shape, inertia)));
+		world->addRigidBody(bodies.back().get());
+	};
+
+	addBody(&floorShape, btVector3(0.0f, -1.0f, 0.0f), 0.0f);
+
+	// Columns dropped from a little way up, slightly offset so they topple into each other
+	for (int x = 0; x < COLUMNS; x++) {
+		for (int z = 0; z < COLUMNS; z++) {
+			for (int y = 0; y < COLUMN_HEIGHT; y++) {
+				addBody(&box, btVector3(x * 2.0f - COLUMNS + 0.1f * y, 2.0f + y * 1.2f, z * 2.0f - COLUMNS), 1.0f);
+			}
+		}
+	}
+	// One pyramid off to the side, every box in it ends up in one island
+	for (int y = 0; y < PYRAMID_SIZE; y++) {
+		for (int x = 0; x < PYRAMID_SIZE - y; x++) {
+			addBody(&box, btVector3(60.0f + x * 1.0f + y * 0.5f, 0.5f + y * 1.0f, 60.0f), 1.0f);
+		}
+	}
+
+	Clock::time_point start = Clock::now();
+	for (int step = 0; step < STEPS; step++) {
+		world->stepSimulation(STEP, 0);
+	}
+
+	Result result;
+	result.StepTime = Millis(start) / STEPS;
+	for (auto& body : bodies) {
+		result.Poses.push_back(body->getWorldTransform());
+		world->removeRigidBody(body.get());
+	}
+	return result;
+}
+
+// Checks that every body ended up in exactly the same place, the unused fourth component of each vector is skipped
+static bool Same(const Result& a, const Result& b)
+{
+	if (a.Poses.size() != b.Poses.size()) {
+		return false;
+	}
+	for (size_t ix = 0; ix < a.Poses.size(); ix++) {
+		for (int axis = 0; axis < 3; axis++) {
+			if (memcmp(&a.Poses[ix].getBasis()[axis], &b.Poses[ix].getBasis()[axis], 3 * sizeof(btScalar)) != 0) {
+				return false;
+			}
+		}
+		if (memcmp(&a.Poses[ix].getOrigin(), &b.Poses[ix].getOrigin(), 3 * sizeof(btScalar)) != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int main()
+{
+#if !BT_THREADSAFE
+	printf("Bullet was built without BT_THREADSAFE, so btParallelFor runs everything on one thread and the Mt world\n");
+	printf("isn't safe to use. Rebuild Bullet with BT_THREADSAFE=1 and define BT_THREADSAFE for this project\n");
+	return 1;
+#endif
+	Logger::Init();
+	// Each multithreaded world logs the threads it was made with, which would swamp the results
+	Logger::GetLogger()->set_level(spdlog::level::warn);
+
+	int maxThreads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+	bool deterministic = true;
+
+	printf("%d boxes, %d steps. Step times are averaged, repeatable means a second run gave exactly the same poses,\n",
+		COLUMNS * COLUMNS * COLUMN_HEIGHT + PYRAMID_SIZE * (PYRAMID_SIZE + 1) / 2, STEPS);
+	printf("and matches single is whether it gave the same poses as the single threaded world\n\n");
+	printf("%-24s %8s %10s %9s %10s %14s\n", "world", "threads", "step ms", "speedup", "repeatable", "matches single");
+
+	Result single = Run(0, false);
+	bool repeatable = Same(single, Run(0, false));
+	deterministic = deterministic && repeatable;
+	printf("%-24s %8d %10.3f %8.2fx %10s %14s\n", "btDiscreteDynamicsWorld", 1, single.StepTime, 1.0, repeatable ? "yes" : "NO", "-");
+
+	// Powers of two, then however many cores there are
+	std::vector<int> threadCounts;
+	for (int threads = 1; threads < maxThreads; threads *= 2) {
+		threadCounts.push_back(threads);
+	}
+	threadCounts.push_back(maxThreads);
+
+	for (int threads : threadCounts) {
+		Result first = Run(threads, false);
+		repeatable = Same(first, Run(threads, false));
+		deterministic = deterministic && repeatable;
+		printf("%-24s %8d %10.3f %8.2fx %10s %14s\n", "Mt", threads, first.StepTime, single.StepTime / first.StepTime,
+			repeatable ? "yes" : "NO", Same(first, single) ? "yes" : "no");
+	}
+
+	// Finding contacts on the workers is faster, but isn't expected to be repeatable
+	Result parallel = Run(maxThreads, true);
+	printf("%-24s %8d %10.3f %8.2fx %10s %14s\n", "Mt + ParallelCollision", maxThreads, parallel.StepTime, single.StepTime / parallel.StepTime,
+		Same(parallel, Run(maxThreads, true)) ? "yes" : "no", Same(parallel, single) ? "yes" : "no");
+
+	return deterministic ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+// Measures how long a physics step takes on a pile of boxes that has come to rest, with every body kept awake (how
+// SMI_Physics used to set up its bodies) and with the default sleep settings. Once everything is asleep Bullet skips
+// integrating, solving and narrowphase for the pile, so a level at rest should cost next to nothing.
+// Run it in Release
+#include "../../Benchmark.h"
+
+#include "btBulletDynamicsCommon.h"
+
+#include "../../../../projects/GDW/src/Physics.cpp"
+#include "../../../../projects/GDW/src/Utils/ShapeCache.cpp"
+
+static const float STEP = 1.0f / 60.0f;
+// Long enough for the pile to settle and for the bodies to stay still for the time to sleep (2 seconds by default)
+static const int SETTLE_STEPS = 360;
+static const int STEPS = 200;
+
+static void Run(int width, int height, bool canSleep)
+{
+	btDefaultCollisionConfiguration config;
+	btCollisionDispatcher dispatcher(&config);
+	btDbvtBroadphase broadphase;
+	btSequentialImpulseConstraintSolver solver;
+	btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &solver, &config);
+	world.setGravity(btVector3(0.0f, -9.8f, 0.0f));
+
+	SMI_SleepSettings sleep = SMI_Physics::getDefaultSleepSettings(SMI_PhysicsBodyType::DYNAMIC);
+	sleep.CanSleep = canSleep;
+
+	std::vector<std::unique_ptr<SMI_Physics>> bodies;
+	auto addBody = [&](const glm::vec3& position, SMI_PhysicsBodyType type) {
+		bodies.emplace_back(new SMI_Physics(position, glm::vec3(0.0f), glm::vec3(1.0f), static_cast<entt::entity>(bodies.size()), type,
+			type == SMI_PhysicsBodyType::DYNAMIC ? 1.0f : 0.0f));
+		if (type == SMI_PhysicsBodyType::DYNAMIC) {
+			bodies.back()->setSleepSettings(sleep);
+		}
+		world.addRigidBody(bodies.back()->getRigidBody());
+	};
+
+	// A floor of static boxes under the pile, the same as the levels are built
+	for (int x = -1; x <= width; x++) {
+		for (int z = -1; z <= width; z++) {
+			addBody(glm::vec3(x * 1.1f, -0.5f, z * 1.1f), SMI_PhysicsBodyType::STATIC);
+		}
+	}
+	size_t floor = bodies.size();
+
+	// Columns of boxes, with a small gap so neighbouring columns don't lean on each other
+	for (int x = 0; x < width; x++) {
+		for (int z = 0; z < width; z++) {
+			for (int y = 0; y < height; y++) {
+				addBody(glm::vec3(x * 1.1f, 0.5f + y * 1.0f, z * 1.1f), SMI_PhysicsBodyType::DYNAMIC);
+			}
+		}
+	}
+
+	for (int step = 0; step < SETTLE_STEPS; step++) {
+		world.stepSimulation(STEP, 0);
+	}
+
+	Clock::time_point start = Clock::now();
+	for (int step = 0; step < STEPS; step++) {
+		world.stepSimulation(STEP, 0);
+	}
+	double time = Millis(start) / STEPS;
+
+	size_t awake = 0;
+	for (size_t ix = floor; ix < bodies.size(); ix++) {
+		awake += bodies[ix]->isAwake() ? 1 : 0;
+	}
+
+	// Dropping a box on the pile should wake the boxes it lands on, and only those
+	addBody(glm::vec3(width * 0.55f, height + 2.0f, width * 0.55f), SMI_PhysicsBodyType::DYNAMIC);
+	for (int step = 0; step < 60; step++) {
+		world.stepSimulation(STEP, 0);
+	}
+	size_t woken = 0;
+	for (size_t ix = floor; ix < bodies.size(); ix++) {
+		woken += bodies[ix]->isAwake() ? 1 : 0;
+	}
+
+	for (auto& body : bodies) {
+		world.removeRigidBody(body->getRigidBody());
+		delete body->getRigidBody();
+		delete body->getMotionState();
+	}
+
+	printf("%8zu %10s %12.3f %8zu %8zu %8zu\n", bodies.size() - floor - 1, canSleep ? "sleep" : "always", time, awake, woken,
+		ShapeCache::GetSize());
+}
+
+int main()
+{
+	printf("Step time is averaged over %d steps once the pile has settled, awake is the number of boxes Bullet is still\n", STEPS);
+	printf("simulating, and woken is how many are awake a second after another box is dropped on top. Every body is the same\n");
+	printf("size, so they should all share one shape from the ShapeCache\n\n");
+	printf("%8s %10s %12s %8s %8s %8s\n", "boxes", "mode", "step ms", "awake", "woken", "shapes");
+
+	// 25 * 25 columns of 8 boxes is 5000 boxes
+	Run(25, 8, false);
+	Run(25, 8, true);
+
+	ShapeCache::Clear();
+	return 0;
+}
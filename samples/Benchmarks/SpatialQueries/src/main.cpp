@@ -0,0 +1,157 @@
+// Compares the queries on DynamicBVH (what SMI_Scene uses for culling and proximity checks) against checking every
+// object, for 1k to 100k objects spread along a level shaped like ours (long in x, short in y and z). Each frame a
+// tenth of the objects move, then the tree is optimized and every kind of query is run. Run it in Release
+#include "../../Benchmark.h"
+
+#include <random>
+
+#include <GLM/glm.hpp>
+#include <GLM/gtc/matrix_transform.hpp>
+
+#include "../../../../projects/GDW/src/DynamicBVH.h"
+#include "../../../../projects/GDW/src/DynamicBVH.cpp"
+#include "../../../../projects/GDW/src/Frustum.cpp"
+#include "../../../../projects/GDW/src/Bounds.cpp"
+
+static const int FRAMES = 20;
+static const int QUERIES_PER_FRAME = 100;
+
+struct Object
+{
+	glm::vec3 Min;
+	glm::vec3 Max;
+	int32_t   Proxy;
+};
+
+struct Timings
+{
+	double Build = 0.0;
+	double Update = 0.0;
+	double BvhQueries = 0.0;
+	double LinearQueries = 0.0;
+	size_t Found = 0;
+	size_t Mismatches = 0;
+};
+
+static bool Overlaps(const Object& obj, const glm::vec3& min, const glm::vec3& max)
+{
+	return glm::all(glm::lessThanEqual(obj.Min, max)) && glm::all(glm::lessThanEqual(min, obj.Max));
+}
+
+static bool Touches(const Object& obj, const glm::vec3& center, float radius)
+{
+	glm::vec3 offset = glm::clamp(center, obj.Min, obj.Max) - center;
+	return glm::dot(offset, offset) <= radius * radius;
+}
+
+static Timings Run(size_t count)
+{
+	std::mt19937 rng(42);
+	float length = static_cast<float>(count) * 0.5f;
+	std::uniform_real_distribution<float> xDist(0.0f, length);
+	std::uniform_real_distribution<float> yzDist(-10.0f, 10.0f);
+	std::uniform_real_distribution<float> sizeDist(0.25f, 2.0f);
+	std::uniform_real_distribution<float> moveDist(-1.0f, 1.0f);
+
+	Timings result;
+	DynamicBVH tree;
+	std::vector<Object> objects(count);
+
+	Clock::time_point start = Clock::now();
+	for (size_t ix = 0; ix < count; ix++) {
+		glm::vec3 center = glm::vec3(xDist(rng), yzDist(rng), yzDist(rng));
+		glm::vec3 half = glm::vec3(sizeDist(rng));
+		objects[ix].Min = center - half;
+		objects[ix].Max = center + half;
+		objects[ix].Proxy = tree.Insert(objects[ix].Min, objects[ix].Max, static_cast<uint32_t>(ix));
+	}
+	tree.Optimize();
+	result.Build = Millis(start);
+
+	std::vector<uint32_t> bvhHits;
+	std::vector<uint32_t> linearHits;
+	for (int frame = 0; frame < FRAMES; frame++) {
+		// Move a tenth of the objects
+		start = Clock::now();
+		for (size_t ix = frame % 10; ix < count; ix += 10) {
+			glm::vec3 offset = glm::vec3(moveDist(rng), moveDist(rng), moveDist(rng));
+			objects[ix].Min += offset;
+			objects[ix].Max += offset;
+			tree.Move(objects[ix].Proxy, objects[ix].Min, objects[ix].Max);
+		}
+		tree.Optimize();
+		result.Update += Millis(start);
+
+		for (int query = 0; query < QUERIES_PER_FRAME; query++) {
+			glm::vec3 point = glm::vec3(xDist(rng), yzDist(rng), yzDist(rng));
+			glm::vec3 boxMin = point - glm::vec3(5.0f);
+			glm::vec3 boxMax = point + glm::vec3(5.0f);
+			float radius = 5.0f;
+			// A camera looking down the z axis at the point, like the game's side on view
+			Frustum frustum = Frustum(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 50.0f) *
+				glm::lookAt(point + glm::vec3(0.0f, 0.0f, 20.0f), point, glm::vec3(0.0f, 1.0f, 0.0f)));
+			glm::vec3 rayDir = glm::normalize(glm::vec3(1.0f, moveDist(rng) * 0.1f, moveDist(rng) * 0.1f));
+
+			// The tree reports objects by their fat boxes, so both sides check the real box before counting a hit
+			bvhHits.clear();
+			start = Clock::now();
+			tree.QueryAABB(boxMin, boxMax, [&](uint32_t id) { if (Overlaps(objects[id], boxMin, boxMax)) bvhHits.push_back(id); });
+			tree.QuerySphere(point, radius, [&](uint32_t id) { if (Touches(objects[id], point, radius)) bvhHits.push_back(id); });
+			tree.QueryFrustum(frustum, [&](uint32_t id) {
+				if (frustum.TestAABB((objects[id].Min + objects[id].Max) * 0.5f, (objects[id].Max - objects[id].Min) * 0.5f)) bvhHits.push_back(id);
+			});
+			float bvhClosest = 100.0f;
+			tree.Raycast(point, rayDir, 100.0f, [&](uint32_t id, float maxDistance) {
+				float distance;
+				if (DynamicBVH::RayAABB(point, 1.0f / rayDir, objects[id].Min, objects[id].Max, maxDistance, distance)) {
+					bvhClosest = glm::min(bvhClosest, distance);
+					return distance;
+				}
+				return maxDistance;
+			});
+			result.BvhQueries += Millis(start);
+
+			linearHits.clear();
+			start = Clock::now();
+			for (size_t ix = 0; ix < count; ix++) {
+				if (Overlaps(objects[ix], boxMin, boxMax)) linearHits.push_back(static_cast<uint32_t>(ix));
+			}
+			for (size_t ix = 0; ix < count; ix++) {
+				if (Touches(objects[ix], point, radius)) linearHits.push_back(static_cast<uint32_t>(ix));
+			}
+			for (size_t ix = 0; ix < count; ix++) {
+				if (frustum.TestAABB((objects[ix].Min + objects[ix].Max) * 0.5f, (objects[ix].Max - objects[ix].Min) * 0.5f)) linearHits.push_back(static_cast<uint32_t>(ix));
+			}
+			float linearClosest = 100.0f;
+			for (size_t ix = 0; ix < count; ix++) {
+				float distance;
+				if (DynamicBVH::RayAABB(point, 1.0f / rayDir, objects[ix].Min, objects[ix].Max, linearClosest, distance)) {
+					linearClosest = distance;
+				}
+			}
+			result.LinearQueries += Millis(start);
+
+			result.Found += linearHits.size();
+			if (bvhHits.size() != linearHits.size() || glm::abs(bvhClosest - linearClosest) > 1e-4f) {
+				result.Mismatches++;
+			}
+		}
+	}
+
+	printf("%8zu %10.2f %10.3f %10.3f %12.3f %8.1fx %8d %8u %10zu\n", count, result.Build, result.Update / FRAMES,
+		result.BvhQueries / (FRAMES * QUERIES_PER_FRAME), result.LinearQueries / (FRAMES * QUERIES_PER_FRAME),
+		result.LinearQueries / result.BvhQueries, tree.GetHeight(), tree.GetRebuildCount(), result.Mismatches);
+	return result;
+}
+
+int main()
+{
+	printf("Build is inserting every object, update is per frame, and queries are per set of box, sphere, frustum and raycast\n\n");
+	printf("%8s %10s %10s %10s %12s %9s %8s %8s %10s\n", "objects", "build ms", "update ms", "bvh ms", "linear ms", "speedup", "height", "rebuilds", "mismatches");
+
+	const size_t counts[] = { 1000, 10000, 100000 };
+	for (size_t count : counts) {
+		Run(count);
+	}
+	return 0;
+}
@@ -0,0 +1,117 @@
+// Compares TransformKernel::Compose against building the same matrices with glm, the way SMI_Transform used to
+// (glm::translate * glm::toMat4 * glm::scale, then multiplied by the parent). Run it in Release, and build with
+// /arch:AVX2 to time the AVX path instead of the SSE one
+#include "../../Benchmark.h"
+
+#include <random>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <GLM/glm.hpp>
+#include <GLM/gtx/quaternion.hpp>
+#include <GLM/gtx/transform.hpp>
+
+#include "../../../../projects/GDW/src/TransformKernel.h"
+#include "../../../../projects/GDW/src/TransformKernel.cpp"
+
+// The number of times each test is run, we keep the fastest to cut down on noise
+static const int RUNS = 10;
+
+struct TestData
+{
+	std::vector<glm::vec3> Positions;
+	std::vector<glm::quat> Rotations;
+	std::vector<glm::vec3> Scales;
+	std::vector<glm::mat4> Parents;
+	std::vector<const glm::mat4*> ParentPtrs;
+	std::vector<glm::mat4> Outputs;
+	std::vector<glm::mat4*> OutputPtrs;
+};
+
+static TestData MakeData(size_t count, bool withParents)
+{
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+	TestData data;
+	data.Positions.resize(count);
+	data.Rotations.resize(count);
+	data.Scales.resize(count);
+	data.Parents.resize(count);
+	data.ParentPtrs.resize(count);
+	data.Outputs.resize(count);
+	data.OutputPtrs.resize(count);
+	for (size_t ix = 0; ix < count; ix++) {
+		data.Positions[ix] = glm::vec3(dist(rng), dist(rng), dist(rng)) * 100.0f;
+		data.Rotations[ix] = glm::normalize(glm::quat(dist(rng), dist(rng), dist(rng), dist(rng)));
+		data.Scales[ix] = glm::vec3(dist(rng), dist(rng), dist(rng)) + 1.5f;
+		data.Parents[ix] = glm::translate(glm::vec3(dist(rng), dist(rng), dist(rng))) * glm::toMat4(glm::normalize(glm::quat(dist(rng), dist(rng), dist(rng), dist(rng))));
+		data.ParentPtrs[ix] = withParents ? &data.Parents[ix] : nullptr;
+		data.OutputPtrs[ix] = &data.Outputs[ix];
+	}
+	return data;
+}
+
+static void RunGlm(TestData& data)
+{
+	for (size_t ix = 0; ix < data.Outputs.size(); ix++) {
+		glm::mat4 local = glm::translate(data.Positions[ix]) *
+			glm::toMat4(glm::normalize(data.Rotations[ix])) *
+			glm::scale(data.Scales[ix]);
+		data.Outputs[ix] = data.ParentPtrs[ix] != nullptr ? *data.ParentPtrs[ix] * local : local;
+	}
+}
+
+static void RunKernel(TestData& data)
+{
+	TransformKernel::Compose(data.Positions.data(), data.Rotations.data(), data.Scales.data(),
+		data.ParentPtrs.data(), data.OutputPtrs.data(), data.Outputs.size());
+}
+
+// Runs a test RUNS times and returns the fastest time in milliseconds
+template <typename Func>
+static double Time(TestData& data, Func func)
+{
+	double best = 1e30;
+	for (int run = 0; run < RUNS; run++) {
+		Clock::time_point start = Clock::now();
+		func(data);
+		best = glm::min(best, Millis(start));
+	}
+	return best;
+}
+
+// Makes sure the kernel gives the same answer as glm, returning the largest difference between any two elements
+static float MaxError(TestData& data)
+{
+	RunGlm(data);
+	std::vector<glm::mat4> expected = data.Outputs;
+	RunKernel(data);
+
+	float error = 0.0f;
+	for (size_t ix = 0; ix < expected.size(); ix++) {
+		for (int col = 0; col < 4; col++) {
+			glm::vec4 diff = glm::abs(expected[ix][col] - data.Outputs[ix][col]);
+			error = glm::max(error, glm::max(glm::max(diff.x, diff.y), glm::max(diff.z, diff.w)));
+		}
+	}
+	return error;
+}
+
+int main()
+{
+	printf("TransformKernel path: %s\n\n", TransformKernel::GetPath());
+	printf("%10s %8s %12s %12s %9s %12s\n", "count", "parents", "glm (ms)", "kernel (ms)", "speedup", "max error");
+
+	const size_t counts[] = { 10000, 100000, 1000000 };
+	for (size_t count : counts) {
+		for (int withParents = 0; withParents < 2; withParents++) {
+			TestData data = MakeData(count, withParents != 0);
+			float error = MaxError(data);
+			double glmTime = Time(data, RunGlm);
+			double kernelTime = Time(data, RunKernel);
+			printf("%10zu %8s %12.3f %12.3f %8.2fx %12g\n", count, withParents ? "yes" : "no", glmTime, kernelTime, glmTime / kernelTime, error);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,41 @@
+// Bakes the game's models and textures ahead of time, the same as running GDW with "--bake" but without building the
+// game. Run it with the resource directory to bake as the first argument (projects/GDW/res from the repository root),
+// or from inside the resource directory with no arguments. The baked files are written next to their sources, so the
+// game's build copies them along with the rest of res. Exits with 1 if anything failed to bake
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+// Nothing here touches OpenGL, the baked meshes and textures are only written to disk
+#include "../../../../projects/GDW/src/Utils/AssetBaker.cpp"
+#include "../../../../projects/GDW/src/Utils/ObjLoader.cpp"
+#include "../../../../projects/GDW/src/Utils/BakedMesh.cpp"
+#include "../../../../projects/GDW/src/Utils/BakedTexture.cpp"
+#include "../../../../projects/GDW/src/Utils/BlockCompression.cpp"
+#include "../../../../projects/GDW/src/Utils/MappedFile.cpp"
+#include "../../../../projects/GDW/src/Utils/FileUtils.cpp"
+#include "../../../../projects/GDW/src/VertexArrayObject.cpp"
+#include "../../../../projects/GDW/src/IBuffer.cpp"
+#include "../../../../projects/GDW/src/VertexTypes.cpp"
+#include "../../../../projects/GDW/src/Bounds.cpp"
+
+int main(int argc, char** argv)
+{
+	Logger::Init();
+
+	std::string root = argc > 1 ? argv[1] : ".";
+	std::filesystem::path models = std::filesystem::path(root) / "Models";
+	std::filesystem::path textures = std::filesystem::path(root) / "Textures";
+	if (!std::filesystem::is_directory(models) || !std::filesystem::is_directory(textures)) {
+		LOG_WARN("\"{}\" doesn't look like a resource directory, it needs a Models and a Textures folder", root);
+		Logger::Uninitialize();
+		return 1;
+	}
+
+	int failures = AssetBaker::BakeModels(models.string()) + AssetBaker::BakeTextures(textures.string());
+	if (failures > 0) {
+		LOG_WARN("{} assets failed to bake", failures);
+	}
+	Logger::Uninitialize();
+	return failures == 0 ? 0 : 1;
+}